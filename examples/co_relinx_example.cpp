@@ -0,0 +1,268 @@
+/*
+MIT License
+
+Copyright (c) 2017 Arlen Keshabyan (arlen.albert@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "co_relinx.hpp"
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace nstd::co_relinx;
+using namespace std::literals;
+
+using order = std::pair<int, int>; // customer id, order number
+using joined = std::pair<int, int>; // customer id, order number or 0 when there is no match
+using grouped = std::pair<int, std::size_t>; // customer id, number of matching orders
+
+static const std::vector<int> customers { 1, 2, 2, 3, 5, 7 }; // sorted, with a duplicate key
+static const std::vector<order> orders { { 2, 20 }, { 2, 21 }, { 3, 30 }, { 4, 40 }, { 7, 70 }, { 7, 71 } }; // sorted, with duplicate keys
+
+static auto customer_key = [](int id) { return id; };
+static auto order_key = [](const order &o) { return o.first; };
+static auto join_result = [](int id, const order &o) { return joined { id, o.second }; };
+static auto group_result = [](int id, const auto &group) { return grouped { id, std::size(group) }; };
+
+static const std::vector<joined> inner_joined { { 2, 20 }, { 2, 21 }, { 2, 20 }, { 2, 21 }, { 3, 30 }, { 7, 70 }, { 7, 71 } };
+static const std::vector<joined> left_joined { { 1, 0 }, { 2, 20 }, { 2, 21 }, { 2, 20 }, { 2, 21 }, { 3, 30 }, { 5, 0 }, { 7, 70 }, { 7, 71 } };
+static const std::vector<grouped> inner_grouped { { 2, 2 }, { 2, 2 }, { 3, 1 }, { 7, 2 } };
+static const std::vector<grouped> left_grouped { { 1, 0 }, { 2, 2 }, { 2, 2 }, { 3, 1 }, { 5, 0 }, { 7, 2 } };
+
+TEST_CASE( "join(...)", "[co_relinx]" )
+{
+    // plain equality on hashable keys goes through the hash index of the joined sequence
+    CHECK(from(customers).join(orders, customer_key, order_key, join_result).to_vector() == inner_joined);
+    CHECK(from(customers).join(orders, customer_key, order_key, join_result, true).to_vector() == left_joined);
+    CHECK(from(customers).join(std::vector<order>(orders), customer_key, order_key, join_result, true).to_vector() == left_joined);
+
+    // any other comparer falls back to the nested scan and has to give the same result
+    auto equal = [](int l, int r) { return l == r; };
+
+    CHECK(from(customers).join(orders, customer_key, order_key, join_result, equal).to_vector() == inner_joined);
+    CHECK(from(customers).join(orders, customer_key, order_key, join_result, equal, true).to_vector() == left_joined);
+    CHECK(from(customers).join(std::vector<order>(orders), customer_key, order_key, join_result, equal, true).to_vector() == left_joined);
+}
+
+TEST_CASE( "join(...) on empty sequences", "[co_relinx]" )
+{
+    const std::vector<int> no_customers {};
+    const std::vector<order> no_orders {};
+    const std::vector<joined> unmatched { { 1, 0 }, { 2, 0 }, { 2, 0 }, { 3, 0 }, { 5, 0 }, { 7, 0 } };
+
+    CHECK(std::empty(from(no_customers).join(orders, customer_key, order_key, join_result).to_vector()));
+    CHECK(std::empty(from(no_customers).join(orders, customer_key, order_key, join_result, true).to_vector()));
+    CHECK(std::empty(from(customers).join(no_orders, customer_key, order_key, join_result).to_vector()));
+    CHECK(from(customers).join(no_orders, customer_key, order_key, join_result, true).to_vector() == unmatched);
+    CHECK(std::empty(from(no_customers).join(no_orders, customer_key, order_key, join_result, true).to_vector()));
+
+    CHECK(std::empty(from(customers).group_join(no_orders, customer_key, order_key, group_result).to_vector()));
+    CHECK(from(customers).group_join(no_orders, customer_key, order_key, group_result, true).to_vector().size() == std::size(customers));
+
+    CHECK(std::empty(from(no_customers).merge_join(orders, customer_key, order_key, join_result, true).to_vector()));
+    CHECK(std::empty(from(customers).merge_join(no_orders, customer_key, order_key, join_result).to_vector()));
+    CHECK(from(customers).merge_join(no_orders, customer_key, order_key, join_result, true).to_vector() == unmatched);
+    CHECK(std::empty(from(customers).merge_group_join(no_orders, customer_key, order_key, group_result).to_vector()));
+    CHECK(from(customers).merge_group_join(no_orders, customer_key, order_key, group_result, true).to_vector().size() == std::size(customers));
+}
+
+TEST_CASE( "group_join(...)", "[co_relinx]" )
+{
+    auto equal = [](int l, int r) { return l == r; };
+
+    CHECK(from(customers).group_join(orders, customer_key, order_key, group_result).to_vector() == inner_grouped);
+    CHECK(from(customers).group_join(orders, customer_key, order_key, group_result, true).to_vector() == left_grouped);
+    CHECK(from(customers).group_join(std::vector<order>(orders), customer_key, order_key, group_result, true).to_vector() == left_grouped);
+    CHECK(from(customers).group_join(orders, customer_key, order_key, group_result, equal).to_vector() == inner_grouped);
+    CHECK(from(customers).group_join(orders, customer_key, order_key, group_result, equal, true).to_vector() == left_grouped);
+
+    // the group handed to the result functor holds the matching elements in their original order
+    auto numbers = from(customers).group_join(orders, customer_key, order_key, [](int, const auto &group)
+    {
+        std::string result;
+
+        for (const auto &o : group) result += std::to_string(o.second) + " ";
+
+        return result;
+    }, true).to_vector();
+
+    CHECK(numbers == std::vector<std::string> { "", "20 21 ", "20 21 ", "30 ", "", "70 71 " });
+}
+
+TEST_CASE( "merge_join(...)", "[co_relinx]" )
+{
+    CHECK(from(customers).merge_join(orders, customer_key, order_key, join_result).to_vector() == inner_joined);
+    CHECK(from(customers).merge_join(orders, customer_key, order_key, join_result, true).to_vector() == left_joined);
+    CHECK(from(customers).merge_join(from(orders), customer_key, order_key, join_result, true).to_vector() == left_joined);
+
+    // the run of a key is reused by every repeated key on the left and dropped once the keys move past it
+    const std::vector<int> runs { 0, 0, 2, 2, 2, 4, 7, 7, 9 };
+    const std::vector<joined> expected { { 0, 0 }, { 0, 0 }, { 2, 20 }, { 2, 21 }, { 2, 20 }, { 2, 21 }, { 2, 20 }, { 2, 21 }, { 4, 40 },
+                                         { 7, 70 }, { 7, 71 }, { 7, 70 }, { 7, 71 }, { 9, 0 } };
+
+    CHECK(from(runs).merge_join(orders, customer_key, order_key, join_result, true).to_vector() == expected);
+    CHECK(from(runs).merge_join(orders, customer_key, order_key, join_result, true).to_vector() == from(runs).join(orders, customer_key, order_key, join_result, true).to_vector());
+    CHECK(from(runs).merge_join(orders, customer_key, order_key, join_result).to_vector().size() == 11);
+
+    // a custom order has to be passed along for sequences sorted otherwise
+    const std::vector<int> descending { 7, 7, 5, 3, 2, 1 };
+    const std::vector<order> orders_descending { { 7, 71 }, { 7, 70 }, { 4, 40 }, { 3, 30 }, { 2, 21 }, { 2, 20 } };
+    const std::vector<joined> expected_descending { { 7, 71 }, { 7, 70 }, { 7, 71 }, { 7, 70 }, { 5, 0 }, { 3, 30 }, { 2, 21 }, { 2, 20 }, { 1, 0 } };
+
+    CHECK(from(descending).merge_join(orders_descending, customer_key, order_key, join_result, true, std::greater<> {}).to_vector() == expected_descending);
+}
+
+TEST_CASE( "merge_group_join(...)", "[co_relinx]" )
+{
+    CHECK(from(customers).merge_group_join(orders, customer_key, order_key, group_result).to_vector() == inner_grouped);
+    CHECK(from(customers).merge_group_join(orders, customer_key, order_key, group_result, true).to_vector() == left_grouped);
+    CHECK(from(customers).merge_group_join(from(orders), customer_key, order_key, group_result, true).to_vector() == left_grouped);
+
+    const std::vector<int> runs { 0, 2, 2, 4, 7, 7, 9 };
+
+    CHECK(from(runs).merge_group_join(orders, customer_key, order_key, group_result, true).to_vector() == std::vector<grouped> { { 0, 0 }, { 2, 2 }, { 2, 2 }, { 4, 1 }, { 7, 2 }, { 7, 2 }, { 9, 0 } });
+    CHECK(from(runs).merge_group_join(orders, customer_key, order_key, group_result, true).to_vector() == from(runs).group_join(orders, customer_key, order_key, group_result, true).to_vector());
+}
+
+TEST_CASE( "frame_pool", "[co_relinx]" )
+{
+    using nstd::co_relinx::detail::frame_pool;
+
+    // a released frame is handed out again for any size of its class, the last released one first
+    auto frame { frame_pool::allocate(100) };
+
+    frame_pool::deallocate(frame, 100);
+
+    CHECK(frame_pool::allocate(128) == frame);
+
+    auto other { frame_pool::allocate(100) };
+    auto larger { frame_pool::allocate(200) };
+
+    CHECK(other != frame);
+    CHECK(larger != frame);
+
+    frame_pool::deallocate(frame, 100);
+    frame_pool::deallocate(other, 100);
+
+    CHECK(frame_pool::allocate(100) == other);
+    CHECK(frame_pool::allocate(100) == frame);
+
+    frame_pool::deallocate(frame, 100);
+    frame_pool::deallocate(other, 100);
+    frame_pool::deallocate(larger, 200);
+
+    // a frame released on another thread goes to that thread's cache, which frees it when the thread ends
+    auto foreign { frame_pool::allocate(100) };
+    auto recycled_there { false };
+
+    std::thread([foreign, &recycled_there]
+    {
+        frame_pool::deallocate(foreign, 100);
+
+        auto frame { frame_pool::allocate(100) };
+
+        recycled_there = frame == foreign;
+
+        frame_pool::deallocate(frame, 100);
+    }).join();
+
+    CHECK(recycled_there);
+}
+
+TEST_CASE( "frames of generators ended early", "[co_relinx]" )
+{
+    const std::vector<std::string> words { "first of the words, long enough to live on the heap", "second of the words, long enough to live on the heap",
+                                           "third of the words, long enough to live on the heap", "fourth of the words, long enough to live on the heap" };
+    auto shout = [](const std::string &w) { return w + "!"; };
+    auto has_o = [](const std::string &w) { return w.find('o') != std::string::npos; };
+
+    // every query stacks a frame per operator, stopping early destroys the suspended ones which then serve the next queries
+    for (int round { 0 }; round < 100; ++round)
+    {
+        CHECK(from(words).where(has_o).select(shout).take(1).to_vector() == std::vector<std::string> { words[0] + "!" });
+
+        {
+            auto query { from(words).select(shout).where(has_o) };
+            auto it { query.begin() };
+
+            CHECK(*it == words[0] + "!");
+            CHECK(*++it == words[1] + "!");
+        }
+
+        CHECK(from(words).select(shout).where(has_o).to_vector().size() == 4);
+        CHECK(from(std::vector<std::string>(words)).skip(2).take(1).to_vector() == std::vector<std::string> { words[2] });
+    }
+}
+
+TEST_CASE( "lifetime of yielded values", "[co_relinx]" )
+{
+    const std::vector<std::string> words { "first of the words, long enough to live on the heap", "second of the words, long enough to live on the heap",
+                                           "third of the words, long enough to live on the heap" };
+
+    // an lvalue is yielded by reference, no copy is made along the chain
+    auto source { co_from(words) };
+
+    REQUIRE(source.move_next());
+    CHECK(&source.current_value() == &words[0]);
+
+    auto filtered { co_filter(co_from(words), [](const std::string &w) { return w[0] == 's'; }) };
+
+    REQUIRE(filtered.move_next());
+    CHECK(&filtered.current_value() == &words[1]);
+    CHECK(!filtered.move_next());
+
+    CHECK(&*from(words).begin() == &words[0]);
+
+    // an rvalue container is owned by the frame, its elements stay valid until the generator is destroyed
+    auto owned { co_from(std::vector<std::string>(words)) };
+
+    REQUIRE(owned.move_next());
+
+    const auto &owned_first { owned.current_value() };
+
+    CHECK(owned_first == words[0]);
+    CHECK(&owned_first != &words[0]);
+
+    // a yielded temporary is moved into the promise and stays valid until the generator is resumed
+    auto shouted { co_transform(co_from(words), [](const std::string &w) { return w + "!"; }) };
+
+    REQUIRE(shouted.move_next());
+
+    const auto &first { shouted.current_value() };
+
+    CHECK(first == words[0] + "!");
+    CHECK(&shouted.current_value() == &first);
+
+    REQUIRE(shouted.move_next());
+    CHECK(shouted.current_value() == words[1] + "!");
+
+    auto numbers { co_range(0, 3) };
+    std::vector<int> seen;
+
+    while (numbers.move_next()) seen.push_back(numbers.current_value());
+
+    CHECK(seen == std::vector<int> { 0, 1, 2 });
+}
@@ -18,8 +18,16 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <atomic>
+#include <cmath>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 #include "expiry_cache.hpp"
 
 using namespace std::string_literals;
@@ -30,6 +38,155 @@ struct Item
 	~Item() { std::cout << "Item deleted..." << std::endl; }
 };
 
+template<typename cache_type>
+static void lookup_benchmark(const char *name, cache_type &cache, size_t entries, size_t threads, size_t lookups_per_thread)
+{
+    using namespace std::chrono;
+
+    for (size_t idx { 0 }; idx < entries; ++idx) cache.put(idx, idx, 10min);
+
+    std::vector<std::thread> readers;
+    std::atomic<size_t> hits { 0 };
+    auto start { steady_clock::now() };
+
+    for (size_t t { 0 }; t < threads; ++t)
+        readers.emplace_back([&cache, &hits, t, entries, lookups_per_thread]
+        {
+            size_t value {}, local_hits { 0 };
+
+            for (size_t idx { 0 }; idx < lookups_per_thread; ++idx) local_hits += cache.get((idx * 7919 + t) % entries, value);
+
+            hits += local_hits;
+        });
+
+    for (auto &reader : readers) reader.join();
+
+    auto lookups_per_second { static_cast<double>(threads * lookups_per_thread) / duration<double>(steady_clock::now() - start).count() };
+
+    start = steady_clock::now();
+    cache.vacuum();
+
+    auto vacuum_us { duration_cast<microseconds>(steady_clock::now() - start).count() };
+
+    std::cout << name << ": " << static_cast<size_t>(lookups_per_second) << " lookups/s with " << threads << " threads; "
+              << "vacuum() with nothing due took " << vacuum_us << "us over " << cache.size() << " entries" << std::endl;
+}
+
+static void eviction_policies(size_t capacity)
+{
+    auto policy_name = [](nstd::eviction_policy policy)
+    {
+        switch (policy)
+        {
+            case nstd::eviction_policy::lru: return "lru          ";
+            case nstd::eviction_policy::segmented_lru: return "segmented_lru";
+            default: return "tiny_lfu     ";
+        }
+    };
+
+    auto run = [capacity](nstd::eviction_policy policy, auto &&next_key)
+    {
+        nstd::expiry_cache<size_t, size_t> cache;
+
+        cache.set_eviction_policy(policy);
+        cache.set_capacity(capacity);
+
+        for (size_t idx { 0 }; idx < capacity * 300; ++idx)
+        {
+            size_t key { next_key(idx) }, value {};
+
+            if (!cache.get(key, value)) cache.put(key, key);
+        }
+
+        return cache.statistics();
+    };
+
+    for (auto policy : { nstd::eviction_policy::lru, nstd::eviction_policy::segmented_lru, nstd::eviction_policy::tiny_lfu })
+    {
+        std::mt19937_64 rng { 7 };
+        std::uniform_real_distribution<double> exponent { 0.0, 1.0 };
+
+        // a skewed popularity distribution with every tenth request being a one-hit scan key
+        auto skewed { run(policy, [&](size_t idx) { return idx % 10 ? static_cast<size_t>(std::pow(100.0 * capacity, exponent(rng))) : ~idx; }) };
+        // a loop slightly larger than the cache, the worst case for recency
+        auto looping { run(policy, [capacity](size_t idx) { return idx % (capacity + capacity / 2); }) };
+
+        std::cout << policy_name(policy) << ": skewed hit ratio " << skewed.hit_ratio() << ", looping hit ratio " << looping.hit_ratio()
+                  << "; evictions " << skewed.evictions << " / " << looping.evictions << std::endl;
+    }
+}
+
+static void read_through(size_t threads)
+{
+    using namespace std::chrono_literals;
+
+    // declared before the cache: a refresh still running when the cache is destroyed uses it
+    std::atomic<size_t> backend_calls { 0 };
+    nstd::expiry_cache<std::string, std::string> cache { 300ms };
+
+    auto backend = [&backend_calls](const std::string &key) -> std::optional<std::string>
+    {
+        ++backend_calls;
+        std::this_thread::sleep_for(20ms);
+
+        if (key == "missing") return std::nullopt;
+
+        return key + " value";
+    };
+
+    cache.set_negative_expiry(1s);
+    cache.set_refresh_ahead(100ms);
+
+    // refreshes keep the expiry an entry was put with
+    cache.put("custom", "custom value", 250ms);
+
+    // a herd of readers hitting two hot keys for a second, plus a key the backend doesn't have
+    std::vector<std::thread> readers;
+
+    for (size_t idx { 0 }; idx < threads; ++idx) readers.emplace_back([&cache, &backend]
+    {
+        for (auto deadline { std::chrono::steady_clock::now() + 1s }; std::chrono::steady_clock::now() < deadline; std::this_thread::sleep_for(1ms))
+        {
+            cache.get_or_load("hot", backend);
+            cache.get_or_load("custom", backend);
+            cache.get_or_load("missing", backend);
+        }
+    });
+
+    for (auto &reader : readers) reader.join();
+
+    auto stats { cache.statistics() };
+
+    std::cout << "read-through with " << threads << " readers: " << stats.hits + stats.misses + stats.negative_hits << " lookups ("
+              << stats.negative_hits << " answered by the negative cache), " << backend_calls << " backend calls (" << stats.refreshes
+              << " refreshes ahead of expiry, " << stats.expirations << " expirations), average load "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(stats.average_load_time()).count() << " ms; 'custom' still expires after "
+              << cache.get_expiry("custom").count() << " ms" << std::endl;
+}
+
+// the last owner lets go of the cache on the only pool thread while a refresh is still queued behind it
+static void released_on_pool_thread()
+{
+    using namespace std::chrono_literals;
+
+    nstd::thread_pool pool { 1 };
+    auto cache { std::make_shared<nstd::expiry_cache<int, int>>(100ms) };
+    std::promise<void> gate, released;
+
+    // a lead time longer than the expiry makes the very next hit refresh the entry
+    cache->set_refresh_ahead(200ms, pool);
+    cache->put(1, 1);
+
+    pool.post([opened = gate.get_future(), &released, owner = cache]() mutable { opened.wait(); owner.reset(); released.set_value(); });
+
+    cache->get_or_load(1, [](const int &key) { return key + 1; });
+    cache.reset();
+
+    gate.set_value();
+
+    std::cout << "cache released on its refresh pool thread: " << (released.get_future().wait_for(5s) == std::future_status::ready ? "ok" : "DEADLOCK") << std::endl;
+}
+
 int main()
 {
 	using namespace std::chrono_literals;
@@ -66,5 +223,15 @@ int main()
 
 	std::cout << "Container size: " << a.size() << std::endl;
 
+    nstd::expiry_cache<size_t, size_t> single_lock;
+    nstd::sharded_expiry_cache<size_t, size_t> sharded;
+
+    lookup_benchmark("expiry_cache        ", single_lock, 1'000'000, 4, 1'000'000);
+    lookup_benchmark("sharded_expiry_cache", sharded, 1'000'000, 4, 1'000'000);
+
+    eviction_policies(1000);
+    read_through(16);
+    released_on_pool_thread();
+
     return 0;
 }
@@ -182,6 +182,19 @@ solution "nstd_examples"
             configuration "gcc"
                 buildoptions { "-Wno-unused-variable", "-Wno-unused-but-set-variable" }
 
+        configuration "linux or macosx or bsd"
+            links { "pthread" }
+
+    project "co_relinx_example"
+        files { "co_relinx_example.cpp" }
+        configuration { "Debug" }
+            objdir "obj/co_relinx_example/Debug"
+            targetdir "bin/co_relinx_example/Debug"
+
+        configuration { "Release" }
+            objdir "obj/co_relinx_example/Release"
+            targetdir "bin/co_relinx_example/Release"
+
     --[[project "relinx_generator_example"
         files { "relinx_generator_example.cpp" }
         userincludedirs { "../include/external/asio/asio/include" }
@@ -226,6 +239,19 @@ solution "nstd_examples"
             objdir "obj/strings_example/Release"
             targetdir "bin/strings_example/Release"
 
+    project "thread_pool_example"
+        files { "thread_pool_example.cpp" }
+        configuration { "Debug" }
+            objdir "obj/thread_pool_example/Debug"
+            targetdir "bin/thread_pool_example/Debug"
+
+        configuration { "Release" }
+            objdir "obj/thread_pool_example/Release"
+            targetdir "bin/thread_pool_example/Release"
+
+        configuration "linux or macosx or bsd"
+            links { "pthread" }
+
     project "topological_sorter_example"
         files { "topological_sorter_example.cpp" }
         configuration { "Debug" }
@@ -236,6 +262,19 @@ solution "nstd_examples"
             objdir "obj/topological_sorter_example/Release"
             targetdir "bin/topological_sorter_example/Release"
 
+    project "signal_slot_example"
+        files { "signal_slot_example.cpp" }
+        configuration { "Debug" }
+            objdir "obj/signal_slot_example/Debug"
+            targetdir "bin/signal_slot_example/Debug"
+
+        configuration { "Release" }
+            objdir "obj/signal_slot_example/Release"
+            targetdir "bin/signal_slot_example/Release"
+
+        configuration "linux or macosx or bsd"
+            links { "pthread" }
+
     project "sqlite_example"
         files { "sqlite_example.cpp", "../include/external/sqlite/sqlite3.c" }
         includedirs { "../include/external/sqlite", "../include/external/json/include" }
@@ -392,6 +431,22 @@ solution "nstd_examples"
         configuration "linux or macosx or bsd"
             links { "pthread" }
 
+    project "sharp_tcp_benchmark_example"
+        files { "sharp_tcp_benchmark_example.cpp" }
+        configuration { "Debug" }
+            objdir "obj/sharp_tcp_benchmark_example/Debug"
+            targetdir "bin/sharp_tcp_benchmark_example/Debug"
+
+        configuration { "Release" }
+            objdir "obj/sharp_tcp_benchmark_example/Release"
+            targetdir "bin/sharp_tcp_benchmark_example/Release"
+
+        configuration { "windows" }
+            links { "ws2_32" }
+
+        configuration "linux or macosx or bsd"
+            links { "pthread" }
+
     project "remote_signal_slot_example"
         files { "remote_signal_slot_example.cpp" }
         includedirs { "../include/external/json/include" }
@@ -23,13 +23,19 @@ SOFTWARE.
 */
 
 #include "relinx.hpp"
+#include "relinx_parallel.hpp"
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <forward_list>
 #include <iostream>
 #include <deque>
+#include <latch>
 #include <map>
+#include <memory_resource>
+#include <random>
 #include <set>
 
 #define CATCH_CONFIG_MAIN
@@ -346,6 +352,9 @@ TEST_CASE( "element_at_or_default(idx, dv)", "[relinx]" )
 TEST_CASE( "except(c)", "[relinx]" )
 {
     CHECK(from({0, 1, 2, 3, 4, 5, 6, 7, 8})->except({2, 3, 4, 5})->to_string() == "01678");
+    CHECK(from({0, 1, 1, 2, 8, 3, 0, 8})->except({2, 3, 4, 5})->to_string() == "018");
+    CHECK(from({0, 1, 1, 2, 8, 3, 0, 8})->except({2, 3, 4, 5}, [](auto &&a, auto &&b) { return a == b; })->to_string() == "018");
+    CHECK(from(std::vector<int>())->except({2, 3})->count() == 0);
 }
 
 TEST_CASE( "first(f)", "[relinx]" )
@@ -521,6 +530,39 @@ TEST_CASE( "group_by(f)", "[relinx]" )
     CHECK(t2_res->single([](auto &&i){ return i.first == (std::hash<std::string>()("Doe"s) ^ (std::hash<std::string>()("Sam"s) << 1)); }).second.size() == 2);
 }
 
+TEST_CASE( "group_by(f) with aggregates", "[relinx]" )
+{
+    std::vector<Customer> t1_data =
+    {
+        Customer{0, "John"s, "Doe"s, 25},
+        Customer{1, "Sam"s, "Doe"s, 35},
+        Customer{2, "John"s, "Doe"s, 25},
+        Customer{3, "Alex"s, "Poo"s, 23},
+        Customer{4, "Sam"s, "Doe"s, 45},
+        Customer{5, "Anna"s, "Poo"s, 24}
+    };
+
+    auto age = [](auto &&i) { return i.Age; };
+    auto t1_res = from(t1_data)->group_by([](auto &&i) { return i.LastName; }, group::count(), group::sum(age), group::min(age), group::max(age), group::avarage(age))->to_vector();
+
+    REQUIRE(t1_res.size() == 2);
+    CHECK(t1_res[0] == std::make_tuple("Doe"s, 4u, 130u, 25u, 45u, 32u));
+    CHECK(t1_res[1] == std::make_tuple("Poo"s, 2u, 47u, 23u, 24u, 23u));
+
+    auto t2_res = from({1, 2, 3, 4, 5})->group_by([](auto &&v) { return v % 2; }, group::count(), group::sum())->to_vector();
+
+    CHECK(t2_res == std::vector<std::tuple<int, std::size_t, int>> { { 1, 3, 9 }, { 0, 2, 6 } });
+    CHECK(from(std::vector<double> { 1.0, 2.0, 4.0 })->group_by([](auto &&) { return 0; }, group::avarage())->first() == std::make_tuple(0, 7.0 / 3.0));
+    CHECK(from(std::vector<int>())->group_by([](auto &&v) { return v; }, group::count())->count() == 0);
+
+    auto t3_res = from(t1_data)->group_by([](auto &&i) { return i.FirstName; }, group::sum(age));
+
+    for (auto &&[key, total] : *t3_res)
+    {
+        CHECK(total == from(t1_data)->where([&key](auto &&i) { return i.FirstName == key; })->sum(age));
+    }
+}
+
 TEST_CASE( "group_join(f)", "[relinx]" )
 {
     std::vector<Customer> t1_data =
@@ -576,6 +618,15 @@ TEST_CASE( "group_join(f)", "[relinx]" )
 
     CHECK(t2_res.size() == 6);
     CHECK(t2_res[1].second == std::string()); CHECK(t2_res[3].second == std::string()); CHECK(t2_res[5].second == std::string());
+
+    for (auto leftJoin : { false, true })
+    {
+        auto names = [](auto &&key, auto &&values) { return key.FirstName + ":" + from(values)->select([](auto &&i) { return i.NickName; })->to_string(","s); };
+        auto hashed = from(t1_data)->group_join(t2_data, [](auto &&i) { return i.Id; }, [](auto &&i) { return i.OwnerId; }, names, leftJoin)->to_vector();
+        auto scanned = from(t1_data)->group_join(t2_data, [](auto &&i) { return i.Id; }, [](auto &&i) { return i.OwnerId; }, names, [](auto &&a, auto &&b) { return a == b; }, leftJoin)->to_vector();
+
+        CHECK(hashed == scanned);
+    }
 }
 
 TEST_CASE( "intersect_with(v)", "[relinx]" )
@@ -583,6 +634,8 @@ TEST_CASE( "intersect_with(v)", "[relinx]" )
     auto t1_res = from({1, 2, 3, 7, 8})->intersect_with({2, 3, 5, 6, 7})->to_string();
 
     CHECK(t1_res == "237"s);
+    CHECK(from({7, 1, 2, 2, 3, 7, 8})->intersect_with({2, 3, 5, 6, 7})->to_string() == "723"s);
+    CHECK(from({7, 1, 2, 2, 3, 7, 8})->intersect_with({2, 3, 5, 6, 7}, [](auto &&a, auto &&b) { return a == b; })->to_string() == "723"s);
 }
 
 TEST_CASE( "then_by(f)", "[relinx]" )
@@ -631,6 +684,45 @@ TEST_CASE( "then_by_descending(f)", "[relinx]" )
     CHECK(t1_res[5].FirstName == "Alex"s);
 }
 
+TEST_CASE( "order_by(f)->take(n)", "[relinx]" )
+{
+    std::vector<Customer> t1_data =
+    {
+        Customer{0, "John"s, "Doe"s, 25},
+        Customer{1, "Sam"s, "Doe"s, 35},
+        Customer{2, "John"s, "Doe"s, 25},
+        Customer{3, "Alex"s, "Poo"s, 25},
+        Customer{4, "Sam"s, "Doe"s, 45},
+        Customer{5, "Anna"s, "Poo"s, 23}
+    };
+
+    auto t1_res = from(t1_data)->order_by([](auto &&v) { return v.Age; })->then_by([](auto &&v) { return v.FirstName; })->take(3)->to_vector();
+
+    REQUIRE(t1_res.size() == 3);
+    CHECK(t1_res[0].Id == 5);
+    CHECK(t1_res[1].Id == 3);
+    CHECK(t1_res[2].Id == 0);
+
+    auto t2_res = from(t1_data)->order_by([](auto &&v) { return v.Age; })->take(4)->select([](auto &&v) { return v.Id; })->to_string();
+
+    CHECK(t2_res == "5023"s);
+
+    auto key_calls = 0;
+    auto t3_ordered = from({5, 3, 9, 1, 7, 3, 8, 2})->order_by([&key_calls](auto &&v) { ++key_calls; return v; });
+
+    CHECK(key_calls == 0);
+    CHECK(t3_ordered->take(3)->to_string() == "123"s);
+    CHECK(key_calls == 8);
+    CHECK(t3_ordered->take(0)->count() == 0);
+    CHECK(t3_ordered->take(100)->to_string() == "12335789"s);
+    CHECK(t3_ordered->to_string() == "12335789"s);
+    CHECK(key_calls == 24);
+    CHECK(t3_ordered->take(2)->to_string() == "12"s);
+    CHECK(t3_ordered->take(-1)->to_string() == "12335789"s);
+    CHECK(key_calls == 24);
+    CHECK(from({3, 1, 2})->order_by_descending()->take(2)->to_string() == "32"s);
+}
+
 TEST_CASE( "join(f)", "[relinx]" )
 {
     std::vector<Customer> t1_data =
@@ -683,6 +775,25 @@ TEST_CASE( "join(f)", "[relinx]" )
 
     CHECK(t2_res.size() == 9);
     CHECK(t2_res[3].second == std::string()); CHECK(t2_res[4].second == std::string()); CHECK(t2_res[7].second == std::string());
+
+    // a custom comparer takes the nested scan path, it has to produce the same sequence as the hash index
+    for (auto leftJoin : { false, true })
+    {
+        auto hashed = from(t1_data)->join(t2_data, [](auto &&i) { return i.Id; }, [](auto &&i) { return i.OwnerId; }, [](auto &&left, auto &&right) { return left.FirstName + right.NickName; }, leftJoin)->to_vector();
+        auto scanned = from(t1_data)->join(t2_data, [](auto &&i) { return i.Id; }, [](auto &&i) { return i.OwnerId; }, [](auto &&left, auto &&right) { return left.FirstName + right.NickName; }, [](auto &&a, auto &&b) { return a == b; }, leftJoin)->to_vector();
+
+        CHECK(hashed == scanned);
+    }
+
+    // an inner join with an empty container does not pull the current sequence, a left join still walks it
+    std::vector<Pet> no_pets {};
+    std::size_t pulled { 0 };
+    auto counted = [&pulled](auto &&i) { ++pulled; return i.Id; };
+
+    CHECK(from(t1_data)->select([&pulled](auto &&i) { ++pulled; return i; })->join(no_pets, [](auto &&i) { return i.Id; }, [](auto &&i) { return i.OwnerId; }, [](auto &&left, auto &&) { return left.Id; })->count() == 0);
+    CHECK(pulled == 0);
+    CHECK(from(t1_data)->join(no_pets, counted, [](auto &&i) { return i.OwnerId; }, [](auto &&left, auto &&) { return left.Id; }, true)->count() == 6);
+    CHECK(pulled == 6);
 }
 
 TEST_CASE( "last(f)", "[relinx]" )
@@ -860,6 +971,96 @@ TEST_CASE( "of_type<variant>()", "[relinx]" )
     CHECK(t1_res->count() == 2);
 }
 
+TEST_CASE( "parallel(pool)", "[relinx]" )
+{
+    nstd::thread_pool pool { 3 };
+    std::vector<int> t1_data(10'000);
+
+    std::iota(std::begin(t1_data), std::end(t1_data), -5'000);
+
+    auto odd = [](auto &&v) { return v % 2 != 0; };
+    auto square = [](auto &&v) { return static_cast<int64_t>(v) * v; };
+
+    // a small grain size makes sure many chunks take part and get merged
+    CHECK(from(t1_data)->parallel(pool, 64)->where(odd)->select(square)->sum() == from(t1_data)->where(odd)->select(square)->sum());
+    CHECK(from(t1_data)->parallel(pool, 64)->where(odd)->select(square)->to_vector() == from(t1_data)->where(odd)->select(square)->to_vector());
+    CHECK(from(t1_data)->parallel(pool, 64)->select_many([](auto &&v) { return std::vector<int> { v, v }; })->count() == 20'000);
+    CHECK(from(t1_data)->parallel(pool, 64)->count(odd) == 5'000);
+    CHECK(from(t1_data)->parallel(pool, 64)->min() == -5'000); CHECK(from(t1_data)->parallel(pool, 64)->max() == 4'999);
+    CHECK(from(t1_data)->parallel(pool, 64)->any([](auto &&v) { return v == 4'000; }));
+    CHECK(!from(t1_data)->parallel(pool, 64)->all(odd));
+    CHECK(from(t1_data)->parallel(pool, 64)->aggregate(""s, [](auto &&s, auto &&v) { return v % 1'000 == 0 ? s + std::to_string(v / 1'000) : s; }, std::plus<> {}) == "-5-4-3-2-101234"s);
+    CHECK(from(t1_data)->parallel(pool, 64)->to_map([](auto &&v) { return v % 10; }) == from(t1_data)->to_map([](auto &&v) { return v % 10; }));
+    CHECK_THROWS_AS(from(std::vector<int>())->parallel(pool)->max(), no_elements);
+    CHECK(from(std::vector<int>())->parallel(pool)->sum() == 0);
+
+    // a non random access sequence is collected first
+    CHECK(from(std::list<int>(std::begin(t1_data), std::end(t1_data)))->where(odd)->parallel(pool, 64)->sum() == from(t1_data)->where(odd)->sum());
+
+    auto ordered = from(t1_data)->parallel(pool, 64)->order_by([](auto &&v) { return std::abs(v) % 100; })->then_by_descending()->to_vector();
+    auto expected = from(t1_data)->order_by([](auto &&v) { return std::abs(v) % 100; })->then_by_descending()->to_vector();
+
+    CHECK(ordered == expected);
+}
+
+TEST_CASE( "parallel(pool) nested in a destroyed pool", "[relinx]" )
+{
+    std::vector<int> t1_data(2'000);
+    std::atomic<int64_t> sum { -1 }, ordered_size { -1 };
+
+    std::iota(std::begin(t1_data), std::end(t1_data), 0);
+
+    // the chunks the destroyed pool drops are left to the calling worker, which still gets the full result
+    {
+        nstd::thread_pool pool { 2 };
+        std::latch started { 1 };
+
+        pool.post([&]
+        {
+            started.count_down();
+
+            sum = from(t1_data)->parallel(pool, 1)->select([](auto &&v) { std::this_thread::sleep_for(50us); return static_cast<int64_t>(v); })->sum();
+            ordered_size = static_cast<int64_t>(std::size(from(t1_data)->parallel(pool, 1)->order_by_descending()->to_vector()));
+        });
+
+        started.wait();
+    }
+
+    CHECK(sum == 1'999'000);
+    CHECK(ordered_size == 2'000);
+}
+
+TEST_CASE( "pipe(...)", "[relinx]" )
+{
+    std::vector<int> t1_data { 5, 1, 8, 3, 8, 2, 9, 4, 1, 7 };
+    auto odd = [](auto &&v) { return v % 2 != 0; };
+    auto square = [](auto &&v) { return v * v; };
+
+    CHECK((t1_data | pipe::where(odd) | pipe::select(square) | pipe::to_vector()) == from(t1_data)->where(odd)->select(square)->to_vector());
+    CHECK((t1_data | pipe::skip(2) | pipe::take(5) | pipe::to_string(","s)) == from(t1_data)->skip(2)->take(5)->to_string(","s));
+    CHECK((t1_data | pipe::skip_while([](auto &&v) { return v != 3; }) | pipe::take_while([](auto &&v) { return v != 9; }) | pipe::to_string()) == "382"s);
+    CHECK((t1_data | pipe::distinct() | pipe::count()) == 8);
+    CHECK((t1_data | pipe::distinct([](auto &&v) { return v % 3; }) | pipe::to_string()) == "513"s);
+    CHECK((t1_data | pipe::take(0) | pipe::any()) == false);
+    CHECK((t1_data | pipe::any([](auto &&v) { return v > 8; })) == true);
+    CHECK((t1_data | pipe::all(odd)) == false);
+    CHECK((t1_data | pipe::take_while(odd) | pipe::all(odd)) == true);
+    CHECK((t1_data | pipe::sum()) == from(t1_data)->sum());
+    CHECK((t1_data | pipe::min()) == 1); CHECK((t1_data | pipe::max()) == 9);
+    CHECK((t1_data | pipe::where([](auto &&v) { return v > 7; }) | pipe::first()) == 8);
+    CHECK_THROWS_AS(std::vector<int>() | pipe::first(), no_elements);
+    CHECK((pipe::from({1, 2, 3}) | pipe::aggregate(10, [](auto &&a, auto &&v) { return a + v; })) == 16);
+    CHECK((pipe::from({"ab"s, "cd"s}) | pipe::select_many([](auto &&s) { return s; }) | pipe::to_string("-"s)) == "a-b-c-d"s);
+
+    // a pipeline is a value, running it twice starts from the source again with fresh stage state
+    auto query = t1_data | pipe::where(odd) | pipe::take(2);
+    int tee_count = 0;
+
+    CHECK((query | pipe::tee([&tee_count](auto &&) { ++tee_count; }) | pipe::to_string()) == "51"s);
+    CHECK((query | pipe::to_string()) == "51"s);
+    CHECK(tee_count == 2);
+}
+
 TEST_CASE( "reverse()", "[relinx]" )
 {
     CHECK(from({1, 2, 3})->reverse()->to_string() == "321"s);
@@ -1231,3 +1432,301 @@ TEST_CASE( "zip(c, f)", "[relinx]" )
     CHECK(t1_res[1] == "2 two"s);
     CHECK(t1_res[2] == "3 three"s);
 }
+
+TEST_CASE( "memory_resource_scope", "[relinx]" )
+{
+    struct counting_resource : public std::pmr::memory_resource
+    {
+        std::size_t allocations { 0 };
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override { ++allocations; return std::pmr::new_delete_resource()->allocate(bytes, alignment); }
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override { std::pmr::new_delete_resource()->deallocate(p, bytes, alignment); }
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+
+    std::forward_list<int> t1_data { 5, 3, 9, 1, 7, 3, 8, 2 };
+    counting_resource counter;
+
+    {
+        memory_resource_scope scope { &counter };
+
+        CHECK(memory_resource() == &counter);
+        CHECK(from(t1_data)->distinct()->reverse()->to_string() == "2871935"s);
+        CHECK(from(t1_data)->order_by()->take(3)->to_string() == "123"s);
+        CHECK(from(t1_data)->group_by([](auto &&v) { return v % 2; })->count() == 2);
+    }
+
+    CHECK(counter.allocations > 0);
+    CHECK(memory_resource() == std::pmr::get_default_resource());
+
+    // an arena without an upstream proves that every intermediate container allocated from it
+    std::array<std::byte, 64 * 1024> buffer;
+    std::pmr::monotonic_buffer_resource arena { buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+    std::vector<int> t2_res;
+
+    {
+        memory_resource_scope scope { &arena };
+
+        t2_res = from(t1_data)->order_by_descending()->then_by()->where([](auto &&v) { return v > 2; })->reverse()->to_vector();
+    }
+
+    CHECK(t2_res == std::vector<int> { 3, 3, 5, 7, 8, 9 });
+}
+
+TEST_CASE( "contiguous aggregates", "[relinx]" )
+{
+    auto check = [](auto &&t1_data)
+    {
+        using value_type = typename std::decay_t<decltype(t1_data)>::value_type;
+
+        std::list<value_type> t1_list(std::begin(t1_data), std::end(t1_data));
+        auto even = [](auto &&v) { return static_cast<long long>(v) % 2 == 0; };
+        auto contiguous = from(t1_data);
+        auto linked = from(t1_list);
+
+        CHECK(contiguous->sum() == linked->sum());
+        CHECK(contiguous->min() == linked->min());
+        CHECK(contiguous->max() == linked->max());
+        CHECK(contiguous->avarage() == linked->avarage());
+        CHECK(contiguous->count(value_type { t1_data[3] }) == linked->count(value_type { t1_data[3] }));
+        CHECK(contiguous->count(even) == linked->count(even));
+        CHECK(contiguous->contains(value_type { t1_data.back() }));
+        CHECK(!contiguous->contains([](auto &&v) { return v == 1'000; }));
+        CHECK(from(t1_data.data(), t1_data.size())->sum() == linked->sum());
+    };
+
+    // odd sizes leave a scalar tail behind the vector loop
+    for (auto size : { 5, 8, 37, 1'000 })
+    {
+        std::vector<int> t1_data(size);
+        std::mt19937 generator { 42 };
+
+        for (auto &&v : t1_data) v = static_cast<int>(generator() % 1'000) - 500;
+
+        check(t1_data);
+        check(std::vector<unsigned> (std::begin(t1_data), std::end(t1_data)));
+        check(std::vector<int64_t> (std::begin(t1_data), std::end(t1_data)));
+        check(std::vector<uint64_t> (std::begin(t1_data), std::end(t1_data)));
+        check(std::vector<int16_t> (std::begin(t1_data), std::end(t1_data)));
+        check(std::vector<double> (std::begin(t1_data), std::end(t1_data)));
+        check(std::vector<float> (std::begin(t1_data), std::end(t1_data)));
+    }
+
+    CHECK(range(1, 100)->sum() == 5'050);
+    CHECK(range(1, 100)->min() == 1);
+    CHECK(range(1, 100)->max() == 100);
+    CHECK(from(std::vector<double> { 0.5, 1.5, 2.5, 3.5, 4.5 })->avarage() == 2.5);
+    CHECK(from(std::vector<double>())->sum() == 0.0);
+    CHECK_THROWS_AS(from(std::vector<double>())->min(), no_elements);
+}
+
+// runs the functor once, returns its result along with the elapsed time counted in Duration
+template<typename Duration = std::chrono::milliseconds, typename Functor>
+static auto measure(Functor &&functor)
+{
+    auto start = hr_clock::now();
+    auto result = functor();
+
+    return std::make_pair(result, std::chrono::duration_cast<Duration>(hr_clock::now() - start).count());
+}
+
+TEST_CASE( "join benchmark", "[.benchmark]" )
+{
+    // the nested scan quadruples its time with each doubling of both sides, the hash index stays roughly linear
+    for (uint32_t size : { 5'000u, 10'000u, 20'000u, 200'000u })
+    {
+        std::vector<Customer> customers(size);
+        std::vector<Pet> pets(size);
+
+        for (uint32_t idx = 0; idx < size; ++idx)
+        {
+            customers[idx].Id = idx;
+            pets[idx].OwnerId = (idx * 7) % (size * 2);
+        }
+
+        auto key = [](auto &&i) { return i.Id; };
+        auto owner = [](auto &&i) { return i.OwnerId; };
+        auto pair = [](auto &&left, auto &&right) { return left.Id + right.OwnerId; };
+
+        auto [hashed, hashed_ms] = measure([&] { return from(customers)->join(pets, key, owner, pair)->count(); });
+        auto [except, except_ms] = measure([&] { return from(customers)->select(key)->except(from(pets)->select(owner)->to_vector())->count(); });
+
+        std::cout << size << " x " << size << ": hash join " << hashed << " rows in " << hashed_ms << " ms, hash except " << except << " rows in " << except_ms << " ms";
+
+        if (size <= 20'000u)
+        {
+            auto [scanned, scanned_ms] = measure([&] { return from(customers)->join(pets, key, owner, pair, [](auto &&a, auto &&b) { return a == b; })->count(); });
+
+            CHECK(scanned == hashed);
+
+            std::cout << ", nested join " << scanned_ms << " ms";
+        }
+
+        std::cout << std::endl;
+    }
+}
+
+TEST_CASE( "pipe benchmark", "[.benchmark]" )
+{
+    std::vector<uint64_t> t1_data(5'000'000);
+
+    std::iota(std::begin(t1_data), std::end(t1_data), 0);
+
+    auto odd = [](auto &&v) { return v % 2 != 0; };
+    auto square = [](auto &&v) { return v * v; };
+    auto small = [](auto &&v) { return v % 3 != 0; };
+    auto half = [](auto &&v) { return v / 2; };
+    auto below = [](auto &&v) { return v < 9'000'000'000'000ull; };
+
+    // the same six stages through shared relinx_objects, through a fused pipeline and through a hand written loop
+    auto [chained, chained_ns] = measure<std::chrono::duration<double, std::nano>>([&] { return from(t1_data)->where(odd)->select(square)->where(small)->select(half)->take_while(below)->sum(); });
+    auto [piped, piped_ns] = measure<std::chrono::duration<double, std::nano>>([&] { return t1_data | pipe::where(odd) | pipe::select(square) | pipe::where(small) | pipe::select(half) | pipe::take_while(below) | pipe::sum(); });
+    auto [looped, looped_ns] = measure<std::chrono::duration<double, std::nano>>([&]
+    {
+        uint64_t result {};
+
+        for (auto v : t1_data) { if (!odd(v)) continue; v = square(v); if (!small(v)) continue; v = half(v); if (!below(v)) break; result += v; }
+
+        return result;
+    });
+
+    CHECK(chained == looped);
+    CHECK(piped == looped);
+
+    std::cout << "per element: relinx_object " << chained_ns / std::size(t1_data) << " ns, pipe " << piped_ns / std::size(t1_data) << " ns, hand written loop " << looped_ns / std::size(t1_data) << " ns" << std::endl;
+}
+
+TEST_CASE( "parallel benchmark", "[.benchmark]" )
+{
+    std::vector<uint64_t> t1_data(50'000'000);
+
+    std::iota(std::begin(t1_data), std::end(t1_data), 0);
+
+    auto odd = [](auto &&v) { return v % 2 != 0; };
+    auto square = [](auto &&v) { return v * v; };
+    auto &pool = nstd::global_thread_pool::get_thread_pool();
+
+    auto [sequential, sequential_ms] = measure([&] { return from(t1_data)->where(odd)->select(square)->sum(); });
+    auto [parallel, parallel_ms] = measure([&] { return from(t1_data)->parallel(pool)->where(odd)->select(square)->sum(); });
+
+    CHECK(parallel == sequential);
+
+    std::cout << std::size(t1_data) << " items on " << pool.size() + 1 << " threads: where/select/sum " << sequential_ms << " ms sequential, " << parallel_ms << " ms parallel" << std::endl;
+}
+
+TEST_CASE( "order_by take benchmark", "[.benchmark]" )
+{
+    std::vector<uint64_t> t1_data(5'000'000);
+
+    std::iota(std::begin(t1_data), std::end(t1_data), 0);
+    std::shuffle(std::begin(t1_data), std::end(t1_data), std::mt19937_64 { 42 });
+
+    auto key = [](auto &&v) { return v % 1'000'003; };
+
+    // take right after order_by keeps a heap of 10 elements, the sort of the whole sequence is what order_by did before
+    auto [top, top_ms] = measure([&] { return from(t1_data)->order_by(key)->take(10)->to_vector(); });
+    auto [sorted, sorted_ms] = measure([&] { return from(t1_data)->order_by(key)->to_vector(); });
+
+    CHECK(top == std::vector<uint64_t>(std::begin(sorted), std::next(std::begin(sorted), 10)));
+
+    std::cout << std::size(t1_data) << " items: order_by->take(10) " << top_ms << " ms, full order_by " << sorted_ms << " ms" << std::endl;
+}
+
+TEST_CASE( "group_by aggregate benchmark", "[.benchmark]" )
+{
+    struct Row
+    {
+        uint32_t Region;
+        uint64_t Total;
+    };
+
+    std::vector<Row> t1_data(10'000'000);
+    std::mt19937 generator { 42 };
+
+    for (auto &&row : t1_data) row = Row { static_cast<uint32_t>(generator() % 1'000), generator() % 10'000 };
+
+    auto region = [](auto &&r) { return r.Region; };
+    auto total = [](auto &&r) { return r.Total; };
+
+    // group_by + per group sum walks vectors of iterators back into the rows, the aggregate overload fills one column per aggregate
+    auto [grouped, grouped_ms] = measure([&]
+    {
+        return from(t1_data)->group_by(region)->select([](auto &&g) { return from(g.second)->sum([](auto &&it) { return (*it).Total; }) + g.second.size(); })->sum();
+    });
+    auto [columnar, columnar_ms] = measure([&]
+    {
+        return from(t1_data)->group_by(region, group::count(), group::sum(total))->select([](auto &&g) { return std::get<2>(g) + std::get<1>(g); })->sum();
+    });
+
+    CHECK(columnar == grouped);
+
+    std::cout << std::size(t1_data) << " rows: group_by then aggregate " << grouped_ms << " ms, group_by with aggregates " << columnar_ms << " ms" << std::endl;
+}
+
+TEST_CASE( "memory_resource_scope benchmark", "[.benchmark]" )
+{
+    std::vector<uint32_t> t1_data(64);
+    std::mt19937 generator { 42 };
+
+    for (auto &&v : t1_data) v = generator() % 16;
+
+    constexpr auto queries { 200'000 };
+    auto query = [&t1_data] { return from(t1_data)->distinct()->order_by()->then_by_descending()->reverse()->sum() + from(t1_data)->group_by([](auto &&v) { return v % 4; })->count(); };
+
+    // many small queries, each one materializes a few containers; the arena reuses one stack buffer for all of them
+    auto [global, global_ms] = measure([&] { uint64_t total {}; for (auto idx = 0; idx < queries; ++idx) total += query(); return total; });
+    auto [arena, arena_ms] = measure([&]
+    {
+        std::array<std::byte, 16 * 1024> buffer;
+        uint64_t total {};
+
+        for (auto idx = 0; idx < queries; ++idx)
+        {
+            std::pmr::monotonic_buffer_resource arena { buffer.data(), buffer.size() };
+            memory_resource_scope scope { &arena };
+
+            total += query();
+        }
+
+        return total;
+    });
+
+    CHECK(arena == global);
+
+    std::cout << queries << " queries: " << global_ms << " ms with the global allocator, " << arena_ms << " ms in a monotonic arena" << std::endl;
+}
+
+TEST_CASE( "contiguous aggregates benchmark", "[.benchmark]" )
+{
+    std::vector<double> t1_data(32'768);
+    std::mt19937 generator { 42 };
+
+    for (auto &&v : t1_data) v = static_cast<double>(generator() % 10'000);
+
+    constexpr auto rollups { 1'000 };
+
+    // a series that stays in cache, so the loops are bound by the arithmetic and not by the memory bandwidth;
+    // the standard algorithms are what the aggregates ran before they dispatched to the vector kernels
+    auto [scalar, scalar_us] = measure<std::chrono::microseconds>([&]
+    {
+        auto begin = std::begin(t1_data), end = std::end(t1_data);
+        double total {};
+
+        for (auto idx = 0; idx < rollups; ++idx) total += std::accumulate(begin, end, 0.0) + *std::min_element(begin, end) + *std::max_element(begin, end) + (std::find(begin, end, -1.0) != end);
+
+        return total;
+    });
+    auto [vector, vector_us] = measure<std::chrono::microseconds>([&]
+    {
+        auto q = from(t1_data);
+        double total {};
+
+        for (auto idx = 0; idx < rollups; ++idx) total += q->sum() + q->min() + q->max() + q->contains(-1.0);
+
+        return total;
+    });
+
+    CHECK(vector == Approx(scalar));
+
+    std::cout << rollups << " rollups of " << std::size(t1_data) << " doubles: sum, min, max and contains " << scalar_us << " us element by element, " << vector_us << " us vectorized" << std::endl;
+}
@@ -0,0 +1,228 @@
+/*
+MIT License
+Copyright (c) 2017 Arlen Keshabyan (arlen.albert@gmail.com)
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "sharp_tcp.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Echo round trips over a few active connections while many idle ones stay tracked by the same reactors.
+// Each backend runs once as a single io_service handing callbacks to its worker, then as one reactor per core
+// with inline callbacks and SO_REUSEPORT accept sharding.
+// Usage: sharp_tcp_benchmark_example [idle_connections=10000] [active_connections=1000] [seconds=3]
+
+using namespace std::chrono_literals;
+using nstd::net::io_backend;
+using nstd::net::tcp_client;
+
+static const char *backend_name(io_backend backend)
+{
+    switch (backend)
+    {
+    case io_backend::select: return "select";
+    case io_backend::epoll: return "epoll";
+    case io_backend::io_uring: return "io_uring";
+    }
+
+    return "?";
+}
+
+static std::size_t max_descriptors()
+{
+#ifdef _WIN32
+    return 1 << 16;
+#else
+    struct rlimit limit {};
+
+    getrlimit(RLIMIT_NOFILE, &limit);
+
+    limit.rlim_cur = limit.rlim_max;
+
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+
+    return limit.rlim_cur;
+#endif
+}
+
+struct echo_state
+{
+    std::atomic_bool stop { false };
+    std::atomic_size_t round_trips { 0 };
+    std::atomic_size_t accepted { 0 };
+    std::mutex clients_mtx {};
+    std::vector<std::shared_ptr<tcp_client>> clients {};
+};
+
+static void echo(const std::shared_ptr<tcp_client> &client)
+{
+    client->async_read({ 4096, [client](auto &&res)
+    {
+        if (!res.success) return;
+
+        client->async_write({ std::move(res.buffer), nullptr });
+
+        echo(client);
+    }});
+}
+
+static void ping(const std::shared_ptr<tcp_client> &client, echo_state &state)
+{
+    static const nstd::net::shared_buffer payload { std::vector<uint8_t>(64, 'x') };
+
+    client->async_write({ payload, nullptr });
+    client->async_read({ 4096, [client, &state](auto &&res)
+    {
+        if (!res.success || state.stop) return;
+
+        ++state.round_trips;
+
+        ping(client, state);
+    }});
+}
+
+static void run(io_backend backend, std::size_t nb_reactors, std::size_t nb_idle, std::size_t nb_active, std::chrono::seconds duration, std::uint32_t port)
+{
+    std::cout << std::setw(9) << backend_name(backend) << " x" << std::left << std::setw(3) << nb_reactors << std::right << ": ";
+
+    if (backend == io_backend::select && 2 * (nb_idle + nb_active) + 16 >= FD_SETSIZE)
+    {
+        std::cout << "skipped, " << 2 * (nb_idle + nb_active) << " descriptors exceed FD_SETSIZE" << std::endl;
+
+        return;
+    }
+
+    std::shared_ptr<nstd::net::io_service_group> reactors;
+
+    try
+    {
+        reactors = std::make_shared<nstd::net::io_service_group>(nb_reactors, backend, nb_reactors > 1);
+    }
+    catch (const nstd::net::sharp_tcp_error &e)
+    {
+        std::cout << "unavailable (" << e.what() << ")" << std::endl;
+
+        return;
+    }
+
+    echo_state state;
+
+    {
+        nstd::net::tcp_server server { reactors };
+
+        server.start("127.0.0.1", port, [&state](const std::shared_ptr<tcp_client> &client)
+        {
+            {
+                std::scoped_lock lock { state.clients_mtx };
+
+                state.clients.push_back(client);
+            }
+
+            echo(client);
+
+            ++state.accepted;
+
+            return true;
+        });
+
+        auto connect_start { std::chrono::steady_clock::now() };
+
+        std::vector<nstd::net::tcp_socket> idle(nb_idle);
+
+        for (std::size_t i = 0; i < nb_idle; ++i)
+        {
+            idle[i].connect("127.0.0.1", port);
+
+            while (state.accepted + 512 < i) std::this_thread::sleep_for(1ms);
+        }
+
+        std::vector<std::shared_ptr<tcp_client>> active;
+
+        for (std::size_t i = 0; i < nb_active; ++i)
+        {
+            active.push_back(std::make_shared<tcp_client>(reactors->next()));
+            active.back()->connect("127.0.0.1", port);
+        }
+
+        while (state.accepted < nb_idle + nb_active) std::this_thread::sleep_for(1ms);
+
+        std::chrono::duration<double> connect_time { std::chrono::steady_clock::now() - connect_start };
+
+        auto start { std::chrono::steady_clock::now() };
+
+        for (const auto &client : active) ping(client, state);
+
+        std::this_thread::sleep_for(duration);
+
+        std::size_t round_trips { state.round_trips };
+        std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+
+        state.stop = true;
+
+        std::cout << std::fixed << std::setprecision(0) << std::setw(10) << round_trips / elapsed.count() << " round trips/s, "
+                  << std::setprecision(2) << connect_time.count() << " s to connect" << std::endl;
+
+        for (const auto &client : active) client->disconnect(true);
+        for (auto &socket : idle) socket.close();
+
+        server.stop(true);
+
+        std::scoped_lock lock { state.clients_mtx };
+
+        for (const auto &client : state.clients) client->disconnect(true);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t nb_idle { argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10'000 };
+    std::size_t nb_active { argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1'000 };
+    std::chrono::seconds duration { argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 3 };
+
+    std::size_t limit { max_descriptors() };
+
+    if (2 * (nb_idle + nb_active) + 64 > limit)
+    {
+        std::size_t available { (limit - 64) / 2 };
+
+        nb_active = std::min(nb_active, available);
+        nb_idle   = available - nb_active;
+
+        std::cout << "descriptor limit is " << limit << ", running with fewer idle connections" << std::endl;
+    }
+
+    std::cout << nb_idle << " idle and " << nb_active << " active connections, " << duration.count() << " s per backend" << std::endl;
+
+    std::uint32_t port { 10'000 + std::random_device {}() % 20'000 };
+    std::size_t nb_cores { std::max(std::thread::hardware_concurrency(), 2u) };
+
+    for (auto backend : { io_backend::select, io_backend::epoll, io_backend::io_uring })
+    {
+        run(backend, 1, nb_idle, nb_active, duration, port++);
+        run(backend, nb_cores, nb_idle, nb_active, duration, port++);
+    }
+
+    return 0;
+}
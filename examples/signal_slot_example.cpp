@@ -0,0 +1,291 @@
+/*
+MIT License
+Copyright (c) 2019 Arlen Keshabyan (arlen.albert@gmail.com)
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "signal_slot.hpp"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+namespace ss = nstd::signal_slot;
+
+static thread_local std::size_t slot_calls { 0 };
+
+// emulates the former emission path, where every emit was serialized by a mutex
+struct serialized_signal
+{
+    void emit(int value)
+    {
+        std::scoped_lock<std::mutex> lock { _lock };
+
+        sig.emit(value);
+    }
+
+    ss::signal<int> sig {};
+    std::mutex _lock {};
+};
+
+template<typename Signal>
+static double emits_per_second(Signal &signal, std::size_t threads, std::size_t emits_per_thread)
+{
+    std::latch start_line { static_cast<std::ptrdiff_t>(threads + 1) };
+    std::vector<std::thread> emitters;
+
+    for (std::size_t idx { 0 }; idx < threads; ++idx)
+        emitters.emplace_back([&]
+        {
+            start_line.arrive_and_wait();
+
+            for (std::size_t e { 0 }; e < emits_per_thread; ++e) signal.emit(static_cast<int>(e));
+        });
+
+    // the clock starts before the emitters are released, they all wait on the latch until this thread arrives
+    auto start { steady_clock::now() };
+
+    start_line.count_down();
+
+    for (auto &emitter : emitters) emitter.join();
+
+    auto seconds { duration<double>(steady_clock::now() - start).count() };
+
+    return static_cast<double>(threads * emits_per_thread) / seconds;
+}
+
+static void emission_benchmark(std::size_t slots, std::size_t emits_per_thread)
+{
+    for (std::size_t threads : { 1u, 4u, 16u })
+    {
+        ss::signal<int> lock_free;
+        serialized_signal serialized;
+        ss::connection_bag cons;
+
+        for (std::size_t idx { 0 }; idx < slots; ++idx)
+        {
+            cons = lock_free.connect([](int value) { slot_calls += value & 1; });
+            cons = serialized.sig.connect([](int value) { slot_calls += value & 1; });
+        }
+
+        auto serialized_rate { emits_per_second(serialized, threads, emits_per_thread) };
+        auto lock_free_rate { emits_per_second(lock_free, threads, emits_per_thread) };
+
+        std::cout << "slots: " << slots << "; threads: " << std::setw(2) << threads
+                  << "; serialized: " << std::setw(12) << static_cast<std::size_t>(serialized_rate) << " emits/s"
+                  << "; lock-free: " << std::setw(12) << static_cast<std::size_t>(lock_free_rate) << " emits/s"
+                  << "; speedup: " << std::fixed << std::setprecision(2) << lock_free_rate / serialized_rate << "x" << std::endl;
+    }
+}
+
+static void churn_benchmark(std::size_t emits_per_thread)
+{
+    ss::signal<int> sig;
+    std::atomic<std::size_t> calls { 0 };
+    auto con { sig.connect([&calls](int) { calls.fetch_add(1, std::memory_order_relaxed); }) };
+    std::atomic_bool done { false };
+    std::size_t reconnects { 0 };
+
+    std::thread writer([&]
+    {
+        while (!done.load(std::memory_order_relaxed))
+        {
+            auto temporary { sig.connect([](int) {}) };
+
+            ++reconnects;
+        }
+    });
+
+    auto rate { emits_per_second(sig, 4, emits_per_thread) };
+
+    done = true;
+    writer.join();
+
+    std::cout << "emitting while connecting/disconnecting: " << static_cast<std::size_t>(rate) << " emits/s; "
+              << reconnects << " reconnects; " << (calls == 4 * emits_per_thread ? "no emissions lost" : "EMISSIONS LOST") << std::endl;
+}
+
+static void burst_benchmark(std::size_t burst_size, std::size_t bursts)
+{
+    std::vector<std::tuple<int>> burst;
+
+    for (std::size_t idx { 0 }; idx < burst_size; ++idx) burst.emplace_back(static_cast<int>(idx));
+
+    auto measure = [&](auto &&consume)
+    {
+        ss::bridged_signal<int> bridged { [](auto *) { return true; } };
+        std::size_t sum { 0 };
+        ss::connection_bag cons;
+
+        cons = bridged.connect([&sum](int value) { sum += value; });
+        cons = bridged.connect_batch([&sum](auto batch) { for (auto &[value] : batch) sum += value; });
+
+        auto start { steady_clock::now() };
+
+        for (std::size_t idx { 0 }; idx < bursts; ++idx)
+        {
+            for (auto &[value] : burst) bridged.emit(value);
+
+            consume(bridged);
+        }
+
+        auto seconds { duration<double>(steady_clock::now() - start).count() };
+
+        return std::make_pair(static_cast<double>(burst_size * bursts) / seconds, sum);
+    };
+
+    auto [one_by_one, sum1] { measure([](auto &bridged) { while (bridged.invoke_next()); }) };
+    auto [batched, sum2] { measure([](auto &bridged) { bridged.invoke_all(); }) };
+
+    std::cout << "bursts of " << burst_size << ": invoke_next loop: " << static_cast<std::size_t>(one_by_one) << " events/s; invoke_all batch: "
+              << static_cast<std::size_t>(batched) << " events/s" << (sum1 == sum2 ? "" : " (MISMATCH)") << std::endl;
+}
+
+// a slot that disconnects itself on the first element must not see the rest of the burst,
+// and the other slots still receive the elements in emission order
+static bool one_shot_slot_in_batch()
+{
+    std::vector<std::tuple<int>> burst { { 1 }, { 2 }, { 3 } };
+    std::vector<std::pair<char, int>> calls, expected { { 'a', 1 }, { 'b', 1 }, { 'b', 2 }, { 'b', 3 } };
+    bool passed { true };
+
+    auto check = [&](const char *path, auto &&emit_burst)
+    {
+        ss::bridged_signal<int> sig { [](auto *) { return true; } };
+        ss::connection one_shot;
+        ss::connection_bag cons;
+
+        calls.clear();
+
+        one_shot = sig.connect([&](int value) { calls.emplace_back('a', value); one_shot.disconnect(); });
+        cons = sig.connect([&](int value) { calls.emplace_back('b', value); });
+
+        emit_burst(sig);
+
+        std::cout << "one-shot slot in a batch (" << path << "): " << (calls == expected ? "ok" : "FAILED") << std::endl;
+
+        passed = passed && calls == expected;
+    };
+
+    check("emit_batch", [&](auto &sig) { sig.set_bridge_enabled(false); sig.emit_batch(burst); });
+    check("invoke_all", [&](auto &sig) { for (auto &[value] : burst) sig.emit(value); sig.invoke_all(); });
+
+    return passed;
+}
+
+// a slot that throws on a deferred dispatch must not stall the signal, and the exception has to reach the caller
+static bool throwing_slot_recovers()
+{
+    std::atomic<int> throttled_calls { 0 }, queued_calls { 0 }, timer_calls { 0 };
+    bool passed { true };
+
+    {
+        ss::throttled_signal<int> throttled { u8"throttled", 1ms };
+        ss::queued_signal<int> queued { u8"queued" };
+        ss::timer_signal<> timer { u8"timer", 2ms };
+        ss::connection_bag cons;
+
+        cons = throttled.connect([&](int value) { ++throttled_calls; if (value == 0) throw std::runtime_error { "throttled" }; });
+        cons = queued.connect([&](int value) { ++queued_calls; if (value == 0) throw std::runtime_error { "queued" }; });
+        cons = timer.connect([&](auto *) { if (timer_calls++ == 0) throw std::runtime_error { "timer" }; });
+
+        timer.start_timer();
+
+        for (int value { 0 }; value < 3; ++value) throttled.emit(value);
+
+        queued.emit(0);
+
+        std::this_thread::sleep_for(50ms);
+
+        for (int value { 1 }; value < 3; ++value) queued.emit(value);
+
+        std::this_thread::sleep_for(50ms);
+
+        timer.stop_timer();
+    }
+
+    try
+    {
+        ss::signal_dispatcher::instance().rethrow_slot_exception();
+
+        passed = false;
+    }
+    catch (const std::runtime_error &) {}
+
+    passed = passed && throttled_calls == 3 && queued_calls == 3 && timer_calls > 1;
+
+    std::cout << "throwing deferred slots: " << throttled_calls << " throttled, " << queued_calls << " queued, " << timer_calls << " timer calls: " << (passed ? "ok" : "FAILED") << std::endl;
+
+    return passed;
+}
+
+static void deferred_signals(std::size_t count)
+{
+    std::atomic<std::size_t> ticks { 0 }, throttled { 0 };
+    std::vector<std::unique_ptr<ss::timer_signal<>>> timers;
+    std::vector<std::unique_ptr<ss::throttled_signal<int>>> throttled_signals;
+    ss::connection_bag cons;
+
+    for (std::size_t idx { 0 }; idx < count; ++idx)
+    {
+        auto &timer { timers.emplace_back(std::make_unique<ss::timer_signal<>>(u8"timer", 10ms)) };
+        auto &throttled_signal { throttled_signals.emplace_back(std::make_unique<ss::throttled_signal<int>>(u8"throttled", 5ms)) };
+
+        cons = timer->connect([&ticks](auto *) { ticks.fetch_add(1, std::memory_order_relaxed); });
+        cons = throttled_signal->connect([&throttled](int) { throttled.fetch_add(1, std::memory_order_relaxed); });
+
+        timer->start_timer();
+
+        for (int value { 0 }; value < 10; ++value) throttled_signal->emit(value);
+    }
+
+    std::this_thread::sleep_for(200ms);
+
+    std::cout << count << " timer and " << count << " throttled signals are served by " << ss::signal_dispatcher::instance().thread_count()
+              << " dispatcher threads; " << ticks << " timer ticks and " << throttled << " throttled emissions in 200ms" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t emits_per_thread { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000 };
+
+    for (std::size_t slots : { 1u, 3u }) emission_benchmark(slots, emits_per_thread);
+
+    churn_benchmark(emits_per_thread);
+
+    for (std::size_t burst_size : { 16u, 256u, 4096u }) burst_benchmark(burst_size, emits_per_thread / burst_size);
+
+    if (!one_shot_slot_in_batch()) return 1;
+
+    if (!throwing_slot_recovers()) return 1;
+
+    deferred_signals(2000);
+
+    std::cout << "exitting..." << std::endl;
+
+    return 0;
+}
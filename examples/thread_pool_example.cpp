@@ -0,0 +1,224 @@
+/*
+MIT License
+Copyright (c) 2019 Arlen Keshabyan (arlen.albert@gmail.com)
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <latch>
+#include <memory_resource>
+#include <numeric>
+#include <string_view>
+#include <vector>
+#include <random>
+#include "parallel_algorithms.hpp"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+// forwards to the default resource and counts what the pool takes from it
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations() const { return _allocations; }
+
+private:
+    std::atomic<std::size_t> _allocations { 0 };
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++_allocations;
+
+        return std::pmr::get_default_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *memory, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::get_default_resource()->deallocate(memory, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+static const char *policy_name(nstd::scheduling_policy policy)
+{
+    return policy == nstd::scheduling_policy::work_stealing ? "work_stealing" : "shared_queue ";
+}
+
+static void throughput_benchmark(nstd::scheduling_policy policy, std::size_t fan_out, std::size_t tasks_per_fan)
+{
+    nstd::thread_pool pool { std::max(std::thread::hardware_concurrency(), 2u) - 1u, policy };
+    std::latch done { static_cast<std::ptrdiff_t>(fan_out * tasks_per_fan) };
+
+    auto start { steady_clock::now() };
+
+    for (std::size_t fan { 0 }; fan < fan_out; ++fan)
+    {
+        // each fan spawns tiny tasks from within a worker thread, the way request handlers do
+        pool.post([&pool, &done, tasks_per_fan]
+        {
+            for (std::size_t idx { 0 }; idx < tasks_per_fan; ++idx) pool.post([&done]{ done.count_down(); });
+        });
+    }
+
+    done.wait();
+
+    auto elapsed { duration_cast<duration<double>>(steady_clock::now() - start).count() };
+    auto total { fan_out * tasks_per_fan };
+
+    std::cout << policy_name(policy) << " throughput: " << static_cast<std::size_t>(total / elapsed) << " tasks/s (" << total << " tasks in " << elapsed << " s)" << std::endl;
+}
+
+static void latency_benchmark(nstd::scheduling_policy policy, std::size_t samples)
+{
+    nstd::thread_pool pool { std::max(std::thread::hardware_concurrency(), 2u) - 1u, policy };
+    std::vector<double> latencies; latencies.reserve(samples);
+
+    for (std::size_t idx { 0 }; idx < samples; ++idx)
+    {
+        auto enqueued { steady_clock::now() };
+
+        latencies.emplace_back(pool.submit([enqueued]{ return duration_cast<duration<double, std::micro>>(steady_clock::now() - enqueued).count(); }).get());
+    }
+
+    std::sort(std::begin(latencies), std::end(latencies));
+
+    auto average { std::accumulate(std::begin(latencies), std::end(latencies), 0.) / std::size(latencies) };
+
+    std::cout << policy_name(policy) << " latency: avg " << average << " us, p50 " << latencies[samples / 2] << " us, p99 " << latencies[samples * 99 / 100] << " us" << std::endl;
+}
+
+static void allocation_benchmark(nstd::scheduling_policy policy, std::size_t tasks)
+{
+    counting_resource resource;
+    nstd::thread_pool pool { std::max(std::thread::hardware_concurrency(), 2u) - 1u, policy, &resource };
+    std::array<std::uint64_t, 4> payload { 1, 2, 3, 4 };
+
+    pool.submit([]{}).wait(); // warming up the task slab
+
+    auto allocations_before { resource.allocations() };
+    std::uint64_t sum { 0 };
+
+    for (std::size_t idx { 0 }; idx < tasks; ++idx) sum += pool.submit([payload, idx]{ return payload[idx % 4]; }).get();
+
+    std::cout << policy_name(policy) << " task allocations per submit: " << double(resource.allocations() - allocations_before) / tasks << " (checksum " << sum << ")" << std::endl;
+}
+
+static void parallel_algorithms_benchmark(std::size_t count)
+{
+    std::mt19937 generator { 42 };
+    std::vector<std::uint64_t> data(count);
+
+    for (auto &value : data) value = generator();
+
+    auto sorted { data };
+    auto start { steady_clock::now() };
+
+    nstd::parallel::sort(std::begin(sorted), std::end(sorted));
+
+    auto sort_elapsed { duration_cast<duration<double, std::milli>>(steady_clock::now() - start).count() };
+    std::vector<std::uint64_t> prefix_sums(count);
+
+    start = steady_clock::now();
+
+    nstd::parallel::inclusive_scan(std::begin(data), std::end(data), std::begin(prefix_sums));
+
+    auto sum { nstd::parallel::reduce(std::begin(data), std::end(data), std::uint64_t { 0 }) };
+    auto scan_elapsed { duration_cast<duration<double, std::milli>>(steady_clock::now() - start).count() };
+
+    std::cout << "parallel sort of " << count << " items: " << sort_elapsed << " ms (sorted: " << std::boolalpha << std::is_sorted(std::begin(sorted), std::end(sorted)) << ")" << std::endl;
+    std::cout << "parallel scan + reduce: " << scan_elapsed << " ms (consistent: " << (prefix_sums.back() == sum) << ")" << std::endl;
+}
+
+// a worker blocked in a nested parallel call while its pool is destroyed: the helpers the pool drops count as done,
+// so the call finishes the chunks on its own and the pool can join the worker
+static void cancelled_nested_call(nstd::scheduling_policy policy)
+{
+    std::atomic_bool finished { false };
+    auto start { steady_clock::now() };
+
+    {
+        nstd::thread_pool pool { 2, policy };
+        std::latch nested { 1 };
+
+        pool.post([] { std::this_thread::sleep_for(100ms); });
+        pool.post([&] { nested.count_down(); nstd::parallel::for_index(0, 200, [](int) { std::this_thread::sleep_for(1ms); }, 1, pool); finished = true; });
+
+        nested.wait();
+    }
+
+    std::cout << policy_name(policy) << ": pool destroyed during a nested parallel call after " << duration_cast<milliseconds>(steady_clock::now() - start).count()
+              << " ms (call finished: " << std::boolalpha << finished << ")" << std::endl;
+}
+
+int main()
+{
+    nstd::global_thread_pool::set_scheduling_policy(nstd::scheduling_policy::work_stealing);
+
+    constexpr const nstd::scheduling_policy policies[] { nstd::scheduling_policy::shared_queue, nstd::scheduling_policy::work_stealing };
+
+    for (auto policy : policies) throughput_benchmark(policy, 64, 10000);
+    for (auto policy : policies) latency_benchmark(policy, 10000);
+    for (auto policy : policies) allocation_benchmark(policy, 100000);
+
+    parallel_algorithms_benchmark(1 << 22);
+
+    for (auto policy : policies) cancelled_nested_call(policy);
+
+    std::cout << "global pool policy: " << policy_name(nstd::global_thread_pool::get_thread_pool().policy()) << std::endl;
+    std::cout << "global pool result: " << nstd::global_thread_pool::enqueue([](int a, int b){ return a + b; }, 40, 2).get() << std::endl;
+
+    try
+    {
+        nstd::global_thread_pool::enqueue([]{ throw std::runtime_error("task failure"); }).get();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "exception propagated through the future: " << e.what() << std::endl;
+    }
+
+    auto slow { nstd::global_thread_pool::submit([]{ std::this_thread::sleep_for(50ms); return 42; }) };
+
+    std::cout << "wait_for(10ms) on a 50ms task: " << (slow.wait_for(10ms) == std::future_status::timeout ? "timeout" : "ready") << ", then "
+              << (slow.wait_for(1s) == std::future_status::ready ? "ready" : "timeout") << " with " << slow.get() << std::endl;
+
+    std::latch posted { 1 };
+
+    nstd::global_thread_pool::post([&posted]{ posted.count_down(); throw std::runtime_error("posted job failure"); });
+
+    posted.wait();
+    std::this_thread::sleep_for(10ms);
+
+    try
+    {
+        nstd::global_thread_pool::get_thread_pool().rethrow_job_exception();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "exception kept for a posted job: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
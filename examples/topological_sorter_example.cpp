@@ -19,10 +19,69 @@ SOFTWARE.
 */
 
 #include "topological_sorter.hpp"
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <random>
+#include <string>
+#include <thread>
 
-int main()
+template <typename Sorter>
+static double measure_sort(Sorter &sorter, std::size_t &sorted_count)
+{
+    auto start { std::chrono::steady_clock::now() };
+    auto [sorted, cycled] { sorter.sort() };
+
+    sorted_count = std::size(sorted);
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// sorting random DAGs with topological_sorter and indexed_topological_sorter
+static void benchmark(std::size_t max_edges)
+{
+    for (std::size_t edges { 10000 }; edges <= max_edges; edges *= 10)
+    {
+        const auto nodes { std::max<std::size_t>(edges / 4, 2) };
+        std::mt19937_64 generator { edges };
+        std::uniform_int_distribution<std::size_t> node { 0, nodes - 1 };
+        nstd::topological_sorter<std::size_t> sorter;
+        nstd::indexed_topological_sorter<std::size_t> indexed_sorter;
+        std::size_t sorted { 0 }, indexed_sorted { 0 }, incremental_sorted { 0 };
+
+        indexed_sorter.reserve(nodes);
+
+        for (std::size_t idx { 0 }; idx < edges; ++idx)
+        {
+            auto a { node(generator) }, b { node(generator) };
+
+            if (a == b) continue;
+
+            // the object always has the greater number, so there is no cycle
+            sorter.add(std::max(a, b), std::min(a, b));
+            indexed_sorter.add(std::max(a, b), std::min(a, b));
+        }
+
+        auto sort_time { measure_sort(sorter, sorted) };
+        auto indexed_sort_time { measure_sort(indexed_sorter, indexed_sorted) };
+        auto start { std::chrono::steady_clock::now() };
+
+        for (std::size_t idx { 0 }; idx < 1000; ++idx)
+        {
+            auto a { node(generator) }, b { node(generator) };
+
+            if (a != b) indexed_sorter.add(std::max(a, b), std::min(a, b));
+        }
+
+        auto incremental_time { std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() + measure_sort(indexed_sorter, incremental_sorted) };
+
+        std::cout << edges << " edges / " << nodes << " nodes: topological_sorter " << sort_time << " ms (" << sorted << " sorted), indexed "
+                  << indexed_sort_time << " ms (" << indexed_sorted << " sorted), 1000 more edges + incremental re-sort " << incremental_time << " ms (" << incremental_sorted << " sorted)" << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
 {
     using namespace std::string_literals;
 
@@ -81,8 +140,59 @@ int main()
         std::cout << std::endl;
     }
 
+    // executing the tasks concurrently, every task starts as soon as all its dependencies are done
+    auto statistics { resolver.execute([](const task_ptr &t)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 * (t->message[0] - 'A' + 1)));
+
+        //if (t->message[0] == 'E') throw std::runtime_error("E failed"); // uncomment this line to test the cancellation
+    }) };
+
+    std::cout << std::endl << "executed: " << std::size(statistics.executed) << ", failed: " << std::size(statistics.failed) << ", skipped: " << std::size(statistics.skipped) << std::endl;
+    std::cout << "critical path (" << std::chrono::duration_cast<std::chrono::milliseconds>(statistics.critical_path_duration).count() << " ms): ";
+
+    for (auto const& d: statistics.critical_path)
+        std::cout << d->message[0] << " ";
+
+    std::cout << std::endl << "wall time: " << std::chrono::duration_cast<std::chrono::milliseconds>(statistics.wall_duration).count() << " ms, parallelism: " << statistics.parallelism() << std::endl << std::endl;
+
+    {
+        // a run nested in a pool task while the pool is destroyed: the nodes the pool drops are not started and the run ends
+        nstd::topological_sorter<char> chain;
+        std::atomic<std::size_t> executed { 0 };
+
+        for (char c { 'B' }; c <= 'Z'; ++c) chain.add(c, static_cast<char>(c - 1));
+
+        {
+            nstd::thread_pool pool { 2 };
+
+            pool.post([&] { executed = std::size(chain.execute([](char) { std::this_thread::sleep_for(std::chrono::milliseconds(5)); }, pool).executed); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        }
+
+        std::cout << "pool destroyed during a run, nodes executed: " << executed << " of 26" << std::endl << std::endl;
+    }
+
     //tasks.clear(); // uncomment this line to distroy all tasks in sorted order.
 
+    nstd::indexed_topological_sorter<char> cycled_resolver;
+
+    cycled_resolver.add('A', 'B');
+    cycled_resolver.add('B', 'C');
+    cycled_resolver.add('C', 'A');
+    cycled_resolver.add('D', 'C');
+
+    for (const auto &cycle : cycled_resolver.find_cycles())
+    {
+        std::cout << "Cycle found: ";
+
+        for (auto c : cycle) std::cout << c << " ";
+
+        std::cout << std::endl;
+    }
+
+    benchmark(argc > 1 ? std::stoull(argv[1]) : 1000000); // pass 10000000 to run the largest graph as well
+
     std::cout << "exiting..." << std::endl;
 
     return 0;
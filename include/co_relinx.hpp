@@ -25,35 +25,128 @@ SOFTWARE.
 */
 
 #include <algorithm>
+#include <array>
+#include <concepts>
 #include <coroutine>
 #include <deque>
 #include <functional>
 #include <iterator>
 #include <list>
 #include <memory>
+#include <new>
+#include <memory_resource>
 #include <numeric>
 #include <optional>
 #include <sstream>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <span>
 #include <iostream>
 
+#include "relinx_memory_resource.hpp"
+
 namespace nstd::co_relinx
 {
 
 using namespace std::literals;
 
-template<typename ...Args>
-using default_container = std::vector<Args...>;
-template<typename ...Args>
-using default_set = std::unordered_set<Args...>;
-template<typename ...Args>
-using default_map = std::unordered_map<Args...>;
-template<typename ...Args>
-using default_multimap = std::unordered_multimap<Args...>;
+using nstd::relinx::memory_resource;
+using nstd::relinx::memory_resource_scope;
+using nstd::relinx::query_allocator;
+using nstd::relinx::default_container;
+using nstd::relinx::default_map;
+using nstd::relinx::default_multimap;
+using nstd::relinx::default_set;
+
+
+namespace detail
+{
+
+// recycles coroutine frames per thread in size classes, every operator of a query stacks another frame
+class frame_pool
+{
+public:
+	static auto allocate(std::size_t size) noexcept -> void*
+	{
+		auto &cache { local() };
+		auto index { size_class(size) };
+
+		if (index < classes && cache.heads[index])
+		{
+			auto frame { cache.heads[index] };
+
+			cache.heads[index] = frame->next;
+			--cache.counts[index];
+
+			return frame;
+		}
+
+		return ::operator new(index < classes ? (index + 1) * granularity : size, std::nothrow);
+	}
+
+	static auto deallocate(void *frame, std::size_t size) noexcept -> void
+	{
+		auto &cache { local() };
+		auto index { size_class(size) };
+
+		if (index < classes && !cache.closed && cache.counts[index] < max_cached)
+		{
+			cache.heads[index] = ::new (frame) free_frame { cache.heads[index] };
+			++cache.counts[index];
+
+			return;
+		}
 
+		::operator delete(frame);
+	}
+
+private:
+	static constexpr std::size_t granularity { 64 };
+	static constexpr std::size_t classes { 32 };
+	static constexpr std::size_t max_cached { 64 };
+
+	struct free_frame
+	{
+		free_frame *next;
+	};
+
+	// trivially destructible, so frames freed by other thread_local objects after the release still find it
+	struct cache
+	{
+		std::array<free_frame*, classes> heads;
+		std::array<std::size_t, classes> counts;
+		bool closed;
+	};
+
+	struct release
+	{
+		~release()
+		{
+			auto &cache { local() };
+
+			cache.closed = true;
+
+			for (auto head : cache.heads) while (head) ::operator delete(std::exchange(head, head->next));
+		}
+	};
+
+	static auto size_class(std::size_t size) noexcept -> std::size_t
+	{
+		return (size + granularity - 1) / granularity - 1;
+	}
+
+	static auto local() noexcept -> cache&
+	{
+		thread_local cache local_cache {};
+		thread_local release local_release {};
+
+		return local_cache;
+	}
+};
+
+}
 
 template<typename CoroType>
 class generator
@@ -65,7 +158,18 @@ public:
 
 	struct promise_type
 	{
-		CoroType current_value;
+		const CoroType *value {};
+		CoroType storage {};
+
+		static void *operator new(std::size_t size) noexcept
+		{
+			return detail::frame_pool::allocate(size);
+		}
+
+		static void operator delete(void *frame, std::size_t size) noexcept
+		{
+			detail::frame_pool::deallocate(frame, size);
+		}
 
 		static auto get_return_object_on_allocation_failure()
 		{
@@ -77,12 +181,12 @@ public:
 			return generator{handle::from_promise(*this)};
 		}
 
-		auto initial_suspend()
+		auto initial_suspend() noexcept
 		{
 			return std::suspend_always{};
 		}
 
-		auto final_suspend()
+		auto final_suspend() noexcept
 		{
 			return std::suspend_always{};
 		}
@@ -96,22 +200,32 @@ public:
 		{
 		}
 
-		auto yield_value(CoroType value)
+		// the yielded object lives until the generator is resumed again, so only its address is kept
+		auto yield_value(const CoroType &yielded) noexcept
 		{
-			current_value = std::move(value);
+			value = std::addressof(yielded);
 			
 			return std::suspend_always{};
 		}
+
+		// a yielded temporary is gone after the suspension, it is moved into the promise instead
+		auto yield_value(CoroType &&yielded) noexcept(std::is_nothrow_move_assignable_v<CoroType>)
+		{
+			storage = std::move(yielded);
+			value = std::addressof(storage);
+
+			return std::suspend_always{};
+		}
 	};
 
 	bool move_next()
 	{
-		return _coro ? (_coro.resume(), !_coro.done()) : false;
+		return _coro && !_coro.done() ? (_coro.resume(), !_coro.done()) : false;
 	}
 
-	CoroType current_value()
+	const CoroType &current_value() const
 	{
-		return _coro.promise().current_value;
+		return *_coro.promise().value;
 	}
 
 	generator(generator const&) = delete;
@@ -135,8 +249,15 @@ private:
 	handle _coro;
 };
 
+template<typename Iterator>
+generator<typename Iterator::value_type> co_from(Iterator begin, Iterator end)
+{
+	while (begin != end) { co_yield *begin; ++begin; }
+}
+
+// the frame owns an rvalue container, a reference parameter would dangle once the temporary is gone
 template<typename Container>
-generator<typename Container::value_type> co_from(Container &&container)
+generator<typename Container::value_type> co_from_owned(Container container)
 {
 	auto begin { std::begin(container) };
 	auto end { std::end(container) };
@@ -145,50 +266,50 @@ generator<typename Container::value_type> co_from(Container &&container)
 }
 
 template<typename Container>
-generator<typename Container::value_type> co_from(Container &container)
+generator<typename Container::value_type> co_from(Container &&container)
 {
-	return co_from(std::begin(container), std::end(container));
+	return co_from_owned(std::move(container));
 }
 
-template<typename Iterator>
-generator<typename Iterator::value_type> co_from(Iterator begin, Iterator end)
+template<typename Container>
+generator<typename Container::value_type> co_from(Container &container)
 {
-	while (begin != end) { co_yield *begin; ++begin; }
+	return co_from(std::begin(container), std::end(container));
 }
 
 template<typename CoroType>
-generator<CoroType> co_concat(generator<CoroType> &&gen1, generator<CoroType> &&gen2)
+generator<CoroType> co_concat(generator<CoroType> gen1, generator<CoroType> gen2)
 {
 	while (gen1.move_next()) co_yield gen1.current_value();
 	while (gen2.move_next()) co_yield gen2.current_value();
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_filter(generator<CoroType> &&gen, Functor func)
+generator<CoroType> co_filter(generator<CoroType> gen, Functor func)
 {
 	while (gen.move_next())
 	{
-		auto cv { gen.current_value() };
+		const auto &cv { gen.current_value() };
 
 		if (func(cv)) co_yield cv;
 	}
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_filter_i(generator<CoroType> &&gen, Functor func)
+generator<CoroType> co_filter_i(generator<CoroType> gen, Functor func)
 {
 	uint64_t index { 0 };
 
 	while (gen.move_next())
 	{
-		auto cv { gen.current_value() };
+		const auto &cv { gen.current_value() };
 
 		if (func(cv, index++)) co_yield cv;
 	}
 }
 
 template<typename CoroType>
-generator<CoroType> co_reverse(generator<CoroType> &&gen)
+generator<CoroType> co_reverse(generator<CoroType> gen)
 {
 	default_container<CoroType> v;
 
@@ -206,7 +327,7 @@ generator<CoroType> co_reverse(generator<CoroType> &&gen)
 }
 
 template<typename CoroType>
-generator<CoroType> co_skip(generator<CoroType> &&gen, size_t count)
+generator<CoroType> co_skip(generator<CoroType> gen, size_t count)
 {
 	bool good { true };
 
@@ -216,7 +337,7 @@ generator<CoroType> co_skip(generator<CoroType> &&gen, size_t count)
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_skip_while(generator<CoroType> &&gen, Functor func)
+generator<CoroType> co_skip_while(generator<CoroType> gen, Functor func)
 {
 	bool good { true };
 
@@ -226,11 +347,11 @@ generator<CoroType> co_skip_while(generator<CoroType> &&gen, Functor func)
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_tee(generator<CoroType> &&gen, Functor func)
+generator<CoroType> co_tee(generator<CoroType> gen, Functor func)
 {
 	while (gen.move_next())
 	{
-		const auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 
 		func(value);
 
@@ -239,13 +360,13 @@ generator<CoroType> co_tee(generator<CoroType> &&gen, Functor func)
 }
 
 template<typename CoroType, typename Functor>
-auto co_transform(generator<CoroType> &&gen, Functor func) -> generator<decltype(func(CoroType()))>
+auto co_transform(generator<CoroType> gen, Functor func) -> generator<decltype(func(CoroType()))>
 {
 	while (gen.move_next()) co_yield func(gen.current_value());
 }
 
 template<typename CoroType, typename Functor>
-auto co_transform_i(generator<CoroType> &&gen, Functor func) -> generator<decltype(func(CoroType(), 0UL))>
+auto co_transform_i(generator<CoroType> gen, Functor func) -> generator<decltype(func(CoroType(), 0UL))>
 {
 	uint64_t index { 0 };
 
@@ -256,11 +377,11 @@ auto co_transform_i(generator<CoroType> &&gen, Functor func) -> generator<declty
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_limit(generator<CoroType> &&gen, Functor func)
+generator<CoroType> co_limit(generator<CoroType> gen, Functor func)
 {
 	while (gen.move_next())
 	{
-		const auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 
 		if (!func(value)) break;
 
@@ -269,13 +390,13 @@ generator<CoroType> co_limit(generator<CoroType> &&gen, Functor func)
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_limit_i(generator<CoroType> &&gen, Functor func)
+generator<CoroType> co_limit_i(generator<CoroType> gen, Functor func)
 {
 	uint64_t index { 0 };
 
 	while (gen.move_next())
 	{
-		const auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 
 		if (!func(value, index++)) break;
 
@@ -284,13 +405,13 @@ generator<CoroType> co_limit_i(generator<CoroType> &&gen, Functor func)
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_distinct(generator<CoroType> &&gen, Functor func)
+generator<CoroType> co_distinct(generator<CoroType> gen, Functor func)
 {
 	default_set<decltype(func(CoroType()))> processed;
 
 	while (gen.move_next())
 	{
-		const auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 
 		if (processed.contains(func(value))) continue;
 
@@ -301,31 +422,31 @@ generator<CoroType> co_distinct(generator<CoroType> &&gen, Functor func)
 }
 
 template<typename CoroType, typename Functor>
-auto co_select_many(generator<CoroType> &&gen, Functor func) -> generator<decltype(func(typename CoroType::value_type()))>
+auto co_select_many(generator<CoroType> gen, Functor func) -> generator<decltype(func(typename CoroType::value_type()))>
 {
 	while (gen.move_next())
 	{
-		const auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 		
 		for (const auto &v : value) co_yield func(v);
 	}
 }
 
 template<typename CoroType, typename Functor>
-auto co_select_many_i(generator<CoroType> &&gen, Functor func) -> generator<decltype(func(typename CoroType::value_type(), 0UL))>
+auto co_select_many_i(generator<CoroType> gen, Functor func) -> generator<decltype(func(typename CoroType::value_type(), 0UL))>
 {
 	uint64_t index { 0 };
 
 	while (gen.move_next())
 	{
-		const auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 		
 		for (const auto &v : value) co_yield func(v, index++);
 	}
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_except(generator<CoroType> &&gen1, generator<CoroType> &&gen2, Functor func)
+generator<CoroType> co_except(generator<CoroType> gen1, generator<CoroType> gen2, Functor func)
 {
 	default_set<CoroType> processed;
 	default_container<CoroType> provided;
@@ -334,7 +455,7 @@ generator<CoroType> co_except(generator<CoroType> &&gen1, generator<CoroType> &&
 
 	while (gen1.move_next())
 	{
-		const auto value { gen1.current_value() };
+		const auto &value { gen1.current_value() };
 
 		if (processed.contains(value)) continue;
 
@@ -349,13 +470,13 @@ generator<CoroType> co_except(generator<CoroType> &&gen1, generator<CoroType> &&
 }
 
 template<typename CoroType, typename Iterator, typename Functor>
-generator<CoroType> co_except(generator<CoroType> &&gen, Iterator begin, Iterator end, Functor func)
+generator<CoroType> co_except(generator<CoroType> gen, Iterator begin, Iterator end, Functor func)
 {
 	default_set<CoroType> processed;
 
 	while (gen.move_next())
 	{
-		const auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 
 		if (processed.contains(value)) continue;
 
@@ -368,7 +489,7 @@ generator<CoroType> co_except(generator<CoroType> &&gen, Iterator begin, Iterato
 }
 
 template<typename CoroType, typename Functor>
-generator<CoroType> co_intersect(generator<CoroType> &&gen1, generator<CoroType> &&gen2, Functor func)
+generator<CoroType> co_intersect(generator<CoroType> gen1, generator<CoroType> gen2, Functor func)
 {
 	default_set<CoroType> processed;
 	default_container<CoroType> provided;
@@ -377,7 +498,7 @@ generator<CoroType> co_intersect(generator<CoroType> &&gen1, generator<CoroType>
 
 	while (gen1.move_next())
 	{
-		const auto value { gen1.current_value() };
+		const auto &value { gen1.current_value() };
 
 		if (processed.contains(value)) continue;
 
@@ -392,13 +513,13 @@ generator<CoroType> co_intersect(generator<CoroType> &&gen1, generator<CoroType>
 }
 
 template<typename CoroType, typename Iterator, typename Functor>
-generator<CoroType> co_intersect(generator<CoroType> &&gen, Iterator begin, Iterator end, Functor func)
+generator<CoroType> co_intersect(generator<CoroType> gen, Iterator begin, Iterator end, Functor func)
 {
 	default_set<CoroType> processed;
 
 	while (gen.move_next())
 	{
-		const auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 
 		if (processed.contains(value)) continue;
 
@@ -411,7 +532,7 @@ generator<CoroType> co_intersect(generator<CoroType> &&gen, Iterator begin, Iter
 }
 
 template<typename CoroType>
-generator<CoroType> co_default_if_empty(generator<CoroType> &&gen, CoroType default_value)
+generator<CoroType> co_default_if_empty(generator<CoroType> gen, CoroType default_value)
 {
 	if (gen.move_next())
 	{
@@ -424,7 +545,7 @@ generator<CoroType> co_default_if_empty(generator<CoroType> &&gen, CoroType defa
 }
 
 template<typename CoroType>
-generator<CoroType> co_cycle(generator<CoroType> &&gen, int count)
+generator<CoroType> co_cycle(generator<CoroType> gen, int count)
 {
 	if (count != 0)
 	{
@@ -472,13 +593,13 @@ generator<CoroType> co_cycle(generator<CoroType> &&gen, int count)
 }
 
 template<typename CoroType>
-generator<CoroType> co_take(generator<CoroType> &&gen, size_t limit)
+generator<CoroType> co_take(generator<CoroType> gen, size_t limit)
 {
-	while (gen.move_next() && limit--) co_yield gen.current_value();
+	while (limit > 0 && gen.move_next()) { --limit; co_yield gen.current_value(); }
 }
 
 template<typename CoroType1, typename CoroType2, typename Functor>
-auto co_zip(generator<CoroType1> &&gen1, generator<CoroType2> &&gen2, Functor func) -> generator<decltype(func(CoroType1(), CoroType2()))>
+auto co_zip(generator<CoroType1> gen1, generator<CoroType2> gen2, Functor func) -> generator<decltype(func(CoroType1(), CoroType2()))>
 {
 	while (gen1.move_next() && gen2.move_next()) co_yield func(gen1.current_value(), gen2.current_value());
 }
@@ -495,122 +616,273 @@ generator<CoroType> co_repeat(CoroType value, size_t count)
 	while (count--) co_yield value;
 }
 
-template<typename CoroType, typename JoinIterator, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
-auto co_join(generator<CoroType> &&gen, JoinIterator begin, JoinIterator end, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin) -> generator<decltype(resultFunctor(thisKeyFunctor(CoroType()), otherKeyFunctor(typename JoinIterator::value_type())))>
+template<typename CompareFunctor, typename ThisKey, typename OtherKey>
+concept HashJoinable = (std::same_as<std::decay_t<CompareFunctor>, std::equal_to<>> || std::same_as<std::decay_t<CompareFunctor>, std::equal_to<ThisKey>>) &&
+						std::same_as<ThisKey, OtherKey> &&
+						requires(const ThisKey &key) { { std::hash<ThisKey>()(key) } -> std::convertible_to<std::size_t>; };
+
+template<typename Iterator, typename KeyFunctor>
+auto co_index(Iterator begin, Iterator end, KeyFunctor &keyFunctor)
 {
-    using thisKeyType = typename std::decay<decltype(thisKeyFunctor(CoroType()))>::type;
-    using joinValueType = typename JoinIterator::value_type;
+	using value_type = typename std::decay<decltype(*begin)>::type;
 
-    while (gen.move_next())
-    {
-    	auto value { gen.current_value() };
-        auto thisKey = thisKeyFunctor(value);
-        auto match = std::find_if(begin, end, [&thisKey, &compareFunctor, &otherKeyFunctor](auto &&v) { return compareFunctor(thisKey, otherKeyFunctor(v)); });
-        auto join_value { match == end ? joinValueType() : *match };
+	default_map<typename std::decay<decltype(keyFunctor(*begin))>::type, default_container<value_type>> index;
 
-        if (match == end && !leftJoin) continue;
+	while (begin != end) { index[keyFunctor(*begin)].push_back(*begin); ++begin; }
 
-        co_yield resultFunctor(value, join_value);
-    }
+	return index;
 }
 
-template<typename CoroType1, typename CoroType2, typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
-auto co_join(generator<CoroType1> &&gen1, generator<CoroType2> &&gen2, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin) -> generator<decltype(resultFunctor(thisKeyFunctor(CoroType1()), otherKeyFunctor(CoroType2())))>
+template<typename CoroType, typename KeyFunctor>
+auto co_index(generator<CoroType> &&gen, KeyFunctor &keyFunctor)
 {
-    using thisKeyType = typename std::decay<decltype(thisKeyFunctor(CoroType1()))>::type;
+	default_map<typename std::decay<decltype(keyFunctor(CoroType()))>::type, default_container<CoroType>> index;
 
-	default_container<CoroType2> provided;
+	while (gen.move_next())
+	{
+		const auto &value { gen.current_value() };
 
-	while (gen2.move_next()) provided.push_back(gen2.current_value());
+		index[keyFunctor(value)].push_back(value);
+	}
 
-	auto begin { std::begin(provided) };
-	auto end { std::end(provided) };
+	return index;
+}
 
-    while (gen1.move_next())
-    {
-    	auto value { gen1.current_value() };
-        auto thisKey = thisKeyFunctor(value);
-        auto match = std::find_if(begin, end, [&thisKey, &compareFunctor, &otherKeyFunctor](auto &&v) { return compareFunctor(thisKey, otherKeyFunctor(v)); });
-        auto join_value { match == end ? CoroType2() : *match };
+template<typename CoroType, typename JoinValueType, typename Index, typename ThisKeyFunctor, typename ResultFunctor>
+auto co_hash_join(generator<CoroType> gen, Index index, ThisKeyFunctor thisKeyFunctor, ResultFunctor resultFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType(), JoinValueType()))>
+{
+	const auto end { std::end(index) };
 
-        if (match == end && !leftJoin) continue;
+	while (gen.move_next())
+	{
+		const auto &value { gen.current_value() };
+		auto match = index.find(thisKeyFunctor(value));
 
-        co_yield resultFunctor(value, join_value);
-    }
+		if (match == end)
+		{
+			if (leftJoin) co_yield resultFunctor(value, JoinValueType());
+
+			continue;
+		}
+
+		for (const auto &join_value : match->second) co_yield resultFunctor(value, join_value);
+	}
+}
+
+template<typename CoroType, typename JoinValueType, typename Index, typename ThisKeyFunctor, typename ResultFunctor>
+auto co_hash_group_join(generator<CoroType> gen, Index index, ThisKeyFunctor thisKeyFunctor, ResultFunctor resultFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType(), default_container<JoinValueType>()))>
+{
+	const default_container<JoinValueType> no_matches;
+	const auto end { std::end(index) };
+
+	while (gen.move_next())
+	{
+		const auto &value { gen.current_value() };
+		auto match = index.find(thisKeyFunctor(value));
+
+		if (match == end && !leftJoin) continue;
+
+		co_yield resultFunctor(value, match == end ? no_matches : match->second);
+	}
 }
 
 template<typename CoroType, typename JoinIterator, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
-auto co_group_join(generator<CoroType> &&gen, JoinIterator begin, JoinIterator end, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType(), default_container<typename JoinIterator::value_type>()))>
+auto co_nested_join(generator<CoroType> gen, JoinIterator begin, JoinIterator end, ThisKeyFunctor thisKeyFunctor, OtherKeyFunctor otherKeyFunctor, ResultFunctor resultFunctor, CompareFunctor compareFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType(), typename JoinIterator::value_type()))>
 {
-    using thisKeyType = typename std::decay<decltype(thisKeyFunctor(CoroType()))>::type;
-    using joinValueType = typename JoinIterator::value_type;
+	using joinValueType = typename JoinIterator::value_type;
 
-    while (gen.move_next())
-    {
-    	default_container<joinValueType> group;
-    	auto value { gen.current_value() };
-        auto thisKey = thisKeyFunctor(value);
+	while (gen.move_next())
+	{
+		const auto &value { gen.current_value() };
+		auto thisKey = thisKeyFunctor(value);
+		bool matched { false };
 
-        auto current { begin };
+		for (auto current { begin }; current != end; ++current)
+		{
+			if (!compareFunctor(thisKey, otherKeyFunctor(*current))) continue;
 
-        while (current != end)
-        {
-        	auto join_value { *current };
+			matched = true;
+
+			co_yield resultFunctor(value, *current);
+		}
 
-        	if (compareFunctor(thisKey, otherKeyFunctor(join_value))) group.emplace_back(join_value);
+		if (!matched && leftJoin) co_yield resultFunctor(value, joinValueType());
+	}
+}
 
-        	++current;
-        }
+template<typename CoroType1, typename CoroType2, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
+auto co_nested_join(generator<CoroType1> gen1, generator<CoroType2> gen2, ThisKeyFunctor thisKeyFunctor, OtherKeyFunctor otherKeyFunctor, ResultFunctor resultFunctor, CompareFunctor compareFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType1(), CoroType2()))>
+{
+	default_container<CoroType2> provided;
+
+	while (gen2.move_next()) provided.push_back(gen2.current_value());
 
-        if (std::empty(group) && !leftJoin) continue;
+	auto joined { co_nested_join(std::move(gen1), std::begin(provided), std::end(provided), std::move(thisKeyFunctor), std::move(otherKeyFunctor), std::move(resultFunctor), std::move(compareFunctor), leftJoin) };
 
-        co_yield resultFunctor(value, group);
-    }
+	while (joined.move_next()) co_yield joined.current_value();
 }
 
-template<typename CoroType1, typename CoroType2, typename JoinIterator, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
-auto co_group_join(generator<CoroType1> &&gen1, generator<CoroType2> &&gen2, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType1(), default_container<CoroType2>()))>
+template<typename CoroType, typename JoinIterator, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
+auto co_nested_group_join(generator<CoroType> gen, JoinIterator begin, JoinIterator end, ThisKeyFunctor thisKeyFunctor, OtherKeyFunctor otherKeyFunctor, ResultFunctor resultFunctor, CompareFunctor compareFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType(), default_container<typename JoinIterator::value_type>()))>
 {
-    using thisKeyType = typename std::decay<decltype(thisKeyFunctor(CoroType1()))>::type;
+	using joinValueType = typename JoinIterator::value_type;
+
+	while (gen.move_next())
+	{
+		default_container<joinValueType> group;
+		const auto &value { gen.current_value() };
+		auto thisKey = thisKeyFunctor(value);
+
+		for (auto current { begin }; current != end; ++current)
+		{
+			if (compareFunctor(thisKey, otherKeyFunctor(*current))) group.emplace_back(*current);
+		}
 
+		if (std::empty(group) && !leftJoin) continue;
+
+		co_yield resultFunctor(value, group);
+	}
+}
+
+template<typename CoroType1, typename CoroType2, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
+auto co_nested_group_join(generator<CoroType1> gen1, generator<CoroType2> gen2, ThisKeyFunctor thisKeyFunctor, OtherKeyFunctor otherKeyFunctor, ResultFunctor resultFunctor, CompareFunctor compareFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType1(), default_container<CoroType2>()))>
+{
 	default_container<CoroType2> provided;
 
 	while (gen2.move_next()) provided.push_back(gen2.current_value());
 
-	auto begin { std::begin(provided) };
-	auto end { std::end(provided) };
+	auto joined { co_nested_group_join(std::move(gen1), std::begin(provided), std::end(provided), std::move(thisKeyFunctor), std::move(otherKeyFunctor), std::move(resultFunctor), std::move(compareFunctor), leftJoin) };
 
-    while (gen1.move_next())
-    {
-    	default_container<CoroType2> group;
-    	auto value { gen1.current_value() };
-        auto thisKey = thisKeyFunctor(value);
+	while (joined.move_next()) co_yield joined.current_value();
+}
 
-        auto current { begin };
+// plain equality on hashable keys probes a key index of the joined sequence, any other comparer falls back to a nested scan
+template<typename CoroType, typename JoinIterator, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
+auto co_join(generator<CoroType> &&gen, JoinIterator begin, JoinIterator end, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin)
+{
+	using joinValueType = typename JoinIterator::value_type;
+	using thisKeyType = typename std::decay<decltype(thisKeyFunctor(CoroType()))>::type;
+	using otherKeyType = typename std::decay<decltype(otherKeyFunctor(joinValueType()))>::type;
 
-        while (current != end)
-        {
-        	auto join_value { *current };
+	if constexpr (HashJoinable<CompareFunctor, thisKeyType, otherKeyType>)
+	{
+		return co_hash_join<CoroType, joinValueType>(std::move(gen), co_index(begin, end, otherKeyFunctor), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<ResultFunctor>(resultFunctor), leftJoin);
+	}
+	else return co_nested_join(std::move(gen), begin, end, std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin);
+}
 
-        	if (compareFunctor(thisKey, otherKeyFunctor(join_value))) group.emplace_back(join_value);
+template<typename CoroType1, typename CoroType2, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
+auto co_join(generator<CoroType1> &&gen1, generator<CoroType2> &&gen2, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin)
+{
+	using thisKeyType = typename std::decay<decltype(thisKeyFunctor(CoroType1()))>::type;
+	using otherKeyType = typename std::decay<decltype(otherKeyFunctor(CoroType2()))>::type;
 
-        	++current;
-        }
+	if constexpr (HashJoinable<CompareFunctor, thisKeyType, otherKeyType>)
+	{
+		return co_hash_join<CoroType1, CoroType2>(std::move(gen1), co_index(std::move(gen2), otherKeyFunctor), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<ResultFunctor>(resultFunctor), leftJoin);
+	}
+	else return co_nested_join(std::move(gen1), std::move(gen2), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin);
+}
 
-        if (std::empty(group) && !leftJoin) continue;
+template<typename CoroType, typename JoinIterator, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
+auto co_group_join(generator<CoroType> &&gen, JoinIterator begin, JoinIterator end, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin)
+{
+	using joinValueType = typename JoinIterator::value_type;
+	using thisKeyType = typename std::decay<decltype(thisKeyFunctor(CoroType()))>::type;
+	using otherKeyType = typename std::decay<decltype(otherKeyFunctor(joinValueType()))>::type;
 
-        co_yield resultFunctor(value, group);
-    }
+	if constexpr (HashJoinable<CompareFunctor, thisKeyType, otherKeyType>)
+	{
+		return co_hash_group_join<CoroType, joinValueType>(std::move(gen), co_index(begin, end, otherKeyFunctor), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<ResultFunctor>(resultFunctor), leftJoin);
+	}
+	else return co_nested_group_join(std::move(gen), begin, end, std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin);
+}
+
+template<typename CoroType1, typename CoroType2, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
+auto co_group_join(generator<CoroType1> &&gen1, generator<CoroType2> &&gen2, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin)
+{
+	using thisKeyType = typename std::decay<decltype(thisKeyFunctor(CoroType1()))>::type;
+	using otherKeyType = typename std::decay<decltype(otherKeyFunctor(CoroType2()))>::type;
+
+	if constexpr (HashJoinable<CompareFunctor, thisKeyType, otherKeyType>)
+	{
+		return co_hash_group_join<CoroType1, CoroType2>(std::move(gen1), co_index(std::move(gen2), otherKeyFunctor), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<ResultFunctor>(resultFunctor), leftJoin);
+	}
+	else return co_nested_group_join(std::move(gen1), std::move(gen2), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin);
+}
+
+// both sequences have to be sorted by key with lessFunctor; only the run of joined elements sharing the current key is kept in memory
+template<typename CoroType1, typename CoroType2, typename ThisKeyFunctor, typename OtherKeyFunctor, typename LessFunctor>
+auto co_merge_runs(generator<CoroType1> gen1, generator<CoroType2> gen2, ThisKeyFunctor thisKeyFunctor, OtherKeyFunctor otherKeyFunctor, LessFunctor lessFunctor) -> generator<std::pair<CoroType1, const default_container<CoroType2>*>>
+{
+	default_container<CoroType2> run;
+	std::optional<CoroType2> pending {};
+
+	auto advance = [&gen2, &pending] { if (gen2.move_next()) pending = gen2.current_value(); else pending.reset(); };
+
+	advance();
+
+	while (gen1.move_next())
+	{
+		const auto &value { gen1.current_value() };
+		auto thisKey = thisKeyFunctor(value);
+
+		if (std::empty(run) || lessFunctor(otherKeyFunctor(run.front()), thisKey))
+		{
+			run.clear();
+
+			while (pending && lessFunctor(otherKeyFunctor(*pending), thisKey)) advance();
+			while (pending && !lessFunctor(thisKey, otherKeyFunctor(*pending))) { run.push_back(*pending); advance(); }
+		}
+
+		// the run stays untouched until the consumer resumes this generator
+		co_yield std::make_pair(value, &run);
+	}
+}
+
+template<typename CoroType1, typename CoroType2, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename LessFunctor>
+auto co_merge_join(generator<CoroType1> gen1, generator<CoroType2> gen2, ThisKeyFunctor thisKeyFunctor, OtherKeyFunctor otherKeyFunctor, ResultFunctor resultFunctor, LessFunctor lessFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType1(), CoroType2()))>
+{
+	auto runs { co_merge_runs(std::move(gen1), std::move(gen2), std::move(thisKeyFunctor), std::move(otherKeyFunctor), std::move(lessFunctor)) };
+
+	while (runs.move_next())
+	{
+		const auto [value, run] { runs.current_value() };
+
+		if (std::empty(*run))
+		{
+			if (leftJoin) co_yield resultFunctor(value, CoroType2());
+
+			continue;
+		}
+
+		for (const auto &join_value : *run) co_yield resultFunctor(value, join_value);
+	}
+}
+
+template<typename CoroType1, typename CoroType2, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename LessFunctor>
+auto co_merge_group_join(generator<CoroType1> gen1, generator<CoroType2> gen2, ThisKeyFunctor thisKeyFunctor, OtherKeyFunctor otherKeyFunctor, ResultFunctor resultFunctor, LessFunctor lessFunctor, bool leftJoin) -> generator<decltype(resultFunctor(CoroType1(), default_container<CoroType2>()))>
+{
+	auto runs { co_merge_runs(std::move(gen1), std::move(gen2), std::move(thisKeyFunctor), std::move(otherKeyFunctor), std::move(lessFunctor)) };
+
+	while (runs.move_next())
+	{
+		const auto [value, run] { runs.current_value() };
+
+		if (std::empty(*run) && !leftJoin) continue;
+
+		co_yield resultFunctor(value, *run);
+	}
 }
 
 template<typename CoroType, typename Functor>
-auto co_group(generator<CoroType> &&gen, Functor func) -> generator<std::pair<decltype(func(CoroType())), default_container<CoroType>>>
+auto co_group(generator<CoroType> gen, Functor func) -> generator<std::pair<decltype(func(CoroType())), default_container<CoroType>>>
 {
 	default_map<decltype(func(CoroType())), default_container<CoroType>> groups;
 
 	while (gen.move_next())
 	{
-		auto value { gen.current_value() };
+		const auto &value { gen.current_value() };
 
 		groups[func(value)].push_back(value);
 	}
@@ -632,6 +904,9 @@ public:
 
 	friend class iterator;
 
+	template<typename>
+	friend class co_relinx_object;
+
 	class iterator
 	{
 	public:
@@ -640,7 +915,7 @@ public:
 	    using difference_type = std::ptrdiff_t;
 	    using pointer = const value_type*;
 	    using reference = const value_type&;
-	    using iterator_category = std::forward_iterator_tag;
+	    using iterator_category = std::input_iterator_tag;
 
 	    iterator() = default;
 	    iterator(const self_type &) = default;
@@ -669,7 +944,7 @@ public:
 	        return !(*this == s);
 	    }
 
-	    auto operator*() const -> const value_type
+	    auto operator*() const -> const value_type&
 	    {
 	        return _co_relinx_object->current_value();
 	    }
@@ -818,19 +1093,37 @@ public:
     template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
     auto join(Container &container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin = false)
     {
-    	return co_relinx_object<decltype(resultFunctor(thisKeyFunctor(CoroType()), otherKeyFunctor(typename Container::value_type())))>(co_join(std::move(_generator), std::begin(container), std::end(container), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
+    	return co_relinx_object<decltype(resultFunctor(CoroType(), typename std::decay<Container>::type::value_type()))>(co_join(std::move(_generator), std::begin(container), std::end(container), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
     }
 
     template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
     auto join(Container &&container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin = false)
     {
-    	return co_relinx_object<decltype(resultFunctor(thisKeyFunctor(CoroType()), otherKeyFunctor(typename Container::value_type())))>(co_join(std::move(_generator), co_from(std::forward<Container>(container)), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
+    	return co_relinx_object<decltype(resultFunctor(CoroType(), typename std::decay<Container>::type::value_type()))>(co_join(std::move(_generator), co_from(std::forward<Container>(container)), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
     }
 
     template<typename CoroType1, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
     auto join(std::initializer_list<CoroType1> &&container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin = false)
     {
-    	return co_relinx_object<decltype(resultFunctor(thisKeyFunctor(CoroType()), otherKeyFunctor(CoroType1())))>(co_join(std::move(_generator), co_from(std::forward<std::initializer_list<CoroType1>>(container)), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
+    	return co_relinx_object<decltype(resultFunctor(CoroType(), CoroType1()))>(co_join(std::move(_generator), co_from(std::forward<std::initializer_list<CoroType1>>(container)), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
+    }
+
+    template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor>
+    auto join(Container &container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false)
+    {
+    	return join(container, std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::equal_to<> {}, leftJoin);
+    }
+
+    template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor>
+    auto join(Container &&container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false)
+    {
+    	return join(std::forward<Container>(container), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::equal_to<> {}, leftJoin);
+    }
+
+    template<typename CoroType1, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor>
+    auto join(std::initializer_list<CoroType1> &&container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false)
+    {
+    	return join(std::forward<std::initializer_list<CoroType1>>(container), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::equal_to<> {}, leftJoin);
     }
 
     template<typename ForeachFunctor>
@@ -867,7 +1160,7 @@ public:
     template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
     auto group_join(Container &&container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, CompareFunctor &&compareFunctor, bool leftJoin = false)
     {
-    	return co_relinx_object<decltype(resultFunctor(CoroType(), default_container<typename Container::value_type>()))>(co_group_join(std::move(_generator), co_from<Container>(std::forward<Container>(container)), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
+    	return co_relinx_object<decltype(resultFunctor(CoroType(), default_container<typename std::decay<Container>::type::value_type>()))>(co_group_join(std::move(_generator), co_from(std::forward<Container>(container)), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
     }
 
     template<typename CoroType1, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
@@ -876,6 +1169,49 @@ public:
     	return co_relinx_object<decltype(resultFunctor(CoroType(), default_container<CoroType1>()))>(co_group_join(std::move(_generator), co_from(std::forward<std::initializer_list<CoroType1>>(container)), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::forward<CompareFunctor>(compareFunctor), leftJoin));
     }
 
+    template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor>
+    auto group_join(Container &container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false)
+    {
+    	return group_join(container, std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::equal_to<> {}, leftJoin);
+    }
+
+    template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor>
+    auto group_join(Container &&container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false)
+    {
+    	return group_join(std::forward<Container>(container), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::equal_to<> {}, leftJoin);
+    }
+
+    template<typename CoroType1, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor>
+    auto group_join(std::initializer_list<CoroType1> &&container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false)
+    {
+    	return group_join(std::forward<std::initializer_list<CoroType1>>(container), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::equal_to<> {}, leftJoin);
+    }
+
+    // sort-merge joins expect both sequences ordered by key and never materialize either of them
+    template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename LessFunctor = std::less<>>
+    auto merge_join(Container &container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false, LessFunctor lessFunctor = {})
+    {
+    	return co_relinx_object<decltype(resultFunctor(CoroType(), typename Container::value_type()))>(co_merge_join(std::move(_generator), co_from(container), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::move(lessFunctor), leftJoin));
+    }
+
+    template<typename CoroType1, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename LessFunctor = std::less<>>
+    auto merge_join(co_relinx_object<CoroType1> &&other, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false, LessFunctor lessFunctor = {})
+    {
+    	return co_relinx_object<decltype(resultFunctor(CoroType(), CoroType1()))>(co_merge_join(std::move(_generator), std::move(other._generator), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::move(lessFunctor), leftJoin));
+    }
+
+    template<typename Container, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename LessFunctor = std::less<>>
+    auto merge_group_join(Container &container, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false, LessFunctor lessFunctor = {})
+    {
+    	return co_relinx_object<decltype(resultFunctor(CoroType(), default_container<typename Container::value_type>()))>(co_merge_group_join(std::move(_generator), co_from(container), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::move(lessFunctor), leftJoin));
+    }
+
+    template<typename CoroType1, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename LessFunctor = std::less<>>
+    auto merge_group_join(co_relinx_object<CoroType1> &&other, ThisKeyFunctor &&thisKeyFunctor, OtherKeyFunctor &&otherKeyFunctor, ResultFunctor &&resultFunctor, bool leftJoin = false, LessFunctor lessFunctor = {})
+    {
+    	return co_relinx_object<decltype(resultFunctor(CoroType(), default_container<CoroType1>()))>(co_merge_group_join(std::move(_generator), std::move(other._generator), std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), std::move(lessFunctor), leftJoin));
+    }
+
     auto reverse()
     {
     	return co_relinx_object<CoroType>(co_reverse(std::move(_generator)));
@@ -1172,7 +1508,7 @@ private:
 		return *_moved;
 	}
 
-	CoroType current_value()
+	const CoroType &current_value() const
 	{
 		return _generator.current_value();
 	}
@@ -20,18 +20,161 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "signal_slot.hpp"
+#include "thread_pool.hpp"
 
 namespace nstd
 {
 using namespace std::chrono_literals;
 
+enum class eviction_policy
+{
+    lru,
+    segmented_lru,
+    tiny_lfu
+};
+
+struct cache_statistics
+{
+    uint64_t hits { 0 };
+    uint64_t misses { 0 };
+    // get_or_load() lookups answered by a remembered empty load; they count neither as hits nor as misses
+    uint64_t negative_hits { 0 };
+    uint64_t evictions { 0 };
+    uint64_t expirations { 0 };
+    uint64_t loads { 0 };
+    uint64_t load_failures { 0 };
+    uint64_t refreshes { 0 };
+    std::chrono::nanoseconds load_time { 0 };
+
+    double hit_ratio() const
+    {
+        auto requests { hits + misses };
+
+        return requests ? static_cast<double>(hits) / requests : 0.0;
+    }
+
+    std::chrono::nanoseconds average_load_time() const
+    {
+        auto attempts { loads + load_failures };
+
+        return attempts ? load_time / static_cast<int64_t>(attempts) : std::chrono::nanoseconds { 0 };
+    }
+};
+
+// count-min sketch of 4-bit counters estimating how often a key was seen recently;
+// all counters are halved once the sample count reaches ten times the width, so old popularity fades
+class frequency_sketch
+{
+public:
+    // widening keeps what was counted: in every row a key lands on the same counter modulo the old width,
+    // so each old counter is copied to all of its positions in the wider row
+    void ensure_capacity(size_t entries)
+    {
+        auto width { std::bit_ceil(std::max<size_t>(entries, 16)) };
+
+        if (width <= _width) return;
+
+        std::vector<uint64_t> table(width * _depth / 16, 0);
+
+        if (_width)
+            for (size_t row { 0 }; row < _depth; ++row)
+                for (size_t counter { 0 }; counter < width; ++counter)
+                {
+                    auto from { row * _width + (counter & (_width - 1)) }, to { row * width + counter };
+
+                    table[to / 16] |= ((_table[from / 16] >> (from % 16 * 4)) & 0xF) << (to % 16 * 4);
+                }
+
+        _width = width;
+        _table.swap(table);
+    }
+
+    void increment(size_t hash)
+    {
+        if (!_width) return;
+
+        bool added { false };
+
+        for (size_t row { 0 }; row < _depth; ++row)
+        {
+            auto [word, shift] { locate(hash, row) };
+
+            if (((_table[word] >> shift) & 0xF) != 0xF)
+            {
+                _table[word] += uint64_t { 1 } << shift;
+                added = true;
+            }
+        }
+
+        if (added && ++_samples >= 10 * _width) halve();
+    }
+
+    uint32_t frequency(size_t hash) const
+    {
+        if (!_width) return 0;
+
+        uint32_t result { 0xF };
+
+        for (size_t row { 0 }; row < _depth; ++row)
+        {
+            auto [word, shift] { locate(hash, row) };
+
+            result = std::min(result, static_cast<uint32_t>((_table[word] >> shift) & 0xF));
+        }
+
+        return result;
+    }
+
+    void clear()
+    {
+        std::fill(std::begin(_table), std::end(_table), 0);
+        _samples = 0;
+    }
+
+private:
+    static constexpr size_t _depth { 4 };
+    static constexpr uint64_t _seeds[_depth] { 0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull };
+
+    size_t _width { 0 }, _samples { 0 };
+    std::vector<uint64_t> _table {};
+
+    // every row owns _width counters, sixteen of them packed into a word
+    std::pair<size_t, unsigned> locate(size_t hash, size_t row) const
+    {
+        auto mixed { (static_cast<uint64_t>(hash) + row) * _seeds[row] };
+        auto counter { (mixed >> 32) & (_width - 1) };
+        auto index { row * _width + counter };
+
+        return { index / 16, static_cast<unsigned>((index % 16) * 4) };
+    }
+
+    void halve()
+    {
+        for (auto &word : _table) word = (word >> 1) & 0x7777777777777777ull;
+
+        _samples /= 2;
+    }
+};
+
 template<typename key_type, typename value_type>
 class expiry_cache
 {
@@ -39,9 +182,21 @@ public:
     using self_type = expiry_cache<key_type, value_type>;
     using time_point_type = std::chrono::time_point<std::chrono::high_resolution_clock>;
     using data_type = std::tuple<time_point_type, std::chrono::milliseconds, value_type>;
+    using weigher_type = std::function<size_t(const key_type &, const value_type &)>;
 
     expiry_cache() = default;
-    ~expiry_cache() { stop_auto_vacuum(); }
+    // refreshes still queued on the pool find the cache detached and do nothing, only the ones running right now are
+    // waited for, so the cache may be released on a pool thread; it must not be destroyed from its own loader
+    ~expiry_cache()
+    {
+        stop_auto_vacuum();
+
+        std::unique_lock lock {_refresh_state->lock};
+
+        _refresh_state->cache = nullptr;
+
+        _refresh_state->idle.wait(lock, [this] { return _refresh_state->running == 0; });
+    }
 
     template<typename duration_type>
     expiry_cache(const duration_type &duration)
@@ -54,13 +209,105 @@ public:
     {
         std::scoped_lock lock {_mutex};
 
-        auto it{ _data.find(key) };
+        _negative.erase(key);
 
-        if (it != std::end(_data)) _erase(it);
+        _put(key, value, std::chrono::duration_cast<std::chrono::milliseconds>(duration));
+    }
 
-        auto expiry_duration_ms { std::chrono::duration_cast<std::chrono::milliseconds>(duration) };
+    // read-through lookup: concurrent misses on a key share one call of the loader, which runs on the thread that
+    // missed first; the loader returns a value_type or a std::optional<value_type>, an empty result is remembered for
+    // the negative expiry, and an exception thrown by the loader reaches every caller waiting for that load;
+    // with refresh-ahead enabled a copy of the loader runs later on the pool, so it must own what it captures
+    template<typename loader_type>
+    std::optional<value_type> get_or_load(const key_type &key, loader_type &&loader)
+    {
+        std::unique_lock lock {_mutex};
+        auto now{ std::chrono::high_resolution_clock::now() };
+
+        if (auto it{ _data.find(key) }; it != std::end(_data))
+        {
+            auto &val = it->second.data;
+            auto age { std::chrono::duration_cast<std::chrono::milliseconds>(now - std::get<0>(val)) };
+
+            if (age <= std::get<1>(val))
+            {
+                std::optional<value_type> value { std::get<2>(val) };
+
+                if (_access_prolongs.load(std::memory_order_relaxed)) std::get<0>(val) = now;
+
+                if (_capacity) _access(*it);
+
+                ++_statistics.hits;
+
+                if (_refresh_ahead > 0ms && std::get<1>(val) - age < _refresh_ahead && !_loads.contains(key)) _refresh(key, loader, lock);
+
+                return value;
+            }
+
+            ++_statistics.expirations;
+
+            _erase(it);
+        }
+
+        if (auto it{ _negative.find(key) }; it != std::end(_negative))
+        {
+            if (now < it->second)
+            {
+                ++_statistics.negative_hits;
+
+                return std::nullopt;
+            }
+
+            _negative.erase(it);
+        }
+
+        ++_statistics.misses;
+
+        if (auto it{ _loads.find(key) }; it != std::end(_loads))
+        {
+            auto pending { it->second };
+
+            lock.unlock();
+
+            return pending.get();
+        }
 
-        _data.emplace(key, std::make_tuple(std::chrono::high_resolution_clock::now(), (expiry_duration_ms == 0ms) ? _expiry_duration_ms.load(std::memory_order_relaxed) : expiry_duration_ms, value));
+        std::promise<std::optional<value_type>> promise;
+
+        _loads.emplace(key, promise.get_future().share());
+
+        lock.unlock();
+
+        return _load(key, loader, promise);
+    }
+
+    // get_or_load() reloads an entry in the background once less than lead_time is left until it expires;
+    // readers keep getting the current value meanwhile, a failed reload leaves it in place, and a reload keeps
+    // the expiry the entry was put with
+    template<typename duration_type>
+    void set_refresh_ahead(const duration_type &lead_time, nstd::thread_pool &pool = nstd::global_thread_pool::get_thread_pool())
+    {
+        std::scoped_lock lock {_mutex};
+
+        _refresh_ahead = std::chrono::duration_cast<std::chrono::milliseconds>(lead_time);
+        _refresh_pool = &pool;
+    }
+
+    template<typename duration_type>
+    void set_negative_expiry(const duration_type &duration)
+    {
+        std::scoped_lock lock {_mutex};
+
+        _negative_expiry = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
+
+        if (_negative_expiry == 0ms) _negative.clear();
+    }
+
+    std::chrono::milliseconds get_negative_expiry() const
+    {
+        std::scoped_lock lock {_mutex};
+
+        return _negative_expiry;
     }
 
     bool exists(const key_type &key)
@@ -76,7 +323,7 @@ public:
 
         auto it{ _data.find(key) };
 
-        if (it != std::end(_data) && (_access_prolongs.load(std::memory_order_relaxed) || force_touch)) std::get<0>(it->second) = std::chrono::high_resolution_clock::now();
+        if (it != std::end(_data) && (_access_prolongs.load(std::memory_order_relaxed) || force_touch)) std::get<0>(it->second.data) = std::chrono::high_resolution_clock::now();
     }
 
     bool get(const key_type &key, value_type &value)
@@ -87,11 +334,14 @@ public:
 
         if (it != std::end(_data))
         {
-            auto &val = it->second;
+            auto &val = it->second.data;
             auto now{ std::chrono::high_resolution_clock::now() };
 
             if (!_auto_vacuum && std::chrono::duration_cast<std::chrono::milliseconds>(now - std::get<0>(val)) > std::get<1>(val))
             {
+                ++_statistics.expirations;
+                ++_statistics.misses;
+
                 _erase(it);
 
                 return false;
@@ -101,9 +351,17 @@ public:
 
             if (_access_prolongs.load(std::memory_order_relaxed)) std::get<0>(val) = now;
 
+            if (_capacity) _access(*it);
+
+            ++_statistics.hits;
+
             return true;
         }
 
+        if (_capacity && _policy == eviction_policy::tiny_lfu) _sketch.increment(_hash(key));
+
+        ++_statistics.misses;
+
         return false;
     }
 
@@ -130,7 +388,7 @@ public:
 
         auto it{ _data.find(key) };
 
-        if (it != std::end(_data)) std::get<1>(it->second) = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
+        if (it != std::end(_data)) std::get<1>(it->second.data) = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
     }
 
     const std::chrono::milliseconds get_expiry() const
@@ -144,16 +402,103 @@ public:
 
         auto it{ _data.find(key) };
 
-        if (it != std::end(_data)) return std::get<1>(it->second);
+        if (it != std::end(_data)) return std::get<1>(it->second.data);
 
         return _expiry_duration_ms.load(std::memory_order_relaxed);
     }
 
+    // bounds the total weight of the entries, zero means unbounded; without a weigher every entry weighs 1,
+    // so the capacity is an entry count
+    void set_capacity(size_t capacity)
+    {
+        std::scoped_lock lock {_mutex};
+
+        if (!_capacity && capacity)
+        {
+            _capacity = capacity;
+
+            for (auto &node : _data) _admit(node);
+        }
+        else if (!capacity)
+        {
+            for (auto &list : _segments) list.clear();
+
+            _segment_weights = {};
+            _sketch = {};
+        }
+
+        _capacity = capacity;
+
+        _size_sketch();
+
+        if (_capacity) _evict();
+    }
+
+    size_t get_capacity() const
+    {
+        std::scoped_lock lock {_mutex};
+
+        return _capacity;
+    }
+
+    // the weight of an entry is taken when it is put, so a new weigher applies to the entries put afterwards
+    void set_weigher(const weigher_type &weigher)
+    {
+        std::scoped_lock lock {_mutex};
+
+        _weigher = weigher;
+    }
+
+    size_t weight() const
+    {
+        std::scoped_lock lock {_mutex};
+
+        return _segment_weights[0] + _segment_weights[1] + _segment_weights[2];
+    }
+
+    // takes effect for a cache that is empty or not bounded yet
+    void set_eviction_policy(eviction_policy policy)
+    {
+        std::scoped_lock lock {_mutex};
+
+        if (_capacity && !std::empty(_data)) return;
+
+        _policy = policy;
+
+        _size_sketch();
+    }
+
+    eviction_policy get_eviction_policy() const
+    {
+        std::scoped_lock lock {_mutex};
+
+        return _policy;
+    }
+
+    cache_statistics statistics() const
+    {
+        std::scoped_lock lock {_mutex};
+
+        return _statistics;
+    }
+
+    void reset_statistics()
+    {
+        std::scoped_lock lock {_mutex};
+
+        _statistics = {};
+    }
+
     void clear()
     {
         std::scoped_lock lock {_mutex};
 
         _data.clear();
+        _negative.clear();
+
+        for (auto &list : _segments) list.clear();
+
+        _segment_weights = {};
     }
 
     size_t size() const
@@ -171,13 +516,17 @@ public:
 
         for (auto it{ std::begin(_data) }, end{std::end(_data)}; it != end; ++it)
         {
-            const auto &val = it->second;
+            const auto &val = it->second.data;
 
             if (std::chrono::duration_cast<std::chrono::milliseconds>(now - std::get<0>(val)) > std::get<1>(val))
                 expired.emplace_back(it);
         }
 
+        _statistics.expirations += std::size(expired);
+
         for (auto &it : expired) _erase(it);
+
+        std::erase_if(_negative, [&now](const auto &negative) { return negative.second <= now; });
     }
 
     template<typename duration_type>
@@ -220,46 +569,833 @@ public:
     }
 
     nstd::signal_slot::signal<const key_type &, value_type &> signal_data_expired {};
+    // entries dropped to stay within the capacity; a value that owns resources has to be released here as well
+    nstd::signal_slot::signal<const key_type &, value_type &> signal_data_evicted {};
 
 private:
-    std::unordered_map<key_type, data_type> _data {};
+    // window, probation and protected segments; lru keeps everything in probation, segmented_lru adds the protected
+    // segment, and tiny_lfu puts a small lru window in front of the segmented main space
+    enum segment : uint8_t { window_segment, probation_segment, protected_segment };
 
-    void _auto_vacuum_procedure()
+    struct entry;
+    using node_type = std::pair<const key_type, entry>;
+    using node_list = std::list<node_type*>;
+
+    struct entry
     {
-        auto time{ std::chrono::high_resolution_clock::now() };
+        data_type data;
+        size_t weight { 1 };
+        segment where { probation_segment };
+        typename node_list::iterator position {};
+    };
 
-        while (!_cancel_auto_vacuum.load(std::memory_order_relaxed))
+    using load_result_type = std::optional<value_type>;
+
+    // shared by the cache and its refresh jobs; the cache detaches itself from it when it is destroyed
+    struct refresh_state
+    {
+        explicit refresh_state(self_type *c) : cache { c } {}
+
+        std::mutex lock {};
+        std::condition_variable idle {};
+        self_type *cache;
+        size_t running { 0 };
+    };
+
+    std::unordered_map<key_type, entry> _data {};
+    std::unordered_map<key_type, std::shared_future<load_result_type>> _loads {};
+    std::unordered_map<key_type, time_point_type> _negative {};
+
+    void _put(const key_type &key, const value_type &value, std::chrono::milliseconds expiry_duration_ms)
+    {
+        auto it{ _data.find(key) };
+
+        if (it != std::end(_data)) _erase(it);
+
+        it = _data.emplace(key, entry { std::make_tuple(std::chrono::high_resolution_clock::now(), (expiry_duration_ms == 0ms) ? _expiry_duration_ms.load(std::memory_order_relaxed) : expiry_duration_ms, value) }).first;
+
+        if (_capacity)
         {
+            _admit(*it);
+            _evict();
+        }
+    }
+
+    template<typename loader_type>
+    load_result_type _load(const key_type &key, loader_type &loader, std::promise<load_result_type> &promise)
+    {
+        auto start{ std::chrono::high_resolution_clock::now() };
+        load_result_type result {};
+
+        try
+        {
+            result = loader(key);
+        }
+        catch (...)
+        {
+            {
+                std::scoped_lock lock {_mutex};
+
+                _loads.erase(key);
+
+                ++_statistics.load_failures;
+                _statistics.load_time += std::chrono::high_resolution_clock::now() - start;
+            }
+
+            promise.set_exception(std::current_exception());
+
+            throw;
+        }
+
+        {
+            std::scoped_lock lock {_mutex};
             auto now{ std::chrono::high_resolution_clock::now() };
 
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(now - time) > _vacuum_idle_period_ms.load(std::memory_order_relaxed))
+            if (result) _reload(key, *result);
+            else
             {
-                time = now;
+                if (auto it{ _data.find(key) }; it != std::end(_data)) _erase(it);
 
-                vacuum();
+                if (_negative_expiry > 0ms) _negative.insert_or_assign(key, now + _negative_expiry);
             }
 
-            if (_cancel_auto_vacuum.load(std::memory_order_relaxed)) return;
+            _loads.erase(key);
 
-            std::this_thread::sleep_for(100ms);
+            ++_statistics.loads;
+            _statistics.load_time += now - start;
         }
+
+        promise.set_value(result);
+
+        return result;
     }
 
-    void _erase(decltype(std::begin(_data)) &it)
+    // a reloaded entry keeps its expiry and its place in the eviction order, and the value it replaces is not reported as expired
+    void _reload(const key_type &key, const value_type &value)
     {
-        auto &val = it->second;
+        auto it{ _data.find(key) };
 
-        signal_data_expired.emit(it->first, std::get<2>(val));
+        if (it == std::end(_data))
+        {
+            _put(key, value, 0ms);
 
-        _data.erase(it);
+            return;
+        }
+
+        auto &val = it->second.data;
+
+        std::get<0>(val) = std::chrono::high_resolution_clock::now();
+        std::get<2>(val) = value;
+
+        if (_capacity)
+        {
+            auto where { it->second.where };
+
+            _unlink(*it);
+
+            it->second.weight = _weigher ? _weigher(it->first, value) : 1;
+
+            _link(*it, where);
+            _evict();
+        }
     }
 
-    std::atomic<std::chrono::milliseconds> _expiry_duration_ms { 10min };
-    std::atomic<std::chrono::milliseconds> _vacuum_idle_period_ms { 1min };
-    std::atomic_bool _access_prolongs { false };
-    std::atomic_bool _auto_vacuum { false };
-    std::atomic_bool _cancel_auto_vacuum { false };
-    std::thread _auto_vacuum_thread {};
-    mutable std::mutex _mutex {};
+    // called under the lock, which is released before posting since the job takes it when it is destroyed;
+    // the job unregisters the load even if the pool drops it without running it, and holds the refresh state
+    // rather than the cache, so it may outlive the cache
+    template<typename loader_type>
+    void _refresh(const key_type &key, const loader_type &loader, std::unique_lock<std::mutex> &lock)
+    {
+        struct refresh_job
+        {
+            std::shared_ptr<refresh_state> state;
+            key_type key;
+            std::decay_t<loader_type> loader;
+            std::promise<load_result_type> promise {};
+            bool done { false };
+
+            refresh_job(const std::shared_ptr<refresh_state> &s, const key_type &k, const loader_type &l) : state { s }, key { k }, loader { l } {}
+            refresh_job(refresh_job &&other) = default;
+
+            void operator()()
+            {
+                self_type *cache { nullptr };
+
+                {
+                    std::scoped_lock lock {state->lock};
+
+                    if (!state->cache) return;
+
+                    cache = state->cache;
+                    ++state->running;
+                }
+
+                done = true;
+
+                try
+                {
+                    cache->_load(key, loader, promise);
+                }
+                catch (...)
+                {
+                }
+
+                {
+                    std::scoped_lock lock {state->lock};
+
+                    --state->running;
+                }
+
+                state->idle.notify_all();
+            }
+
+            ~refresh_job()
+            {
+                if (!state || done) return;
+
+                std::scoped_lock lock {state->lock};
+
+                if (!state->cache) return;
+
+                std::scoped_lock cache_lock {state->cache->_mutex};
+
+                state->cache->_loads.erase(key);
+            }
+        };
+
+        refresh_job job { _refresh_state, key, loader };
+
+        _loads.emplace(key, job.promise.get_future().share());
+
+        ++_statistics.refreshes;
+
+        auto pool { _refresh_pool };
+
+        lock.unlock();
+
+        // a refresh the pool cannot take is dropped, the next hit close to the expiry tries again
+        try
+        {
+            pool->post(std::move(job));
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void _auto_vacuum_procedure()
+    {
+        auto time{ std::chrono::high_resolution_clock::now() };
+
+        while (!_cancel_auto_vacuum.load(std::memory_order_relaxed))
+        {
+            auto now{ std::chrono::high_resolution_clock::now() };
+
+            if (std::chrono::duration_cast<std::chrono::milliseconds>(now - time) > _vacuum_idle_period_ms.load(std::memory_order_relaxed))
+            {
+                time = now;
+
+                vacuum();
+            }
+
+            if (_cancel_auto_vacuum.load(std::memory_order_relaxed)) return;
+
+            std::this_thread::sleep_for(100ms);
+        }
+    }
+
+    void _erase(decltype(std::begin(_data)) &it)
+    {
+        auto &val = it->second.data;
+
+        signal_data_expired.emit(it->first, std::get<2>(val));
+
+        if (_capacity) _unlink(*it);
+
+        _data.erase(it);
+    }
+
+    static size_t _hash(const key_type &key)
+    {
+        return std::hash<key_type> {}(key);
+    }
+
+    size_t _window_limit() const
+    {
+        return _policy == eviction_policy::tiny_lfu ? std::max<size_t>(_capacity / 100, 1) : 0;
+    }
+
+    size_t _protected_limit() const
+    {
+        return (_capacity - _window_limit()) * 4 / 5;
+    }
+
+    void _link(node_type &node, segment where)
+    {
+        auto &e { node.second };
+
+        e.where = where;
+        e.position = _segments[where].insert(std::begin(_segments[where]), &node);
+        _segment_weights[where] += e.weight;
+    }
+
+    void _unlink(node_type &node)
+    {
+        auto &e { node.second };
+
+        _segments[e.where].erase(e.position);
+        _segment_weights[e.where] -= e.weight;
+    }
+
+    // without a weigher the capacity is the entry count, so the sketch gets its final width up front;
+    // weighted entries have no known count, their sketch widens as the map grows
+    void _size_sketch()
+    {
+        if (_capacity && _policy == eviction_policy::tiny_lfu && !_weigher) _sketch.ensure_capacity(_capacity);
+    }
+
+    void _admit(node_type &node)
+    {
+        node.second.weight = _weigher ? _weigher(node.first, std::get<2>(node.second.data)) : 1;
+
+        if (_policy == eviction_policy::tiny_lfu)
+        {
+            _sketch.ensure_capacity(std::size(_data));
+            _sketch.increment(_hash(node.first));
+
+            _link(node, window_segment);
+        }
+        else _link(node, probation_segment);
+    }
+
+    void _access(node_type &node)
+    {
+        auto &e { node.second };
+
+        if (_policy == eviction_policy::tiny_lfu) _sketch.increment(_hash(node.first));
+
+        if (_policy == eviction_policy::lru || e.where != probation_segment)
+        {
+            _segments[e.where].splice(std::begin(_segments[e.where]), _segments[e.where], e.position);
+
+            return;
+        }
+
+        // a second hit promotes a probation entry, and the protected overflow is demoted back to probation
+        _unlink(node);
+        _link(node, protected_segment);
+
+        while (_segment_weights[protected_segment] > _protected_limit() && std::size(_segments[protected_segment]) > 1)
+        {
+            auto demoted { _segments[protected_segment].back() };
+
+            _unlink(*demoted);
+            _link(*demoted, probation_segment);
+        }
+    }
+
+    void _evict_node(node_type *node)
+    {
+        ++_statistics.evictions;
+
+        signal_data_evicted.emit(node->first, std::get<2>(node->second.data));
+
+        _unlink(*node);
+        _data.erase(_data.find(node->first));
+    }
+
+    void _evict()
+    {
+        if (_policy == eviction_policy::tiny_lfu)
+        {
+            auto &window { _segments[window_segment] };
+            auto &probation { _segments[probation_segment] };
+            auto main_limit { _capacity - _window_limit() };
+
+            // the window victim enters the main space only if it is estimated to be more popular than the main victim
+            while (_segment_weights[window_segment] > _window_limit() && !std::empty(window))
+            {
+                auto candidate { window.back() };
+
+                if (_segment_weights[probation_segment] + _segment_weights[protected_segment] + candidate->second.weight > main_limit && !std::empty(probation))
+                {
+                    auto victim { probation.back() };
+
+                    if (_sketch.frequency(_hash(candidate->first)) <= _sketch.frequency(_hash(victim->first)))
+                    {
+                        _evict_node(candidate);
+
+                        continue;
+                    }
+
+                    _evict_node(victim);
+                }
+
+                _unlink(*candidate);
+                _link(*candidate, probation_segment);
+            }
+        }
+
+        while (_segment_weights[0] + _segment_weights[1] + _segment_weights[2] > _capacity)
+        {
+            auto &victims { !std::empty(_segments[probation_segment]) ? _segments[probation_segment] : !std::empty(_segments[protected_segment]) ? _segments[protected_segment] : _segments[window_segment] };
+
+            if (std::empty(victims)) break;
+
+            _evict_node(victims.back());
+        }
+    }
+
+    std::atomic<std::chrono::milliseconds> _expiry_duration_ms { 10min };
+    std::atomic<std::chrono::milliseconds> _vacuum_idle_period_ms { 1min };
+    std::atomic_bool _access_prolongs { false };
+    std::atomic_bool _auto_vacuum { false };
+    std::atomic_bool _cancel_auto_vacuum { false };
+    std::thread _auto_vacuum_thread {};
+    mutable std::mutex _mutex {};
+    size_t _capacity { 0 };
+    eviction_policy _policy { eviction_policy::lru };
+    weigher_type _weigher {};
+    std::array<node_list, 3> _segments {};
+    std::array<size_t, 3> _segment_weights {};
+    frequency_sketch _sketch {};
+    cache_statistics _statistics {};
+    std::chrono::milliseconds _negative_expiry { 0ms }, _refresh_ahead { 0ms };
+    nstd::thread_pool *_refresh_pool { nullptr };
+    std::shared_ptr<refresh_state> _refresh_state { std::make_shared<refresh_state>(this) };
+};
+
+// expiry_cache spread over lock-striped shards: lookups take a shared lock only, and every shard keeps a min-heap
+// of deadlines so that vacuum() touches just the entries that are due instead of scanning the whole map
+template<typename key_type, typename value_type, typename hasher_type = std::hash<key_type>>
+class sharded_expiry_cache
+{
+public:
+    using self_type = sharded_expiry_cache<key_type, value_type, hasher_type>;
+    using clock_type = std::chrono::steady_clock;
+
+    explicit sharded_expiry_cache(size_t shard_count = default_shard_count()) :
+        _shard_count { std::bit_ceil(std::max<size_t>(shard_count, 1)) },
+        _shard_shift { static_cast<int>(64 - std::countr_zero(_shard_count)) },
+        _shards { std::make_unique<shard[]>(_shard_count) }
+    {
+    }
+
+    template<typename duration_type>
+    requires requires (const duration_type &duration) { std::chrono::duration_cast<std::chrono::milliseconds>(duration); }
+    sharded_expiry_cache(const duration_type &duration, size_t shard_count = default_shard_count()) : sharded_expiry_cache { shard_count }
+    {
+        set_expiry(duration);
+    }
+
+    ~sharded_expiry_cache() { stop_auto_vacuum(); }
+
+    sharded_expiry_cache(const sharded_expiry_cache &) = delete;
+    sharded_expiry_cache &operator=(const sharded_expiry_cache &) = delete;
+
+    template<typename duration_type = std::chrono::milliseconds>
+    void put(const key_type &key, const value_type &value, const duration_type &duration = 0ms)
+    {
+        auto expiry_duration_ms { std::chrono::duration_cast<std::chrono::milliseconds>(duration) };
+
+        if (expiry_duration_ms == 0ms) expiry_duration_ms = _expiry_duration_ms.load(std::memory_order_relaxed);
+
+        auto &s { shard_for(key) };
+        auto now { now_ticks() };
+        std::optional<value_type> replaced {};
+
+        {
+            std::scoped_lock lock { s.lock };
+
+            auto it { s.data.find(key) };
+
+            if (it != std::end(s.data))
+            {
+                replaced.emplace(std::move(it->second.value));
+
+                s.data.erase(it);
+            }
+
+            auto generation { ++s.generation };
+            auto &e { s.data.try_emplace(key, value, now, expiry_duration_ms, generation).first->second };
+
+            push_deadline(s, { e.deadline(), generation, key });
+        }
+
+        if (replaced) signal_data_expired.emit(key, *replaced);
+    }
+
+    bool exists(const key_type &key) const
+    {
+        auto &s { shard_for(key) };
+        std::shared_lock lock { s.lock };
+
+        return s.data.find(key) != std::end(s.data);
+    }
+
+    void touch(const key_type &key, bool force_touch = true)
+    {
+        if (!_access_prolongs.load(std::memory_order_relaxed) && !force_touch) return;
+
+        auto &s { shard_for(key) };
+        std::shared_lock lock { s.lock };
+
+        auto it { s.data.find(key) };
+
+        if (it != std::end(s.data)) it->second.last_access.store(now_ticks(), std::memory_order_relaxed);
+    }
+
+    bool get(const key_type &key, value_type &value)
+    {
+        auto &s { shard_for(key) };
+        auto now { now_ticks() };
+
+        {
+            std::shared_lock lock { s.lock };
+
+            auto it { s.data.find(key) };
+
+            if (it == std::end(s.data))
+            {
+                s.misses.fetch_add(1, std::memory_order_relaxed);
+
+                return false;
+            }
+
+            auto &e { it->second };
+
+            if (now <= e.deadline())
+            {
+                value = e.value;
+
+                if (_access_prolongs.load(std::memory_order_relaxed)) e.last_access.store(now, std::memory_order_relaxed);
+
+                s.hits.fetch_add(1, std::memory_order_relaxed);
+
+                return true;
+            }
+        }
+
+        s.misses.fetch_add(1, std::memory_order_relaxed);
+
+        if (!_auto_vacuum.load(std::memory_order_relaxed)) erase_expired(s, key, now);
+
+        return false;
+    }
+
+    void set_access_prolongs(bool prolongs = true)
+    {
+        _access_prolongs.store(prolongs, std::memory_order_relaxed);
+    }
+
+    bool is_access_prolongs() const
+    {
+        return _access_prolongs;
+    }
+
+    template<typename duration_type>
+    void set_expiry(const duration_type &duration)
+    {
+        _expiry_duration_ms.store(std::chrono::duration_cast<std::chrono::milliseconds>(duration), std::memory_order_relaxed);
+    }
+
+    template<typename duration_type>
+    void set_expiry(const key_type &key, const duration_type &duration)
+    {
+        auto &s { shard_for(key) };
+        std::scoped_lock lock { s.lock };
+
+        auto it { s.data.find(key) };
+
+        if (it == std::end(s.data)) return;
+
+        it->second.expiry.store(std::chrono::duration_cast<std::chrono::milliseconds>(duration), std::memory_order_relaxed);
+
+        // a shorter expiry moves the deadline forward, which the heap has to learn about
+        push_deadline(s, { it->second.deadline(), it->second.generation, key });
+    }
+
+    const std::chrono::milliseconds get_expiry() const
+    {
+        return _expiry_duration_ms.load(std::memory_order_relaxed);
+    }
+
+    const std::chrono::milliseconds get_expiry(const key_type &key) const
+    {
+        auto &s { shard_for(key) };
+        std::shared_lock lock { s.lock };
+
+        auto it { s.data.find(key) };
+
+        if (it != std::end(s.data)) return it->second.expiry.load(std::memory_order_relaxed);
+
+        return _expiry_duration_ms.load(std::memory_order_relaxed);
+    }
+
+    void clear()
+    {
+        for (size_t idx { 0 }; idx < _shard_count; ++idx)
+        {
+            auto &s { _shards[idx] };
+            std::scoped_lock lock { s.lock };
+
+            s.data.clear();
+            s.deadlines.clear();
+        }
+    }
+
+    size_t size() const
+    {
+        size_t result { 0 };
+
+        for (size_t idx { 0 }; idx < _shard_count; ++idx)
+        {
+            auto &s { _shards[idx] };
+            std::shared_lock lock { s.lock };
+
+            result += std::size(s.data);
+        }
+
+        return result;
+    }
+
+    size_t shard_count() const
+    {
+        return _shard_count;
+    }
+
+    // the counters are kept per shard and summed up here, so the snapshot is not atomic across shards
+    cache_statistics statistics() const
+    {
+        cache_statistics result {};
+
+        for (size_t idx { 0 }; idx < _shard_count; ++idx)
+        {
+            auto &s { _shards[idx] };
+
+            result.hits += s.hits.load(std::memory_order_relaxed);
+            result.misses += s.misses.load(std::memory_order_relaxed);
+            result.expirations += s.expirations.load(std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    void reset_statistics()
+    {
+        for (size_t idx { 0 }; idx < _shard_count; ++idx)
+        {
+            auto &s { _shards[idx] };
+
+            s.hits.store(0, std::memory_order_relaxed);
+            s.misses.store(0, std::memory_order_relaxed);
+            s.expirations.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void vacuum()
+    {
+        auto now { now_ticks() };
+
+        for (size_t idx { 0 }; idx < _shard_count; ++idx) vacuum_shard(_shards[idx], now);
+    }
+
+    template<typename duration_type>
+    void set_vacuum_idle_period(const duration_type &duration)
+    {
+        _vacuum_idle_period_ms.store(std::chrono::duration_cast<std::chrono::milliseconds>(duration), std::memory_order_relaxed);
+    }
+
+    std::chrono::milliseconds get_vacuum_idle_period() const
+    {
+        return _vacuum_idle_period_ms;
+    }
+
+    // vacuuming runs on the shared signal dispatcher rather than on a thread of its own
+    void start_auto_vacuum()
+    {
+        if (_auto_vacuum.exchange(true)) return;
+
+        _vacuum_channel.reopen();
+
+        schedule_vacuum();
+    }
+
+    void stop_auto_vacuum()
+    {
+        if (!_auto_vacuum.exchange(false)) return;
+
+        _vacuum_channel.close();
+    }
+
+    nstd::signal_slot::signal<const key_type &, value_type &> signal_data_expired {};
+
+private:
+    // how many due heap records a shard handles per lock acquisition, so that vacuuming never stalls its readers for long
+    static constexpr size_t _vacuum_batch_size { 1024 };
+
+    struct entry
+    {
+        entry(const value_type &v, clock_type::rep now, std::chrono::milliseconds expiry_ms, uint64_t entry_generation) :
+            value { v }, last_access { now }, expiry { expiry_ms }, generation { entry_generation } {}
+
+        clock_type::rep deadline() const
+        {
+            return last_access.load(std::memory_order_relaxed) + std::chrono::duration_cast<clock_type::duration>(expiry.load(std::memory_order_relaxed)).count();
+        }
+
+        value_type value;
+        std::atomic<clock_type::rep> last_access;
+        std::atomic<std::chrono::milliseconds> expiry;
+        uint64_t generation;
+    };
+
+    // records are never updated in place: touching an entry only moves its real deadline later, and a record
+    // found to be early on its way out of the heap is pushed back with the current deadline
+    struct deadline_record
+    {
+        clock_type::rep deadline;
+        uint64_t generation;
+        key_type key;
+    };
+
+    struct later_deadline
+    {
+        bool operator()(const deadline_record &lhs, const deadline_record &rhs) const { return lhs.deadline > rhs.deadline; }
+    };
+
+    struct alignas(64) shard
+    {
+        mutable std::shared_mutex lock {};
+        std::unordered_map<key_type, entry, hasher_type> data {};
+        std::vector<deadline_record> deadlines {};
+        uint64_t generation { 0 };
+        std::atomic<uint64_t> hits { 0 }, misses { 0 }, expirations { 0 };
+    };
+
+    const size_t _shard_count;
+    const int _shard_shift;
+    std::unique_ptr<shard[]> _shards;
+    std::atomic<std::chrono::milliseconds> _expiry_duration_ms { 10min };
+    std::atomic<std::chrono::milliseconds> _vacuum_idle_period_ms { 1s };
+    std::atomic_bool _access_prolongs { false };
+    std::atomic_bool _auto_vacuum { false };
+    nstd::signal_slot::dispatch_channel _vacuum_channel {};
+
+    static size_t default_shard_count()
+    {
+        return std::bit_ceil(std::max<size_t>(4 * std::thread::hardware_concurrency(), 16));
+    }
+
+    static clock_type::rep now_ticks()
+    {
+        return clock_type::now().time_since_epoch().count();
+    }
+
+    shard &shard_for(const key_type &key) const
+    {
+        if (_shard_count == 1) return _shards[0];
+
+        // the high bits of the mixed hash pick the shard, the map inside uses the hash as is
+        auto mixed { static_cast<uint64_t>(hasher_type {}(key)) * 0x9E3779B97F4A7C15ull };
+
+        return _shards[mixed >> _shard_shift];
+    }
+
+    void push_deadline(shard &s, deadline_record &&record)
+    {
+        s.deadlines.push_back(std::move(record));
+        std::push_heap(std::begin(s.deadlines), std::end(s.deadlines), later_deadline {});
+
+        // stale records of replaced or re-timed entries pile up under heavy overwriting; rebuild from the live entries
+        if (std::size(s.deadlines) > 2 * std::size(s.data) + _vacuum_batch_size)
+        {
+            s.deadlines.clear();
+
+            for (auto &[key, e] : s.data) s.deadlines.push_back({ e.deadline(), e.generation, key });
+
+            std::make_heap(std::begin(s.deadlines), std::end(s.deadlines), later_deadline {});
+        }
+    }
+
+    void vacuum_shard(shard &s, clock_type::rep now)
+    {
+        std::vector<std::pair<key_type, value_type>> expired {};
+        bool has_more { true };
+
+        while (has_more)
+        {
+            {
+                std::scoped_lock lock { s.lock };
+                size_t processed { 0 };
+
+                for (; processed < _vacuum_batch_size && !std::empty(s.deadlines) && s.deadlines.front().deadline < now; ++processed)
+                {
+                    std::pop_heap(std::begin(s.deadlines), std::end(s.deadlines), later_deadline {});
+
+                    auto record { std::move(s.deadlines.back()) };
+
+                    s.deadlines.pop_back();
+
+                    auto it { s.data.find(record.key) };
+
+                    if (it == std::end(s.data) || it->second.generation != record.generation) continue;
+
+                    if (auto deadline { it->second.deadline() }; deadline >= now)
+                    {
+                        record.deadline = deadline;
+
+                        s.deadlines.push_back(std::move(record));
+                        std::push_heap(std::begin(s.deadlines), std::end(s.deadlines), later_deadline {});
+
+                        continue;
+                    }
+
+                    expired.emplace_back(std::move(record.key), std::move(it->second.value));
+
+                    s.data.erase(it);
+                }
+
+                has_more = processed == _vacuum_batch_size;
+
+                s.expirations.fetch_add(std::size(expired), std::memory_order_relaxed);
+            }
+
+            for (auto &[key, value] : expired) signal_data_expired.emit(key, value);
+
+            expired.clear();
+        }
+    }
+
+    void erase_expired(shard &s, const key_type &key, clock_type::rep now)
+    {
+        std::optional<value_type> expired {};
+
+        {
+            std::scoped_lock lock { s.lock };
+
+            auto it { s.data.find(key) };
+
+            if (it == std::end(s.data) || now <= it->second.deadline()) return;
+
+            expired.emplace(std::move(it->second.value));
+
+            s.data.erase(it);
+
+            s.expirations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        signal_data_expired.emit(key, *expired);
+    }
+
+    void schedule_vacuum()
+    {
+        _vacuum_channel.post_after(_vacuum_idle_period_ms.load(std::memory_order_relaxed), [this]
+        {
+            vacuum();
+
+            if (_auto_vacuum.load(std::memory_order_relaxed)) schedule_vacuum();
+        });
+    }
 };
 }
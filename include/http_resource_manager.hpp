@@ -216,13 +216,9 @@ public:
 
                 stream << NL;
 
-                if (has_content) stream.write(std::data(out_content), std::size(out_content));
+                response_data.buffer.append(stream.str());
 
-                std::string result { stream.str() };
-
-                response_data.buffer.resize(std::size(result));
-
-                std::copy(std::begin(result), std::end(result), std::begin(response_data.buffer));
+                if (has_content) response_data.buffer.append(std::move(out_content));
             }
 
             return response_data;
@@ -0,0 +1,392 @@
+#pragma once
+
+/*
+MIT License
+Copyright (c) 2019 Arlen Keshabyan (arlen.albert@gmail.com)
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "thread_pool.hpp"
+
+// All the algorithms below split the input into chunks of 'grain_size' elements (0 picks a grain size automatically)
+// and run them on the given thread pool (the global one by default). The calling thread always takes part in the work
+// and, while waiting, executes other pending tasks of the pool, so nested calls neither block workers nor spawn threads;
+// once there are none it sleeps until its helpers finish or are dropped by a cancelled pool.
+
+namespace nstd::parallel
+{
+
+namespace detail
+{
+
+class chunk_dispatcher
+{
+public:
+    chunk_dispatcher(thread_pool &pool, std::size_t count, std::size_t grain_size) : _pool { pool }, _count { count }
+    {
+        if (grain_size == 0) grain_size = std::max<std::size_t>(1, count / ((pool.size() + 1) * 4));
+
+        _grain_size = grain_size;
+        _chunks_count = (count + grain_size - 1) / grain_size;
+    }
+
+    std::size_t chunks_count() const { return _chunks_count; }
+
+    // functor(chunk_index, first, last) is called for every chunk, the first exception thrown is rethrown here
+    template <typename Functor>
+    void run(Functor &&functor)
+    {
+        if (_chunks_count == 0) return;
+
+        if (_chunks_count == 1) { functor(std::size_t { 0 }, std::size_t { 0 }, _count); return; }
+
+        auto helpers { std::min(_pool.size(), _chunks_count - 1) };
+        task_group group { _pool };
+
+        // helpers the pool never runs (a refused post or a cancelled pool) count as done, their chunks are left to the others
+        for (std::size_t idx { 0 }; idx < helpers; ++idx)
+        {
+            try
+            {
+                group.post([this, &functor] { process(functor); });
+            }
+            catch (...)
+            {
+                break;
+            }
+        }
+
+        process(functor);
+        group.wait();
+
+        if (_exception) std::rethrow_exception(_exception);
+    }
+
+private:
+    template <typename Functor>
+    void process(Functor &functor)
+    {
+        for (auto chunk { _next_chunk.fetch_add(1, std::memory_order_relaxed) }; chunk < _chunks_count; chunk = _next_chunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            if (_failed.load(std::memory_order_relaxed)) return;
+
+            try
+            {
+                auto first { chunk * _grain_size };
+
+                functor(chunk, first, std::min(first + _grain_size, _count));
+            }
+            catch (...)
+            {
+                std::scoped_lock lock { _exception_mutex };
+
+                if (!_exception) _exception = std::current_exception();
+
+                _failed = true;
+            }
+        }
+    }
+
+private:
+    thread_pool &_pool;
+    std::size_t _count { 0 };
+    std::size_t _grain_size { 1 };
+    std::size_t _chunks_count { 0 };
+    std::atomic<std::size_t> _next_chunk { 0 };
+    std::atomic_bool _failed { false };
+    std::mutex _exception_mutex {};
+    std::exception_ptr _exception {};
+};
+
+template <typename Iterator>
+inline constexpr bool is_random_access_v = std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>;
+
+}
+
+// functor(first, last) is called for every chunk of the [first, last) index range
+template <typename Index, typename Functor>
+void for_each_chunk(Index first, Index last, Functor &&functor, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    if (!(first < last)) return;
+
+    detail::chunk_dispatcher dispatcher { pool, static_cast<std::size_t>(last - first), grain_size };
+
+    dispatcher.run([first, &functor](std::size_t, std::size_t chunk_first, std::size_t chunk_last)
+    {
+        functor(static_cast<Index>(first + chunk_first), static_cast<Index>(first + chunk_last));
+    });
+}
+
+// functor(index) is called for every index of the [first, last) range
+template <typename Index, typename Functor>
+void for_index(Index first, Index last, Functor &&functor, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    for_each_chunk(first, last, [&functor](Index chunk_first, Index chunk_last)
+    {
+        for (; chunk_first != chunk_last; ++chunk_first) functor(chunk_first);
+    }, grain_size, pool);
+}
+
+template <typename Iterator, typename Functor>
+void for_each(Iterator first, Iterator last, Functor &&functor, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    if constexpr (detail::is_random_access_v<Iterator>)
+    {
+        for_each_chunk(std::size_t { 0 }, static_cast<std::size_t>(std::distance(first, last)), [first, &functor](std::size_t chunk_first, std::size_t chunk_last)
+        {
+            std::for_each(first + chunk_first, first + chunk_last, functor);
+        }, grain_size, pool);
+    }
+    else
+    {
+        // the chunk boundaries of non random access ranges are collected upfront in a single pass
+        auto count { static_cast<std::size_t>(std::distance(first, last)) };
+        auto chunk_size { grain_size ? grain_size : std::max<std::size_t>(1, count / ((pool.size() + 1) * 4)) };
+        std::vector<Iterator> boundaries { first };
+
+        for (auto remaining { count }; remaining > 0; boundaries.emplace_back(first))
+        {
+            auto step { std::min(chunk_size, remaining) };
+
+            std::advance(first, step);
+
+            remaining -= step;
+        }
+
+        for_index(std::size_t { 1 }, std::size(boundaries), [&boundaries, &functor](std::size_t idx)
+        {
+            std::for_each(boundaries[idx - 1], boundaries[idx], functor);
+        }, 1, pool);
+    }
+}
+
+template <typename Iterator, typename OutputIterator, typename UnaryOperation>
+OutputIterator transform(Iterator first, Iterator last, OutputIterator output, UnaryOperation &&operation, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    static_assert(detail::is_random_access_v<Iterator> && detail::is_random_access_v<OutputIterator>, "parallel::transform requires random access iterators");
+
+    auto count { static_cast<std::size_t>(std::distance(first, last)) };
+
+    for_each_chunk(std::size_t { 0 }, count, [first, output, &operation](std::size_t chunk_first, std::size_t chunk_last)
+    {
+        std::transform(first + chunk_first, first + chunk_last, output + chunk_first, operation);
+    }, grain_size, pool);
+
+    return output + count;
+}
+
+// 'operation' must be associative, partial results are combined in the chunk order
+template <typename Iterator, typename T, typename BinaryOperation = std::plus<>>
+T reduce(Iterator first, Iterator last, T init, BinaryOperation &&operation = {}, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    static_assert(detail::is_random_access_v<Iterator>, "parallel::reduce requires random access iterators");
+
+    auto count { static_cast<std::size_t>(std::distance(first, last)) };
+
+    if (count == 0) return init;
+
+    detail::chunk_dispatcher dispatcher { pool, count, grain_size };
+    std::vector<std::optional<T>> partials(dispatcher.chunks_count());
+
+    dispatcher.run([first, &operation, &partials](std::size_t chunk, std::size_t chunk_first, std::size_t chunk_last)
+    {
+        T partial(*(first + chunk_first));
+
+        for (auto it { first + chunk_first + 1 }, end { first + chunk_last }; it != end; ++it) partial = operation(std::move(partial), *it);
+
+        partials[chunk].emplace(std::move(partial));
+    });
+
+    for (auto &partial : partials) init = operation(std::move(init), std::move(*partial));
+
+    return init;
+}
+
+namespace detail
+{
+
+template <typename Iterator, typename OutputIterator, typename T, typename BinaryOperation>
+void scan(Iterator first, Iterator last, OutputIterator output, std::optional<T> init, BinaryOperation &operation, std::size_t grain_size, thread_pool &pool)
+{
+    static_assert(is_random_access_v<Iterator> && is_random_access_v<OutputIterator>, "parallel scans require random access iterators");
+
+    auto count { static_cast<std::size_t>(std::distance(first, last)) };
+
+    if (count == 0) return;
+
+    chunk_dispatcher reducer { pool, count, grain_size };
+    std::vector<std::optional<T>> sums(reducer.chunks_count());
+
+    // 1st pass: every chunk but the last one is reduced
+    reducer.run([first, count, &operation, &sums](std::size_t chunk, std::size_t chunk_first, std::size_t chunk_last)
+    {
+        if (chunk_last == count) return;
+
+        T sum(*(first + chunk_first));
+
+        for (auto it { first + chunk_first + 1 }, end { first + chunk_last }; it != end; ++it) sum = operation(std::move(sum), *it);
+
+        sums[chunk].emplace(std::move(sum));
+    });
+
+    // 2nd pass: the chunk sums are turned into the chunk offsets (sequentially, there are only a few of them)
+    std::vector<std::optional<T>> offsets(std::size(sums));
+
+    offsets[0] = init;
+
+    for (std::size_t chunk { 1 }; chunk < std::size(sums); ++chunk)
+        offsets[chunk] = offsets[chunk - 1] ? std::optional<T> { operation(*offsets[chunk - 1], *sums[chunk - 1]) } : sums[chunk - 1];
+
+    // 3rd pass: every chunk is scanned starting from its offset
+    chunk_dispatcher scanner { pool, count, grain_size };
+
+    scanner.run([first, output, exclusive = init.has_value(), &operation, &offsets](std::size_t chunk, std::size_t chunk_first, std::size_t chunk_last)
+    {
+        auto it { first + chunk_first };
+        auto out { output + chunk_first };
+        auto end { first + chunk_last };
+        std::optional<T> accumulator { offsets[chunk] };
+
+        for (; it != end; ++it, ++out)
+        {
+            if (exclusive)
+            {
+                T value(*it);
+
+                *out = *accumulator;
+                accumulator = operation(std::move(*accumulator), std::move(value));
+            }
+            else
+            {
+                accumulator = accumulator ? std::optional<T> { operation(std::move(*accumulator), *it) } : std::optional<T> { *it };
+                *out = *accumulator;
+            }
+        }
+    });
+}
+
+}
+
+template <typename Iterator, typename OutputIterator, typename BinaryOperation = std::plus<>>
+OutputIterator inclusive_scan(Iterator first, Iterator last, OutputIterator output, BinaryOperation &&operation = {}, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+
+    detail::scan(first, last, output, std::optional<value_type> {}, operation, grain_size, pool);
+
+    return output + std::distance(first, last);
+}
+
+template <typename Iterator, typename OutputIterator, typename T, typename BinaryOperation = std::plus<>>
+OutputIterator exclusive_scan(Iterator first, Iterator last, OutputIterator output, T init, BinaryOperation &&operation = {}, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    detail::scan(first, last, output, std::optional<T> { std::move(init) }, operation, grain_size, pool);
+
+    return output + std::distance(first, last);
+}
+
+// Stable parallel merge sort: the chunks are sorted independently and then merged pairwise in rounds,
+// every merge being split into independent pieces with binary searches.
+template <typename Iterator, typename Compare = std::less<>>
+void stable_sort(Iterator first, Iterator last, Compare &&compare = {}, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    static_assert(detail::is_random_access_v<Iterator>, "parallel::stable_sort requires random access iterators");
+
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+
+    auto count { static_cast<std::size_t>(std::distance(first, last)) };
+
+    if (count < 2) return;
+
+    if (grain_size == 0) grain_size = std::max<std::size_t>(2048, count / ((pool.size() + 1) * 4));
+
+    if (count <= grain_size) { std::stable_sort(first, last, compare); return; }
+
+    for_each_chunk(std::size_t { 0 }, count, [first, &compare](std::size_t chunk_first, std::size_t chunk_last)
+    {
+        std::stable_sort(first + chunk_first, first + chunk_last, compare);
+    }, grain_size, pool);
+
+    struct merge_piece { std::size_t left_first, left_last, right_first, right_last, output; };
+
+    std::vector<value_type> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+    std::vector<merge_piece> pieces;
+    bool in_buffer { true };
+
+    for (auto run { grain_size }; run < count; run *= 2)
+    {
+        pieces.clear();
+
+        auto merge_round { [&](auto source, auto destination)
+        {
+            for (std::size_t left { 0 }; left < count; left += run * 2)
+            {
+                auto middle { std::min(left + run, count) };
+                auto right_last { std::min(left + run * 2, count) };
+                auto right { middle };
+
+                for (auto piece_first { left }; piece_first < middle; piece_first += grain_size)
+                {
+                    auto piece_last { std::min(piece_first + grain_size, middle) };
+                    auto right_end { piece_last == middle ? right_last : static_cast<std::size_t>(std::lower_bound(source + middle, source + right_last, *(source + piece_last), compare) - source) };
+
+                    pieces.push_back({ piece_first, piece_last, right, right_end, piece_first + (right - middle) });
+
+                    right = right_end;
+                }
+            }
+
+            for_index(std::size_t { 0 }, std::size(pieces), [&pieces, source, destination, &compare](std::size_t idx)
+            {
+                auto &piece { pieces[idx] };
+                auto left { source + piece.left_first }, left_last { source + piece.left_last };
+                auto right { source + piece.right_first }, right_last { source + piece.right_last };
+                auto output { destination + piece.output };
+
+                while (left != left_last && right != right_last) *output++ = compare(*right, *left) ? std::move(*right++) : std::move(*left++);
+
+                std::move(right, right_last, std::move(left, left_last, output));
+            }, 1, pool);
+        } };
+
+        if (in_buffer) merge_round(std::begin(buffer), first);
+        else merge_round(first, std::begin(buffer));
+
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) transform(std::begin(buffer), std::end(buffer), first, [](auto &value) { return std::move(value); }, grain_size, pool);
+}
+
+template <typename Iterator, typename Compare = std::less<>>
+void sort(Iterator first, Iterator last, Compare &&compare = {}, std::size_t grain_size = 0, thread_pool &pool = global_thread_pool::get_thread_pool())
+{
+    stable_sort(first, last, std::forward<Compare>(compare), grain_size, pool);
+}
+
+}
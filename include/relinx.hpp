@@ -26,31 +26,46 @@ SOFTWARE.
 
 #include <algorithm>
 #include <any>
+#include <array>
 #include <concepts>
 #include <functional>
 #include <iterator>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <numeric>
+#include <optional>
+#include <ranges>
 #include <sstream>
+#include <tuple>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <type_traits>
 #include <variant>
 
 #include <iostream>
 
+#include "relinx_memory_resource.hpp"
+
+#if !defined(RELINX_NO_SIMD)
+#if defined(__AVX2__)
+#define RELINX_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RELINX_SIMD_SSE2
+#endif
+#endif
+
+#if defined(RELINX_SIMD_AVX2) || defined(RELINX_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
 namespace nstd::relinx
 {
 
 using namespace std::literals;
 
-template<typename T> using default_container = std::vector<T>;
-template<typename T, typename V> using default_map = std::unordered_map<T, V>;
-template<typename T, typename V> using default_multimap = std::unordered_multimap<T, V>;
-template<typename T> using default_set = std::unordered_set<T>;
-
 template<typename T>
 concept PointerFor = std::is_pointer_v<T>;
 
@@ -66,6 +81,13 @@ struct is_specialization_of<Z<Args...>, Z> : std::true_type { };
 template <typename A, template <typename...> typename B>
 concept SpecializationOf = is_specialization_of<A, B>::value;
 
+template<typename T>
+concept HashableKey = std::equality_comparable<T> && requires(const T &v) { { std::hash<T>()(v) } -> std::convertible_to<std::size_t>; };
+
+// joins and set operations switch from a nested scan to a hash index when the keys are compared with plain equality
+template<typename CompareFunctor, typename ThisKey, typename OtherKey = ThisKey>
+concept HashJoinable = SpecializationOf<std::decay_t<CompareFunctor>, std::equal_to> && std::same_as<ThisKey, OtherKey> && HashableKey<ThisKey>;
+
 using default_iterator_adapter_tag = std::forward_iterator_tag;
 
 template<typename ParentIterator1, typename ParentIterator2>
@@ -977,6 +999,331 @@ protected:
     default_container<join_value_type> _groupedValues {};
 };
 
+template<typename ParentIterator, typename JoinIterator, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor>
+class hash_join_iterator_adapter
+{
+protected:
+    ThisKeyFunctor _thisKeyFunctor;
+    OtherKeyFunctor _otherKeyFunctor;
+    ResultFunctor _resultFunctor;
+
+public:
+    using self_type = hash_join_iterator_adapter<ParentIterator, JoinIterator, ThisKeyFunctor, OtherKeyFunctor, ResultFunctor>;
+    using value_type = typename std::decay<decltype(_resultFunctor(*ParentIterator(), *JoinIterator()))>::type;
+    using parent_value_type = typename std::decay<decltype(*ParentIterator())>::type;
+    using join_value_type = typename std::decay<decltype(*JoinIterator())>::type;
+    using key_type = typename std::decay<decltype(_otherKeyFunctor(join_value_type()))>::type;
+    using index_type = default_map<key_type, default_container<JoinIterator>>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+    using iterator_category = default_iterator_adapter_tag;
+
+    hash_join_iterator_adapter() = default;
+    hash_join_iterator_adapter(const self_type &) = default;
+    hash_join_iterator_adapter(self_type &&) = default;
+    hash_join_iterator_adapter &operator=(const self_type &) = default;
+    hash_join_iterator_adapter &operator=(self_type &&) = default;
+
+    hash_join_iterator_adapter(ParentIterator begin,
+                               ParentIterator end,
+                               JoinIterator joinBegin,
+                               JoinIterator joinEnd,
+                               ThisKeyFunctor &&thisKeyFunctor,
+                               OtherKeyFunctor &&otherKeyFunctor,
+                               ResultFunctor &&resultFunctor,
+                               bool leftJoin)
+    : _thisKeyFunctor(std::forward<ThisKeyFunctor>(thisKeyFunctor)),
+        _otherKeyFunctor(std::forward<OtherKeyFunctor>(otherKeyFunctor)),
+        _resultFunctor(std::forward<ResultFunctor>(resultFunctor)),
+        _begin(begin),
+        _end(end),
+        _leftJoin(leftJoin)
+    {
+        if (_begin == _end) return;
+
+        // the joined container is indexed once, the current sequence stays lazy and only probes the index: indexing the current
+        // sequence instead would walk it to the end and give up its order. Like every adapter, this one is positioned when it is built.
+        auto index { std::make_shared<index_type>() };
+
+        for (auto joinIt = joinBegin; joinIt != joinEnd; ++joinIt) (*index)[_otherKeyFunctor(*joinIt)].emplace_back(joinIt);
+
+        _index = std::move(index);
+
+        // nothing can match an empty container, so an inner join does not pull the current sequence at all
+        if (std::empty(*_index) && !_leftJoin) _begin = _end;
+
+        seek();
+    }
+
+    auto operator==(const self_type &s) const
+    {
+        return ((_begin == _end && s._begin == s._end) ||
+                (_begin == s._begin && _end == s._end && _matchIndex == s._matchIndex));
+    }
+
+    auto operator!=(const self_type &s) const
+    {
+        return !(*this == s);
+    }
+
+    auto operator*() const -> const value_type&
+    {
+        if (!_matches) return (_resultValue = _resultFunctor(*_begin, join_value_type()));
+
+        return (_resultValue = _resultFunctor(*_begin, *(*_matches)[_matchIndex]));
+    }
+
+    auto operator->() -> const value_type
+    {
+        return *(*this);
+    }
+
+    auto operator++() -> self_type&
+    {
+        if (_matches && ++_matchIndex < std::size(*_matches)) return *this;
+
+        ++_begin;
+
+        seek();
+
+        return *this;
+    }
+
+    auto operator++(int) -> self_type
+    {
+        auto __tmp = *this;
+
+        ++(*this);
+
+        return __tmp;
+    }
+
+protected:
+    ParentIterator _begin;
+    ParentIterator _end;
+    bool _leftJoin;
+    std::shared_ptr<const index_type> _index {};
+    const default_container<JoinIterator> *_matches { nullptr };
+    std::size_t _matchIndex { 0 };
+    mutable value_type _resultValue {};
+
+    void seek()
+    {
+        for (_matchIndex = 0; _begin != _end; ++_begin)
+        {
+            auto found = _index->find(_thisKeyFunctor(*_begin));
+
+            _matches = found == _index->end() ? nullptr : &found->second;
+
+            if (_matches || _leftJoin) break;
+        }
+    }
+};
+
+template<typename ParentIterator, typename JoinIterator, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor>
+class hash_group_join_iterator_adapter
+{
+protected:
+    ThisKeyFunctor _thisKeyFunctor;
+    OtherKeyFunctor _otherKeyFunctor;
+    ResultFunctor _resultFunctor;
+
+public:
+    using self_type = hash_group_join_iterator_adapter<ParentIterator, JoinIterator, ThisKeyFunctor, OtherKeyFunctor, ResultFunctor>;
+    using value_type = typename std::decay<decltype(_resultFunctor(*ParentIterator(), default_container<typename std::decay<decltype(*JoinIterator())>::type>()))>::type;
+    using parent_value_type = typename std::decay<decltype(*ParentIterator())>::type;
+    using join_value_type = typename std::decay<decltype(*JoinIterator())>::type;
+    using key_type = typename std::decay<decltype(_otherKeyFunctor(join_value_type()))>::type;
+    using index_type = default_map<key_type, default_container<join_value_type>>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+    using iterator_category = default_iterator_adapter_tag;
+
+    hash_group_join_iterator_adapter() = default;
+    hash_group_join_iterator_adapter(const self_type &) = default;
+    hash_group_join_iterator_adapter(self_type &&) = default;
+    hash_group_join_iterator_adapter &operator=(const self_type &) = default;
+    hash_group_join_iterator_adapter &operator=(self_type &&) = default;
+
+    hash_group_join_iterator_adapter(ParentIterator begin,
+                                     ParentIterator end,
+                                     JoinIterator joinBegin,
+                                     JoinIterator joinEnd,
+                                     ThisKeyFunctor &&thisKeyFunctor,
+                                     OtherKeyFunctor &&otherKeyFunctor,
+                                     ResultFunctor &&resultFunctor,
+                                     bool leftJoin)
+    : _thisKeyFunctor(std::forward<ThisKeyFunctor>(thisKeyFunctor)),
+        _otherKeyFunctor(std::forward<OtherKeyFunctor>(otherKeyFunctor)),
+        _resultFunctor(std::forward<ResultFunctor>(resultFunctor)),
+        _begin(begin),
+        _end(end),
+        _leftJoin(leftJoin)
+    {
+        if (_begin == _end) return;
+
+        auto index { std::make_shared<index_type>() };
+
+        for (auto joinIt = joinBegin; joinIt != joinEnd; ++joinIt) (*index)[_otherKeyFunctor(*joinIt)].emplace_back(*joinIt);
+
+        _index = std::move(index);
+
+        if (std::empty(*_index) && !_leftJoin) _begin = _end;
+
+        seek();
+    }
+
+    auto operator==(const self_type &s) const
+    {
+        return ((_begin == _end && s._begin == s._end) ||
+                (_begin == s._begin && _end == s._end));
+    }
+
+    auto operator!=(const self_type &s) const
+    {
+        return !(*this == s);
+    }
+
+    auto operator*() const -> const value_type&
+    {
+        static const default_container<join_value_type> noMatches {};
+
+        return (_resultValue = _resultFunctor(*_begin, _groupedValues ? *_groupedValues : noMatches));
+    }
+
+    auto operator->() -> const value_type
+    {
+        return *(*this);
+    }
+
+    auto operator++() -> self_type&
+    {
+        ++_begin;
+
+        seek();
+
+        return *this;
+    }
+
+    auto operator++(int) -> self_type
+    {
+        auto __tmp = *this;
+
+        ++(*this);
+
+        return __tmp;
+    }
+
+protected:
+    ParentIterator _begin;
+    ParentIterator _end;
+    bool _leftJoin;
+    std::shared_ptr<const index_type> _index {};
+    const default_container<join_value_type> *_groupedValues { nullptr };
+    mutable value_type _resultValue {};
+
+    void seek()
+    {
+        for (; _begin != _end; ++_begin)
+        {
+            auto found = _index->find(_thisKeyFunctor(*_begin));
+
+            _groupedValues = found == _index->end() ? nullptr : &found->second;
+
+            if (_groupedValues || _leftJoin) break;
+        }
+    }
+};
+
+template<typename ParentIterator, typename OtherIterator, bool Intersect>
+class hash_set_iterator_adapter
+{
+public:
+    using self_type = hash_set_iterator_adapter<ParentIterator, OtherIterator, Intersect>;
+    using value_type = typename std::decay<decltype(*ParentIterator())>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+    using iterator_category = default_iterator_adapter_tag;
+
+    hash_set_iterator_adapter() = default;
+    hash_set_iterator_adapter(const self_type &) = default;
+    hash_set_iterator_adapter(self_type &&) = default;
+    hash_set_iterator_adapter &operator=(const self_type &) = default;
+    hash_set_iterator_adapter &operator=(self_type &&) = default;
+
+    hash_set_iterator_adapter(ParentIterator begin, ParentIterator end, OtherIterator otherBegin, OtherIterator otherEnd)
+    : _begin(begin), _end(end)
+    {
+        if (_begin == _end) return;
+
+        _otherValues = std::make_shared<const default_set<value_type>>(otherBegin, otherEnd);
+
+        seek();
+    }
+
+    auto operator==(const self_type &s) const
+    {
+        return ((_begin == _end && s._begin == s._end) ||
+                (_begin == s._begin && _end == s._end));
+    }
+
+    auto operator!=(const self_type &s) const
+    {
+        return !(*this == s);
+    }
+
+    auto operator*() const -> const value_type&
+    {
+        return *_begin;
+    }
+
+    auto operator->() -> const value_type
+    {
+        return *(*this);
+    }
+
+    auto operator++() -> self_type&
+    {
+        if (_begin != _end)
+        {
+            ++_begin;
+
+            seek();
+        }
+
+        return *this;
+    }
+
+    auto operator++(int) -> self_type
+    {
+        auto __tmp = *this;
+
+        ++(*this);
+
+        return __tmp;
+    }
+
+protected:
+    ParentIterator _begin;
+    ParentIterator _end;
+    std::shared_ptr<const default_set<value_type>> _otherValues {};
+    default_set<value_type> _processedValues {};
+
+    void seek()
+    {
+        _begin = std::find_if(_begin, _end, [this](auto &&v) { return _otherValues->contains(v) == Intersect && _processedValues.insert(v).second; });
+    }
+};
+
+template<typename ParentIterator, typename ExceptIterator>
+using hash_except_iterator_adapter = hash_set_iterator_adapter<ParentIterator, ExceptIterator, false>;
+
+template<typename ParentIterator, typename IntersectIterator>
+using hash_intersect_iterator_adapter = hash_set_iterator_adapter<ParentIterator, IntersectIterator, true>;
+
 template<typename ParentIterator1, typename ParentIterator2, typename ResultFunctor>
 class zip_iterator_adapter
 {
@@ -1130,32 +1477,544 @@ protected:
     std::ptrdiff_t _currentIteration { 0 };
 };
 
-struct no_elements : public std::logic_error { no_elements(const std::string &what) : std::logic_error(what) {} }; ///< The exeption that is thrown when there are no elements in the targeting sequence;
-struct not_found : public std::logic_error { not_found(const std::string &what) : std::logic_error(what) {} }; ///< The exeption that is thrown when there are no elements found using a filter functor on the targeting sequence
-struct invalid_operation : public std::logic_error { invalid_operation(const std::string &what) : std::logic_error(what) {} }; ///< The exeption that is thrown when there is no complience to the performing action
+template<typename SelectFunctor, typename SortFunctor>
+struct sort_level
+{
+    SelectFunctor selectFunctor;
+    SortFunctor sortFunctor;
+};
 
-template<typename ParentRelinxType, typename Iterator, typename PreviousSelectFunctor> class relinx_object_ordered;
+/** \brief The deferred sort of an order_by / then_by chain.
 
-template<typename ParentRelinxType, typename Iterator, typename ContainerType = default_container<typename std::decay<decltype(*Iterator())>::type>>
-class relinx_object : public std::enable_shared_from_this<relinx_object<ParentRelinxType, Iterator, ContainerType>>
+    Keeps the source range and the sort levels; nothing is read until the ordered sequence is iterated or a take is applied to it.
+    The keys of every level are computed once per element (decorate-sort-undecorate), equal keys keep the order of the source.
+*/
+template<typename SourceIterator, typename ...SortLevels>
+class ordering
 {
 public:
-    using self_type = relinx_object<ParentRelinxType, Iterator, ContainerType>;
-    using value_type = typename std::decay<decltype(*Iterator())>::type;
-    using iterator_type = typename std::decay<Iterator>::type;
+    using self_type = ordering<SourceIterator, SortLevels...>;
+    using value_type = typename std::decay<decltype(*SourceIterator())>::type;
+    using keys_type = std::tuple<std::decay_t<std::invoke_result_t<const decltype(SortLevels::selectFunctor)&, const value_type&>>...>;
 
-    relinx_object() = delete;
-    relinx_object(const relinx_object &) = delete;
-    auto operator =(const relinx_object &) -> relinx_object & = delete;
-    relinx_object(relinx_object &&) = default;
+    ordering(SourceIterator begin, SourceIterator end, std::tuple<SortLevels...> &&levels) : _begin(begin), _end(end), _levels(std::move(levels)) { }
 
-    relinx_object(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, const iterator_type &begin, const iterator_type &end) noexcept : _begin(begin), _end(end), _parent_relinx_object_ptr(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr)) { }
-    relinx_object(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, iterator_type &&begin, iterator_type &&end) noexcept : _begin(std::forward<iterator_type>(begin)), _end(std::forward<iterator_type>(end)), _parent_relinx_object_ptr(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr)) { }
-    relinx_object(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, ContainerType &&container) noexcept : _container(std::forward<ContainerType>(container)), _begin(std::begin(_container)), _end(std::end(_container)), _parent_relinx_object_ptr(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr)) { }
+    template<typename SortLevel>
+    auto then(SortLevel &&level) const
+    {
+        using next_ordering_type = ordering<SourceIterator, SortLevels..., std::decay_t<SortLevel>>;
 
-    ~relinx_object() noexcept = default;
+        return std::make_shared<next_ordering_type>(_begin, _end, std::tuple_cat(_levels, std::make_tuple(std::forward<SortLevel>(level))));
+    }
 
-    auto begin() const noexcept
+    auto values() -> const default_container<value_type>&
+    {
+        if (!_sorted)
+        {
+            default_container<value_type> unsorted;
+            default_container<std::pair<keys_type, std::size_t>> decorated;
+
+            for (auto it = _begin; it != _end; ++it)
+            {
+                unsorted.push_back(*it);
+                decorated.emplace_back(_keys(unsorted.back()), decorated.size());
+            }
+
+            std::sort(std::begin(decorated), std::end(decorated), [this](auto &&a, auto &&b) { return _precedes(a.first, a.second, b.first, b.second); });
+
+            _values.reserve(decorated.size());
+
+            for (auto &&d : decorated) _values.push_back(std::move(unsorted[d.second]));
+
+            _sorted = true;
+        }
+
+        return _values;
+    }
+
+    auto top(std::size_t limit) -> default_container<value_type>
+    {
+        if (_sorted)
+        {
+            auto count = std::min(limit, _values.size());
+
+            return default_container<value_type>(std::begin(_values), std::next(std::begin(_values), count));
+        }
+
+        struct entry
+        {
+            keys_type keys;
+            std::size_t index;
+            value_type value;
+        };
+
+        auto precedes = [this](const entry &a, const entry &b) { return _precedes(a.keys, a.index, b.keys, b.index); };
+
+        default_container<entry> heap;
+        std::size_t index = 0;
+
+        for (auto it = _begin; it != _end && limit > 0; ++it, ++index)
+        {
+            if (heap.size() < limit)
+            {
+                auto &&value = *it;
+
+                heap.push_back(entry { _keys(value), index, value });
+                std::push_heap(std::begin(heap), std::end(heap), precedes);
+            }
+            else
+            {
+                auto &&value = *it;
+                auto keys = _keys(value);
+
+                if (!_less(keys, heap.front().keys)) continue;
+
+                std::pop_heap(std::begin(heap), std::end(heap), precedes);
+                heap.back() = entry { std::move(keys), index, value };
+                std::push_heap(std::begin(heap), std::end(heap), precedes);
+            }
+        }
+
+        std::sort_heap(std::begin(heap), std::end(heap), precedes);
+
+        default_container<value_type> result;
+
+        result.reserve(heap.size());
+
+        for (auto &&e : heap) result.push_back(std::move(e.value));
+
+        return result;
+    }
+
+protected:
+    auto _keys(const value_type &value) const -> keys_type
+    {
+        return std::apply([&value](auto &&...levels) { return keys_type { levels.selectFunctor(value)... }; }, _levels);
+    }
+
+    template<std::size_t Level = 0>
+    auto _less(const keys_type &a, const keys_type &b) const -> bool
+    {
+        if constexpr (Level == sizeof...(SortLevels))
+        {
+            return false;
+        }
+        else
+        {
+            const auto &sortFunctor = std::get<Level>(_levels).sortFunctor;
+
+            if (sortFunctor(std::get<Level>(a), std::get<Level>(b))) return true;
+            if (sortFunctor(std::get<Level>(b), std::get<Level>(a))) return false;
+
+            return _less<Level + 1>(a, b);
+        }
+    }
+
+    auto _precedes(const keys_type &a, std::size_t aIndex, const keys_type &b, std::size_t bIndex) const -> bool
+    {
+        if (_less(a, b)) return true;
+        if (_less(b, a)) return false;
+
+        return aIndex < bIndex;
+    }
+
+    SourceIterator _begin;
+    SourceIterator _end;
+    std::tuple<SortLevels...> _levels;
+    default_container<value_type> _values;
+    bool _sorted { false };
+};
+
+template<typename Ordering>
+class ordered_iterator_adapter
+{
+public:
+    using self_type = ordered_iterator_adapter<Ordering>;
+    using value_type = typename Ordering::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+    using iterator_category = default_iterator_adapter_tag;
+
+    static constexpr auto end_position = static_cast<std::size_t>(-1);
+
+    ordered_iterator_adapter() = default;
+    ordered_iterator_adapter(const self_type &) = default;
+    ordered_iterator_adapter(self_type &&) = default;
+    ordered_iterator_adapter &operator=(const self_type &) = default;
+    ordered_iterator_adapter &operator=(self_type &&) = default;
+
+    ordered_iterator_adapter(Ordering *ordering, std::size_t position) : _ordering(ordering), _position(position) { }
+
+    auto operator==(const self_type &s) const
+    {
+        return _resolved_position() == s._resolved_position();
+    }
+
+    auto operator!=(const self_type &s) const
+    {
+        return !(*this == s);
+    }
+
+    auto operator*() const -> const value_type&
+    {
+        return _ordering->values()[_position];
+    }
+
+    auto operator->() const -> const value_type
+    {
+        return *(*this);
+    }
+
+    auto operator++() -> self_type&
+    {
+        ++_position;
+
+        return *this;
+    }
+
+    auto operator++(int) -> self_type
+    {
+        auto __tmp = *this;
+
+        ++(*this);
+
+        return __tmp;
+    }
+
+protected:
+    auto _resolved_position() const -> std::size_t
+    {
+        if (_position != end_position) return _position;
+
+        return _ordering ? _ordering->values().size() : 0;
+    }
+
+    Ordering *_ordering { nullptr };
+    std::size_t _position { 0 };
+};
+
+struct no_elements : public std::logic_error { no_elements(const std::string &what) : std::logic_error(what) {} }; ///< The exeption that is thrown when there are no elements in the targeting sequence;
+struct not_found : public std::logic_error { not_found(const std::string &what) : std::logic_error(what) {} }; ///< The exeption that is thrown when there are no elements found using a filter functor on the targeting sequence
+struct invalid_operation : public std::logic_error { invalid_operation(const std::string &what) : std::logic_error(what) {} }; ///< The exeption that is thrown when there is no complience to the performing action
+
+/**
+    \brief Aggregates for the group_by(keyFunctor, aggregates...) fast path.
+
+    Every aggregate keeps one column: a contiguous array with one state per group, indexed by a dense group id.
+    The first element of a group initializes its state and the following ones update it in place, so no group is materialized.
+
+    Example of usage: \code auto report = from(orders)->group_by([](auto &&o) { return o.Region; }, group::count(), group::sum([](auto &&o) { return o.Total; })); \endcode
+*/
+namespace group
+{
+
+struct aggregate {}; ///< The base of all group aggregates
+
+template<typename T>
+concept Aggregate = std::derived_from<std::decay_t<T>, aggregate>;
+
+struct count_aggregate : public aggregate
+{
+    template<typename T> using state_type = std::size_t;
+
+    template<typename T> auto init(const T &) const -> std::size_t { return 1; }
+    template<typename T> auto update(std::size_t &state, const T &) const -> void { ++state; }
+    auto result(std::size_t state, std::size_t) const { return state; }
+};
+
+template<typename SelectFunctor>
+struct sum_aggregate : public aggregate
+{
+    template<typename T> using state_type = std::decay_t<std::invoke_result_t<const SelectFunctor&, const T&>>;
+
+    template<typename T> auto init(const T &v) const -> state_type<T> { return selectFunctor(v); }
+    template<typename T> auto update(state_type<T> &state, const T &v) const -> void { state = state + selectFunctor(v); }
+    template<typename State> auto result(const State &state, std::size_t) const { return state; }
+
+    SelectFunctor selectFunctor;
+};
+
+template<typename SelectFunctor>
+struct avarage_aggregate : public sum_aggregate<SelectFunctor>
+{
+    template<typename State> auto result(const State &state, std::size_t count) const { return state / static_cast<State>(count); }
+};
+
+template<typename SelectFunctor, typename CompareFunctor>
+struct extremum_aggregate : public aggregate
+{
+    template<typename T> using state_type = std::decay_t<std::invoke_result_t<const SelectFunctor&, const T&>>;
+
+    template<typename T> auto init(const T &v) const -> state_type<T> { return selectFunctor(v); }
+
+    template<typename T>
+    auto update(state_type<T> &state, const T &v) const -> void
+    {
+        auto &&value = selectFunctor(v);
+
+        if (compareFunctor(value, state)) state = std::forward<decltype(value)>(value);
+    }
+
+    template<typename State> auto result(const State &state, std::size_t) const { return state; }
+
+    SelectFunctor selectFunctor;
+    CompareFunctor compareFunctor;
+};
+
+inline auto count() { return count_aggregate {}; }
+
+template<typename SelectFunctor = std::identity>
+auto sum(SelectFunctor selectFunctor = {}) { return sum_aggregate<SelectFunctor> { {}, std::move(selectFunctor) }; }
+
+template<typename SelectFunctor = std::identity>
+auto avarage(SelectFunctor selectFunctor = {}) { return avarage_aggregate<SelectFunctor> { { {}, std::move(selectFunctor) } }; }
+
+template<typename SelectFunctor = std::identity>
+auto min(SelectFunctor selectFunctor = {}) { return extremum_aggregate<SelectFunctor, std::less<>> { {}, std::move(selectFunctor), {} }; }
+
+template<typename SelectFunctor = std::identity>
+auto max(SelectFunctor selectFunctor = {}) { return extremum_aggregate<SelectFunctor, std::greater<>> { {}, std::move(selectFunctor), {} }; }
+
+}
+
+/**
+    \brief Reduction kernels for contiguous sequences of arithmetic values.
+
+    sum, min, max, avarage and contains(value) of a relinx_object over a contiguous range (a vector, an array, a pointer range, range())
+    dispatch here instead of walking the iterators one element at a time. count(value) stays on std::count, which the compiler vectorizes
+    on its own, and the predicate overloads keep calling the predicate element by element.
+    The vector tier is picked at compile time: AVX2 when the target enables it, SSE2 on any x86-64 target and the standard algorithms otherwise
+    (or when RELINX_NO_SIMD is defined). Floating point sums are reassociated across lanes, so they may differ from the sequential sum
+    in the last bits, and min and max leave the order of NaNs unspecified.
+*/
+namespace detail::simd
+{
+
+template<typename T> struct lanes { };
+
+#if defined(RELINX_SIMD_AVX2)
+
+template<>
+struct lanes<double>
+{
+    using vector = __m256d;
+
+    static auto load(const double *p) noexcept { return _mm256_loadu_pd(p); }
+    static auto store(double *p, vector v) noexcept { _mm256_storeu_pd(p, v); }
+    static auto broadcast(double v) noexcept { return _mm256_set1_pd(v); }
+    static auto add(vector a, vector b) noexcept { return _mm256_add_pd(a, b); }
+    static auto min(vector a, vector b) noexcept { return _mm256_min_pd(a, b); }
+    static auto max(vector a, vector b) noexcept { return _mm256_max_pd(a, b); }
+    static auto equal(vector a, vector b) noexcept -> unsigned { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))); }
+};
+
+template<>
+struct lanes<float>
+{
+    using vector = __m256;
+
+    static auto load(const float *p) noexcept { return _mm256_loadu_ps(p); }
+    static auto store(float *p, vector v) noexcept { _mm256_storeu_ps(p, v); }
+    static auto broadcast(float v) noexcept { return _mm256_set1_ps(v); }
+    static auto add(vector a, vector b) noexcept { return _mm256_add_ps(a, b); }
+    static auto min(vector a, vector b) noexcept { return _mm256_min_ps(a, b); }
+    static auto max(vector a, vector b) noexcept { return _mm256_max_ps(a, b); }
+    static auto equal(vector a, vector b) noexcept -> unsigned { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+};
+
+template<std::integral T> requires (sizeof(T) == 4)
+struct lanes<T>
+{
+    using vector = __m256i;
+
+    static auto load(const T *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static auto store(T *p, vector v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static auto broadcast(T v) noexcept { return _mm256_set1_epi32(static_cast<int>(v)); }
+    static auto add(vector a, vector b) noexcept { return _mm256_add_epi32(a, b); }
+    static auto min(vector a, vector b) noexcept { if constexpr (std::is_signed_v<T>) return _mm256_min_epi32(a, b); else return _mm256_min_epu32(a, b); }
+    static auto max(vector a, vector b) noexcept { if constexpr (std::is_signed_v<T>) return _mm256_max_epi32(a, b); else return _mm256_max_epu32(a, b); }
+    static auto equal(vector a, vector b) noexcept -> unsigned { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+};
+
+template<std::integral T> requires (sizeof(T) == 8)
+struct lanes<T>
+{
+    using vector = __m256i;
+
+    static auto load(const T *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static auto store(T *p, vector v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static auto broadcast(T v) noexcept { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+    static auto add(vector a, vector b) noexcept { return _mm256_add_epi64(a, b); }
+    static auto min(vector a, vector b) noexcept requires std::is_signed_v<T> { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static auto max(vector a, vector b) noexcept requires std::is_signed_v<T> { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    static auto equal(vector a, vector b) noexcept -> unsigned { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)))); }
+};
+
+#elif defined(RELINX_SIMD_SSE2)
+
+template<>
+struct lanes<double>
+{
+    using vector = __m128d;
+
+    static auto load(const double *p) noexcept { return _mm_loadu_pd(p); }
+    static auto store(double *p, vector v) noexcept { _mm_storeu_pd(p, v); }
+    static auto broadcast(double v) noexcept { return _mm_set1_pd(v); }
+    static auto add(vector a, vector b) noexcept { return _mm_add_pd(a, b); }
+    static auto min(vector a, vector b) noexcept { return _mm_min_pd(a, b); }
+    static auto max(vector a, vector b) noexcept { return _mm_max_pd(a, b); }
+    static auto equal(vector a, vector b) noexcept -> unsigned { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b))); }
+};
+
+template<>
+struct lanes<float>
+{
+    using vector = __m128;
+
+    static auto load(const float *p) noexcept { return _mm_loadu_ps(p); }
+    static auto store(float *p, vector v) noexcept { _mm_storeu_ps(p, v); }
+    static auto broadcast(float v) noexcept { return _mm_set1_ps(v); }
+    static auto add(vector a, vector b) noexcept { return _mm_add_ps(a, b); }
+    static auto min(vector a, vector b) noexcept { return _mm_min_ps(a, b); }
+    static auto max(vector a, vector b) noexcept { return _mm_max_ps(a, b); }
+    static auto equal(vector a, vector b) noexcept -> unsigned { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+};
+
+template<std::integral T> requires (sizeof(T) == 4)
+struct lanes<T>
+{
+    using vector = __m128i;
+
+    static auto load(const T *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static auto store(T *p, vector v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static auto broadcast(T v) noexcept { return _mm_set1_epi32(static_cast<int>(v)); }
+    static auto add(vector a, vector b) noexcept { return _mm_add_epi32(a, b); }
+    static auto equal(vector a, vector b) noexcept -> unsigned { return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))); }
+};
+
+template<std::integral T> requires (sizeof(T) == 8)
+struct lanes<T>
+{
+    using vector = __m128i;
+
+    static auto load(const T *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static auto store(T *p, vector v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static auto broadcast(T v) noexcept { return _mm_set1_epi64x(static_cast<long long>(v)); }
+    static auto add(vector a, vector b) noexcept { return _mm_add_epi64(a, b); }
+};
+
+#endif
+
+template<typename T>
+concept Summable = requires(typename lanes<T>::vector v) { lanes<T>::add(v, v); };
+
+template<typename T>
+concept Ordered = requires(typename lanes<T>::vector v) { lanes<T>::min(v, v); lanes<T>::max(v, v); };
+
+template<typename T>
+concept Comparable = requires(typename lanes<T>::vector v) { lanes<T>::equal(v, v); };
+
+template<typename T>
+constexpr std::ptrdiff_t width { static_cast<std::ptrdiff_t>(sizeof(typename lanes<T>::vector) / sizeof(T)) };
+
+template<typename T>
+auto sum(const T *first, const T *last) noexcept -> T
+{
+    using l = lanes<T>;
+
+    // four independent accumulators hide the latency of the vector add
+    auto acc0 { l::broadcast(T()) }, acc1 { acc0 }, acc2 { acc0 }, acc3 { acc0 };
+
+    for (; last - first >= 4 * width<T>; first += 4 * width<T>)
+    {
+        acc0 = l::add(acc0, l::load(first));
+        acc1 = l::add(acc1, l::load(first + width<T>));
+        acc2 = l::add(acc2, l::load(first + 2 * width<T>));
+        acc3 = l::add(acc3, l::load(first + 3 * width<T>));
+    }
+
+    for (; last - first >= width<T>; first += width<T>) acc0 = l::add(acc0, l::load(first));
+
+    std::array<T, width<T>> partial;
+
+    l::store(partial.data(), l::add(l::add(acc0, acc1), l::add(acc2, acc3)));
+
+    T result { std::accumulate(std::begin(partial), std::end(partial), T()) };
+
+    for (; first != last; ++first) result = result + *first;
+
+    return result;
+}
+
+template<bool Maximum, typename T>
+auto extremum(const T *first, const T *last) noexcept -> T
+{
+    using l = lanes<T>;
+
+    auto pick = [](const T &a, const T &b) { return Maximum ? (b > a ? b : a) : (b < a ? b : a); };
+    T result { *first };
+
+    if (last - first >= width<T>)
+    {
+        auto acc { l::load(first) };
+
+        for (first += width<T>; last - first >= width<T>; first += width<T>) acc = Maximum ? l::max(acc, l::load(first)) : l::min(acc, l::load(first));
+
+        std::array<T, width<T>> partial;
+
+        l::store(partial.data(), acc);
+
+        result = std::accumulate(std::begin(partial), std::end(partial), partial.front(), pick);
+    }
+
+    for (; first != last; ++first) result = pick(result, *first);
+
+    return result;
+}
+
+template<typename T>
+auto contains(const T *first, const T *last, const T &value) noexcept -> bool
+{
+    using l = lanes<T>;
+
+    const auto needle { l::broadcast(value) };
+
+    for (; last - first >= 4 * width<T>; first += 4 * width<T>)
+    {
+        if (l::equal(l::load(first), needle) | l::equal(l::load(first + width<T>), needle) |
+            l::equal(l::load(first + 2 * width<T>), needle) | l::equal(l::load(first + 3 * width<T>), needle)) break;
+    }
+
+    for (; last - first >= width<T>; first += width<T>) if (l::equal(l::load(first), needle)) return true;
+
+    return std::find(first, last, value) != last;
+}
+
+}
+
+template<typename ParentRelinxType, typename Ordering> class relinx_object_ordered;
+
+template<typename ParentRelinxType, typename Iterator, typename ContainerType = default_container<typename std::decay<decltype(*Iterator())>::type>>
+class relinx_object : public std::enable_shared_from_this<relinx_object<ParentRelinxType, Iterator, ContainerType>>
+{
+public:
+    using self_type = relinx_object<ParentRelinxType, Iterator, ContainerType>;
+    using value_type = typename std::decay<decltype(*Iterator())>::type;
+    using iterator_type = typename std::decay<Iterator>::type;
+
+    relinx_object() = delete;
+    relinx_object(const relinx_object &) = delete;
+    auto operator =(const relinx_object &) -> relinx_object & = delete;
+    relinx_object(relinx_object &&) = default;
+
+    relinx_object(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, const iterator_type &begin, const iterator_type &end) noexcept : _begin(begin), _end(end), _parent_relinx_object_ptr(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr)) { }
+    relinx_object(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, iterator_type &&begin, iterator_type &&end) noexcept : _begin(std::forward<iterator_type>(begin)), _end(std::forward<iterator_type>(end)), _parent_relinx_object_ptr(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr)) { }
+    relinx_object(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, ContainerType &&container) noexcept : _container(std::forward<ContainerType>(container)), _begin(std::begin(_container)), _end(std::end(_container)), _parent_relinx_object_ptr(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr)) { }
+
+    ~relinx_object() noexcept = default;
+
+    auto begin() const noexcept
     {
         return _begin;
     }
@@ -1312,7 +2171,7 @@ public:
     */
     auto avarage() const noexcept
     {
-        return avarage([](auto &&v){ return v; });
+        return sum() / std::distance(_begin, _end);
     }
 
     /**
@@ -1412,7 +2271,13 @@ public:
     */
     auto contains(value_type &&value) const noexcept
     {
-        return std::find(_begin, _end, value) != _end;
+        if constexpr (_contiguous && detail::simd::Comparable<value_type>)
+        {
+            auto [first, last] = _bounds();
+
+            return detail::simd::contains(first, last, value);
+        }
+        else return std::find(_begin, _end, value) != _end;
     }
 
     /**
@@ -1608,21 +2473,47 @@ public:
         \param container A container whose elements that also occur in the current relinx_object's sequence will cause those elements to be removed from the resulted relinx_object.
         \param compareFunctor A functor to compare values. By default, elements are compared using type's operator ==.
 
+        \note Without a compareFunctor and with hashable elements, the elements to remove are copied into a hash set when the returned relinx_object
+        is created, so checking an element of the current sequence is one lookup rather than a pass over the container.
+
         \return A relinx_object that contains the set difference of the elements of two sequences.
     */
     template<typename Container>
-    auto except(Container &&container, std::function<bool(const value_type&, const value_type&)> &&compareFunctor = [](auto &&a, auto &&b) { return a == b; }) noexcept
+    auto except(Container &&container) noexcept
     {
-        using adapter_type = except_iterator_adapter<iterator_type, decltype(std::begin(container)), std::function<bool(const value_type&, const value_type&)>>;
-        using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
+        using otherType = typename std::decay<decltype(*std::begin(container))>::type;
 
-        auto end_it = std::end(container);
+        if constexpr (HashJoinable<std::equal_to<>, value_type, otherType>)
+        {
+            using adapter_type = hash_except_iterator_adapter<iterator_type, decltype(std::begin(container))>;
+            using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
 
-        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), adapter_type(_begin, _end, std::begin(container), end_it, std::forward<std::function<bool(const value_type&, const value_type&)>>(compareFunctor)), adapter_type(_end, _end, end_it, end_it, nullptr));
-    }
+            auto end_it = std::end(container);
+
+            return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), adapter_type(_begin, _end, std::begin(container), end_it), adapter_type(_end, _end, end_it, end_it));
+        }
+        else return except(std::forward<Container>(container), [](auto &&a, auto &&b) { return a == b; });
+    }
+
+    template<typename Container>
+    auto except(Container &&container, std::function<bool(const value_type&, const value_type&)> &&compareFunctor) noexcept
+    {
+        using adapter_type = except_iterator_adapter<iterator_type, decltype(std::begin(container)), std::function<bool(const value_type&, const value_type&)>>;
+        using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
+
+        auto end_it = std::end(container);
+
+        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), adapter_type(_begin, _end, std::begin(container), end_it, std::forward<std::function<bool(const value_type&, const value_type&)>>(compareFunctor)), adapter_type(_end, _end, end_it, end_it, nullptr));
+    }
+
+    template<typename T>
+    auto except(std::initializer_list<T> &&container) noexcept
+    {
+        return except<std::initializer_list<T>>(std::forward<std::initializer_list<T>>(container));
+    }
 
     template<typename T>
-    auto except(std::initializer_list<T> &&container, std::function<bool(const value_type&, const value_type&)> &&compareFunctor = [](auto &&a, auto &&b) { return a == b; }) noexcept
+    auto except(std::initializer_list<T> &&container, std::function<bool(const value_type&, const value_type&)> &&compareFunctor) noexcept
     {
         return except<std::initializer_list<T>>(std::forward<std::initializer_list<T>>(container), std::forward<std::function<bool(const value_type&, const value_type&)>>(compareFunctor));
     }
@@ -1748,6 +2639,70 @@ public:
         return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), std::move(group_map));
     }
 
+    /** \brief Groups the elements of a sequence by a key and computes aggregates for every group in a single pass.
+
+        Groups the elements of a sequence by a key and computes aggregates for every group in a single pass.
+        Keys are hashed into dense group ids and every aggregate accumulates into its own contiguous column, the groups themselves are never materialized.
+
+        \param keyFunctor A key selector functor.
+        \param aggregates The aggregates to compute: group::count(), group::sum(f), group::avarage(f), group::min(f) and group::max(f).
+
+        \return A relinx_object of std::tuple<key, aggregate results...> in the order in which the keys first appear in the sequence.
+
+        Example: \code auto result = from({1, 2, 3, 4, 5})->group_by([](auto &&v) { return v % 2; }, group::count(), group::sum()); \endcode the result is {(1, 3, 9), (0, 2, 6)}
+    */
+    template<typename KeyFunctor, group::Aggregate ...Aggregates>
+    requires (sizeof...(Aggregates) > 0)
+    auto group_by(KeyFunctor &&keyFunctor, Aggregates &&...aggregates)
+    {
+        using KeyType = typename std::decay<std::invoke_result_t<KeyFunctor&, const value_type&>>::type;
+        using columns_type = std::tuple<default_container<typename std::decay_t<Aggregates>::template state_type<value_type>>...>;
+
+        default_map<KeyType, std::size_t> group_ids;
+        default_container<KeyType> keys;
+        default_container<std::size_t> counts;
+        columns_type columns;
+
+        auto begin = _begin;
+        auto end = _end;
+
+        while (begin != end)
+        {
+            const auto &value = *begin;
+            auto [group, inserted] = group_ids.try_emplace(keyFunctor(value), keys.size());
+            auto id = group->second;
+
+            if (inserted)
+            {
+                keys.push_back(group->first);
+                counts.push_back(1);
+                std::apply([&](auto &...column) { (column.push_back(aggregates.init(value)), ...); }, columns);
+            }
+            else
+            {
+                ++counts[id];
+                std::apply([&](auto &...column) { (aggregates.update(column[id], value), ...); }, columns);
+            }
+
+            ++begin;
+        }
+
+        using result_type = std::tuple<KeyType, decltype(aggregates.result(std::declval<typename std::decay_t<Aggregates>::template state_type<value_type>&>(), std::size_t()))...>;
+
+        default_container<result_type> result;
+
+        result.reserve(keys.size());
+
+        for (std::size_t id = 0; id < keys.size(); ++id)
+        {
+            result.push_back(std::apply([&](auto &...column) { return result_type { std::move(keys[id]), aggregates.result(column[id], counts[id])... }; }, columns));
+        }
+
+        using next_relinx_type = relinx_object<self_type, typename default_container<result_type>::iterator, default_container<result_type>>;
+
+        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), std::move(result));
+    }
+
     /** \brief Correlates the elements of two sequences based on key equality, and groups the results.
 
         Correlates the elements of two sequences based on key equality, and groups the results.
@@ -1760,6 +2715,9 @@ public:
         \param leftJoin If true, then it keeps elements that are not matched in join operation.
 
         \note This method produces a lazy evaluation relinx_object.
+        \note With std::equal_to as compareFunctor and both keys of the same hashable type, the container's elements are copied into one group per key
+        when the returned relinx_object is created, and every element of the current sequence takes its group from there. Without leftJoin,
+        an empty container gives an empty result and the current sequence is never read.
 
         \return A relinx_object that contains joined and grouped elements.
     */
@@ -1771,41 +2729,59 @@ public:
         using thisKeyType = typename std::decay<decltype(thisKeyFunctor(value_type()))>::type;
         using otherKeyType = typename std::decay<decltype(otherKeyFunctor(joinType()))>::type;
         using resultType = typename std::decay<decltype(resultFunctor(value_type(), default_container<joinType>()))>::type;
-        using adapter_type = group_join_iterator_adapter<iterator_type,
+        if constexpr (HashJoinable<CompareFunctor, thisKeyType, otherKeyType>)
+        {
+            using hash_adapter_type = hash_group_join_iterator_adapter<iterator_type,
                                                     joinIteratorType,
                                                     std::function<thisKeyType(const value_type&)>,
                                                     std::function<otherKeyType(const joinType&)>,
-                                                    std::function<resultType(const value_type&, const default_container<joinType>&)>,
-                                                    std::function<bool(const thisKeyType&, const otherKeyType&)>>;
-        using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
+                                                    std::function<resultType(const value_type&, const default_container<joinType>&)>>;
+            using next_relinx_type = relinx_object<self_type, hash_adapter_type, ContainerType>;
 
-        auto end_it = std::end(container);
+            auto end_it = std::end(container);
 
-        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(),
-                                       adapter_type
-                                            (
-                                                _begin,
-                                                _end,
-                                                std::begin(container),
-                                                end_it,
-                                                std::forward<ThisKeyFunctor>(thisKeyFunctor),
-                                                std::forward<OtherKeyFunctor>(otherKeyFunctor),
-                                                std::forward<ResultFunctor>(resultFunctor),
-                                                std::forward<CompareFunctor>(compareFunctor),
-                                                leftJoin
-                                             ),
-                                       adapter_type
-                                             (
-                                                _end,
-                                                _end,
-                                                end_it,
-                                                end_it,
-                                                nullptr,
-                                                nullptr,
-                                                nullptr,
-                                                nullptr,
-                                                leftJoin
-                                             ));
+            return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(),
+                                           hash_adapter_type(_begin, _end, std::begin(container), end_it, std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), leftJoin),
+                                           hash_adapter_type(_end, _end, end_it, end_it, nullptr, nullptr, nullptr, leftJoin));
+        }
+        else
+        {
+            using adapter_type = group_join_iterator_adapter<iterator_type,
+                                                        joinIteratorType,
+                                                        std::function<thisKeyType(const value_type&)>,
+                                                        std::function<otherKeyType(const joinType&)>,
+                                                        std::function<resultType(const value_type&, const default_container<joinType>&)>,
+                                                        std::function<bool(const thisKeyType&, const otherKeyType&)>>;
+            using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
+
+            auto end_it = std::end(container);
+
+            return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(),
+                                           adapter_type
+                                                (
+                                                    _begin,
+                                                    _end,
+                                                    std::begin(container),
+                                                    end_it,
+                                                    std::forward<ThisKeyFunctor>(thisKeyFunctor),
+                                                    std::forward<OtherKeyFunctor>(otherKeyFunctor),
+                                                    std::forward<ResultFunctor>(resultFunctor),
+                                                    std::forward<CompareFunctor>(compareFunctor),
+                                                    leftJoin
+                                                 ),
+                                           adapter_type
+                                                 (
+                                                    _end,
+                                                    _end,
+                                                    end_it,
+                                                    end_it,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    leftJoin
+                                                 ));
+        }
     }
 
     template<typename T, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
@@ -1835,6 +2811,8 @@ public:
         \param leftJoin If true, then it keeps elements that are not matched in join operation.
 
         \note This method produces a lazy evaluation relinx_object.
+        \note Keys of the same hashable type always take the indexed path here, as operator == is the comparer: the container is grouped by key
+        when the returned relinx_object is created, while the current sequence is still read lazily, one group lookup per element.
 
         \return A relinx_object that contains joined and grouped elements.
     */
@@ -1845,7 +2823,7 @@ public:
                     std::forward<ThisKeyFunctor>(thisKeyFunctor),
                     std::forward<OtherKeyFunctor>(otherKeyFunctor),
                     std::forward<ResultFunctor>(resultFunctor),
-                    [](auto &&a, auto &&b) { return a == b; },
+                    std::equal_to<> {},
                     leftJoin);
     }
 
@@ -1871,11 +2849,29 @@ public:
         \param compareFunctor A functor that compares elements. This parameter is defaulted to functor that uses operator == to compare elements.
 
         \note This method produces a lazy evaluation relinx_object.
+        \note Without a compareFunctor and with hashable elements, the container is put into a hash set once instead of being scanned for every element.
 
         \return A relinx_object that holds a set of intersected elements.
     */
     template<typename Container>
-    auto intersect_with(Container &&container, std::function<bool(const value_type&, const value_type&)> &&compareFunctor = [](auto &&a, auto &&b) { return a == b; }) noexcept
+    auto intersect_with(Container &&container) noexcept
+    {
+        using otherType = typename std::decay<decltype(*std::begin(container))>::type;
+
+        if constexpr (HashJoinable<std::equal_to<>, value_type, otherType>)
+        {
+            using adapter_type = hash_intersect_iterator_adapter<iterator_type, decltype(std::begin(container))>;
+            using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
+
+            auto end_it = std::end(container);
+
+            return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), adapter_type(_begin, _end, std::begin(container), end_it), adapter_type(_end, _end, end_it, end_it));
+        }
+        else return intersect_with(std::forward<Container>(container), [](auto &&a, auto &&b) { return a == b; });
+    }
+
+    template<typename Container>
+    auto intersect_with(Container &&container, std::function<bool(const value_type&, const value_type&)> &&compareFunctor) noexcept
     {
         using adapter_type = intersect_iterator_adapter<iterator_type, decltype(std::begin(container)), std::function<bool(const value_type&, const value_type&)>>;
         using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
@@ -1886,7 +2882,13 @@ public:
     }
 
     template<typename T>
-    auto intersect_with(std::initializer_list<T> &&container, std::function<bool(const value_type&, const value_type&)> &&compareFunctor = [](auto &&a, auto &&b) { return a == b; }) noexcept
+    auto intersect_with(std::initializer_list<T> &&container) noexcept
+    {
+        return intersect_with<std::initializer_list<T>>(std::forward<std::initializer_list<T>>(container));
+    }
+
+    template<typename T>
+    auto intersect_with(std::initializer_list<T> &&container, std::function<bool(const value_type&, const value_type&)> &&compareFunctor) noexcept
     {
         return intersect_with<std::initializer_list<T>>(std::forward<std::initializer_list<T>>(container), std::forward<std::function<bool(const value_type&, const value_type&)>>(compareFunctor));
     }
@@ -1903,6 +2905,10 @@ public:
         \param leftJoin If true, then it keeps elements that are not matched in join operation.
 
         \note This method produces a lazy evaluation relinx_object.
+        \note With std::equal_to as compareFunctor and both keys of the same hashable type, the container is indexed by key when the returned
+        relinx_object is created. The index refers to the container's elements, so the container must outlive the result. The current sequence
+        stays lazy and keeps its order, each of its elements producing its matches in container order; an inner join on an empty container
+        never reads it.
 
         \return A relinx_object that contains joined elements.
     */
@@ -1915,41 +2921,59 @@ public:
         using otherKeyType = typename std::decay<decltype(otherKeyFunctor(joinType()))>::type;
         using resultType = typename std::decay<decltype(resultFunctor(value_type(), joinType()))>::type;
 
-        using adapter_type = join_iterator_adapter<iterator_type,
-                                              joinIteratorType,
-                                              std::function<thisKeyType(const value_type&)>,
-                                              std::function<otherKeyType(const joinType&)>,
-                                              std::function<resultType(const value_type&, const joinType&)>,
-                                              std::function<bool(const thisKeyType&, const otherKeyType&)>>;
-        using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
+        if constexpr (HashJoinable<CompareFunctor, thisKeyType, otherKeyType>)
+        {
+            using hash_adapter_type = hash_join_iterator_adapter<iterator_type,
+                                                    joinIteratorType,
+                                                    std::function<thisKeyType(const value_type&)>,
+                                                    std::function<otherKeyType(const joinType&)>,
+                                                    std::function<resultType(const value_type&, const joinType&)>>;
+            using next_relinx_type = relinx_object<self_type, hash_adapter_type, ContainerType>;
 
-        auto end_it = std::end(container);
+            auto end_it = std::end(container);
 
-        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(),
-                                      adapter_type
-                                            (
-                                                _begin,
-                                                _end,
-                                                std::begin(container),
-                                                end_it,
-                                                std::forward<ThisKeyFunctor>(thisKeyFunctor),
-                                                std::forward<OtherKeyFunctor>(otherKeyFunctor),
-                                                std::forward<ResultFunctor>(resultFunctor),
-                                                std::forward<CompareFunctor>(compareFunctor),
-                                                leftJoin
-                                             ),
-                                      adapter_type
-                                             (
-                                                _end,
-                                                _end,
-                                                end_it,
-                                                end_it,
-                                                nullptr,
-                                                nullptr,
-                                                nullptr,
-                                                nullptr,
-                                                leftJoin
-                                             ));
+            return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(),
+                                           hash_adapter_type(_begin, _end, std::begin(container), end_it, std::forward<ThisKeyFunctor>(thisKeyFunctor), std::forward<OtherKeyFunctor>(otherKeyFunctor), std::forward<ResultFunctor>(resultFunctor), leftJoin),
+                                           hash_adapter_type(_end, _end, end_it, end_it, nullptr, nullptr, nullptr, leftJoin));
+        }
+        else
+        {
+            using adapter_type = join_iterator_adapter<iterator_type,
+                                                  joinIteratorType,
+                                                  std::function<thisKeyType(const value_type&)>,
+                                                  std::function<otherKeyType(const joinType&)>,
+                                                  std::function<resultType(const value_type&, const joinType&)>,
+                                                  std::function<bool(const thisKeyType&, const otherKeyType&)>>;
+            using next_relinx_type = relinx_object<self_type, adapter_type, ContainerType>;
+
+            auto end_it = std::end(container);
+
+            return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(),
+                                          adapter_type
+                                                (
+                                                    _begin,
+                                                    _end,
+                                                    std::begin(container),
+                                                    end_it,
+                                                    std::forward<ThisKeyFunctor>(thisKeyFunctor),
+                                                    std::forward<OtherKeyFunctor>(otherKeyFunctor),
+                                                    std::forward<ResultFunctor>(resultFunctor),
+                                                    std::forward<CompareFunctor>(compareFunctor),
+                                                    leftJoin
+                                                 ),
+                                          adapter_type
+                                                 (
+                                                    _end,
+                                                    _end,
+                                                    end_it,
+                                                    end_it,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    leftJoin
+                                                 ));
+        }
     }
 
     template<typename T, typename ThisKeyFunctor, typename OtherKeyFunctor, typename ResultFunctor, typename CompareFunctor>
@@ -1981,7 +3005,7 @@ public:
                     std::forward<ThisKeyFunctor>(thisKeyFunctor),
                     std::forward<OtherKeyFunctor>(otherKeyFunctor),
                     std::forward<ResultFunctor>(resultFunctor),
-                    [](auto &&a, auto &&b) { return a == b; },
+                    std::equal_to<> {},
                     leftJoin);
     }
 
@@ -2120,7 +3144,13 @@ public:
     {
         if (_begin == _end) throw no_elements("max"s);
 
-        return *std::max_element(_begin, _end);
+        if constexpr (_contiguous && detail::simd::Ordered<value_type>)
+        {
+            auto [first, last] = _bounds();
+
+            return detail::simd::extremum<true>(first, last);
+        }
+        else return *std::max_element(_begin, _end);
     }
 
     /** \brief Invokes a transform functor on each element of a sequence and returns the minimum value.
@@ -2154,7 +3184,13 @@ public:
     {
         if (_begin == _end) throw no_elements("min"s);
 
-        return *std::min_element(_begin, _end);
+        if constexpr (_contiguous && detail::simd::Ordered<value_type>)
+        {
+            auto [first, last] = _bounds();
+
+            return detail::simd::extremum<false>(first, last);
+        }
+        else return *std::min_element(_begin, _end);
     }
 
     /**
@@ -2216,13 +3252,13 @@ public:
     template<typename SelectFunctor, typename SortFunctor>
     auto order_by(SelectFunctor &&selectFunctor, SortFunctor &&sortFunctor) noexcept
     {
-        default_container<value_type> sorted(_begin, _end);
-
-        std::sort(std::begin(sorted), std::end(sorted), [&selectFunctor, &sortFunctor](auto &&a, auto &&b) { return sortFunctor(selectFunctor(a), selectFunctor(b)); });
+        using level_type = sort_level<std::decay_t<SelectFunctor>, std::decay_t<SortFunctor>>;
+        using ordering_type = ordering<iterator_type, level_type>;
+        using next_relinx_type = relinx_object_ordered<self_type, ordering_type>;
 
-        using next_relinx_type = relinx_object_ordered<self_type, decltype(std::begin(sorted)), SelectFunctor>;
+        auto ordering = std::make_shared<ordering_type>(_begin, _end, std::make_tuple(level_type { std::forward<SelectFunctor>(selectFunctor), std::forward<SortFunctor>(sortFunctor) }));
 
-        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), std::move(sorted), std::forward<SelectFunctor>(selectFunctor));
+        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), std::move(ordering));
     }
 
     /** \brief Sorts the elements of a sequence in ascending order according to a key.
@@ -2253,6 +3289,24 @@ public:
         return order_by(std::forward<SelectFunctor>(selectFunctor), std::greater<typename std::decay<decltype(selectFunctor(value_type()))>::type>());
     }
 
+    /** \brief Runs the rest of the query in parallel on a thread pool.
+
+        Runs the rest of the query in parallel on a thread pool. The sequence is split into chunks, every following where, select and select_many runs per chunk,
+        and the terminal operation merges the partial results of the chunks in their order. A non random access sequence is collected into a container first.
+
+        \param pool A thread pool (nstd::thread_pool) to run the chunks on. The calling thread takes part in the work too.
+        \param grain_size The number of elements in a chunk, 0 picks a grain size automatically.
+
+        \note Requires relinx_parallel.hpp.
+
+        \return A parallel_relinx_object that holds the current sequence.
+    */
+    template<typename ThreadPool>
+    auto parallel(ThreadPool &pool, std::size_t grain_size = 0)
+    {
+        return make_parallel(std::enable_shared_from_this<self_type>::shared_from_this(), pool, grain_size);
+    }
+
     /** \brief Inverts the order of the elements in a sequence.
 
         Inverts the order of the elements in a sequence.
@@ -2273,7 +3327,7 @@ public:
 
             std::reverse(std::begin(c), std::end(c));
 
-            using next_relinx_type = relinx_object<self_type, decltype(std::begin(c)), ContainerType>;
+            using next_relinx_type = relinx_object<self_type, decltype(std::begin(c)), decltype(c)>;
 
             return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), std::move(c));
         }
@@ -2591,7 +3645,13 @@ public:
     */
     auto sum() const noexcept
     {
-        return sum([](auto &&v){ return v; });
+        if constexpr (_contiguous && detail::simd::Summable<value_type>)
+        {
+            auto [first, last] = _bounds();
+
+            return detail::simd::sum(first, last);
+        }
+        else return sum([](auto &&v){ return v; });
     }
 
     /** \brief Returns a specified number of contiguous elements from the start of a sequence.
@@ -2871,6 +3931,16 @@ protected:
     Iterator _end;
     std::shared_ptr<ParentRelinxType> _parent_relinx_object_ptr;
 
+    static constexpr bool _contiguous { std::contiguous_iterator<iterator_type> };
+
+    // the source as a plain pointer range for the detail::simd kernels
+    auto _bounds() const noexcept
+    {
+        const value_type *first { std::to_address(_begin) };
+
+        return std::make_pair(first, first + std::distance(_begin, _end));
+    }
+
     template<typename ConditionFunctor>
     auto _last(ConditionFunctor &&conditionFunctor) const noexcept
     {
@@ -2889,82 +3959,56 @@ protected:
     }
 };
 
-template<typename ParentRelinxType, typename Iterator, typename PreviousSelectFunctor>
-class relinx_object_ordered : public relinx_object<ParentRelinxType, Iterator, default_container<typename std::decay<decltype(*Iterator())>::type>>
+template<typename ParentRelinxType, typename Ordering>
+class relinx_object_ordered : public relinx_object<ParentRelinxType, ordered_iterator_adapter<Ordering>, default_container<typename Ordering::value_type>>
 {
 public:
-    using self_type = relinx_object_ordered<ParentRelinxType, Iterator, PreviousSelectFunctor>;
-    using value_type = typename std::decay<decltype(*Iterator())>::type;
+    using self_type = relinx_object_ordered<ParentRelinxType, Ordering>;
+    using value_type = typename Ordering::value_type;
     using container_type = default_container<value_type>;
-    using base = relinx_object<ParentRelinxType, Iterator, container_type>;
+    using iterator_type = ordered_iterator_adapter<Ordering>;
+    using base = relinx_object<ParentRelinxType, iterator_type, container_type>;
 
     relinx_object_ordered() = delete;
     relinx_object_ordered(const self_type &) = delete;
     auto operator =(const self_type &) -> relinx_object_ordered & = delete;
     relinx_object_ordered(self_type &&) = default;
 
-    relinx_object_ordered(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, default_container<value_type> &&ordered, PreviousSelectFunctor &&previousSelectFunctor) noexcept :
-        base(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr), std::begin(ordered), std::end(ordered)),
-        _ordered_values(std::forward<default_container<value_type>>(ordered)),
-        _previousSelectFunctor(std::forward<PreviousSelectFunctor>(previousSelectFunctor))
+    relinx_object_ordered(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, std::shared_ptr<Ordering> &&ordering) noexcept :
+        base(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr), iterator_type(ordering.get(), 0), iterator_type(ordering.get(), iterator_type::end_position)),
+        _ordering(std::forward<std::shared_ptr<Ordering>>(ordering))
         {
         }
 
     ~relinx_object_ordered() noexcept = default;
 
-    auto begin() const noexcept
-    {
-        return std::begin(_ordered_values);
-    }
+    /** \brief Returns a specified number of elements from the start of the ordered sequence.
 
-    auto end() const noexcept
-    {
-        return std::end(_ordered_values);
-    }
+        Returns a specified number of elements from the start of the ordered sequence.
+        Unless the sequence has been sorted already, only the smallest elements are kept on a bounded heap while the source is read,
+        that takes O(N log limit) time and O(limit) memory instead of sorting the whole sequence.
 
-    template<typename SelectFunctor, typename SortFunctor>
-    auto order_by(SelectFunctor &&selectFunctor, SortFunctor &&sortFunctor)
-    {
-        std::sort(std::begin(_ordered_values), std::end(_ordered_values), [&selectFunctor, &sortFunctor](auto &&a, auto &&b) { return sortFunctor(selectFunctor(a), selectFunctor(b)); });
-
-        using next_relinx_type = relinx_object_ordered<self_type, Iterator, SelectFunctor>;
-
-        return std::make_shared<next_relinx_type>(std::static_pointer_cast<self_type>(std::enable_shared_from_this<base>::shared_from_this()), std::move(_ordered_values), std::forward<SelectFunctor>(selectFunctor));
-    }
+        \param limit The number of elements to return.
 
-    template<typename SelectFunctor = std::function<value_type(const value_type&)>>
-    auto order_by(SelectFunctor &&selectFunctor = [](auto &&v) { return v; })
+        \return A relinx_object that contains the specified number of elements from the start of the ordered sequence.
+    */
+    auto take(std::ptrdiff_t limit)
     {
-        return order_by(std::forward<SelectFunctor>(selectFunctor), std::less<typename std::decay<decltype(selectFunctor(value_type()))>::type>());
-    }
+        using next_relinx_type = relinx_object<self_type, typename container_type::iterator, container_type>;
 
-    template<typename SelectFunctor = std::function<value_type(const value_type&)>>
-    auto order_by_descending(SelectFunctor &&selectFunctor = [](auto &&v) { return v; })
-    {
-        return order_by(std::forward<SelectFunctor>(selectFunctor), std::greater<typename std::decay<decltype(selectFunctor(value_type()))>::type>());
+        auto count = limit < 0 ? iterator_type::end_position : static_cast<std::size_t>(limit);
+
+        return std::make_shared<next_relinx_type>(std::static_pointer_cast<self_type>(std::enable_shared_from_this<base>::shared_from_this()), _ordering->top(count));
     }
 
     template<typename SelectFunctor, typename SortFunctor>
     auto then_by(SelectFunctor &&selectFunctor, SortFunctor &&sortFunctor)
     {
-        auto begin = std::begin(_ordered_values);
-        auto end = std::end(_ordered_values);
-        decltype(begin) prev_begin;
-
-        while (begin != end)
-        {
-            const auto &&partition_value = _previousSelectFunctor(*begin);
-
-            prev_begin = begin;
+        using level_type = sort_level<std::decay_t<SelectFunctor>, std::decay_t<SortFunctor>>;
+        using next_ordering_type = typename decltype(_ordering->then(std::declval<level_type>()))::element_type;
+        using next_relinx_type = relinx_object_ordered<self_type, next_ordering_type>;
 
-            while (begin != end && _previousSelectFunctor(*begin) == partition_value) ++begin;
-
-            std::sort(prev_begin, begin, [&sortFunctor, &selectFunctor](auto &&a, auto &&b) { return sortFunctor(selectFunctor(a), selectFunctor(b)); });
-        }
-
-        using next_relinx_type = relinx_object_ordered<self_type, Iterator, SelectFunctor>;
-
-        return std::make_shared<next_relinx_type>(std::static_pointer_cast<self_type>(std::enable_shared_from_this<base>::shared_from_this()), std::move(_ordered_values), std::forward<SelectFunctor>(selectFunctor));
+        return std::make_shared<next_relinx_type>(std::static_pointer_cast<self_type>(std::enable_shared_from_this<base>::shared_from_this()), _ordering->then(level_type { std::forward<SelectFunctor>(selectFunctor), std::forward<SortFunctor>(sortFunctor) }));
     }
 
     template<typename SelectFunctor = std::function<value_type(const value_type&)>>
@@ -2980,8 +4024,7 @@ public:
     }
 
 protected:
-    default_container<value_type> _ordered_values;
-    PreviousSelectFunctor _previousSelectFunctor;
+    std::shared_ptr<Ordering> _ordering;
 };
 
 template<typename Container>
@@ -3091,4 +4134,469 @@ auto repeat(T e, std::size_t count)
     return std::make_shared<next_relinx_type>(std::shared_ptr<void>(nullptr), std::move(c));
 }
 
+/**
+    \brief Value-semantic relinx pipelines composed with operator |.
+
+    The stages keep the names of the relinx_object methods but are plain values: nothing is allocated per stage and no functor is type-erased.
+    A terminal operation wraps its sink into every stage once and then pushes the source elements through that chain in a single loop,
+    so the compiler sees the whole query as one inlined loop body. Every sink returns false to stop the loop early.
+
+    Example of usage: \code using namespace nstd::relinx::pipe; auto result = values | where([](auto &&v) { return v % 2; }) | select([](auto &&v) { return v * v; }) | take(3) | sum(); \endcode
+*/
+namespace pipe
+{
+
+struct stage {}; ///< The base of all pipeline stages
+struct terminal {}; ///< The base of all terminal operations
+
+template<typename T>
+concept Stage = std::derived_from<std::decay_t<T>, stage>;
+
+template<typename T>
+concept Terminal = std::derived_from<std::decay_t<T>, terminal>;
+
+template<typename T, typename ...Stages>
+struct stage_value { using type = T; };
+
+template<typename T, typename First, typename ...Rest>
+struct stage_value<T, First, Rest...> { using type = typename stage_value<typename First::template value_type<T>, Rest...>::type; };
+
+template<typename Source, typename ...Stages>
+class pipeline
+{
+public:
+    using self_type = pipeline<Source, Stages...>;
+    using source_value_type = std::ranges::range_value_t<Source>;
+    using value_type = typename stage_value<source_value_type, Stages...>::type;
+
+    pipeline(Source source, std::tuple<Stages...> stages) : _source(std::move(source)), _stages(std::move(stages)) { }
+
+    template<Stage NextStage>
+    auto then(NextStage &&nextStage) const & -> pipeline<Source, Stages..., std::decay_t<NextStage>>
+    {
+        return { _source, std::tuple_cat(_stages, std::make_tuple(std::forward<NextStage>(nextStage))) };
+    }
+
+    template<Stage NextStage>
+    auto then(NextStage &&nextStage) && -> pipeline<Source, Stages..., std::decay_t<NextStage>>
+    {
+        return { std::move(_source), std::tuple_cat(std::move(_stages), std::make_tuple(std::forward<NextStage>(nextStage))) };
+    }
+
+    template<typename Sink>
+    auto push(Sink &&sink) -> void
+    {
+        auto head { wrap<0, source_value_type>(std::forward<Sink>(sink)) };
+
+        for (const auto &v : _source) if (!head(v)) break;
+    }
+
+    // pushes the [first, last) positions of a random access source only, several chunks may be pushed concurrently
+    template<typename Sink> requires std::ranges::random_access_range<const Source>
+    auto push(Sink &&sink, std::size_t first, std::size_t last) const -> void
+    {
+        auto head { wrap<0, source_value_type>(std::forward<Sink>(sink)) };
+        auto begin { std::ranges::begin(_source) };
+
+        for (auto it { begin + first }, end { begin + last }; it != end; ++it) if (!head(*it)) break;
+    }
+
+    auto size() const
+    {
+        return static_cast<std::size_t>(std::ranges::distance(_source));
+    }
+
+protected:
+    Source _source;
+    std::tuple<Stages...> _stages;
+
+    template<std::size_t Index, typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        if constexpr (Index == sizeof...(Stages)) return std::forward<Sink>(sink);
+        else
+        {
+            using stage_type = std::tuple_element_t<Index, std::tuple<Stages...>>;
+
+            return std::get<Index>(_stages).template wrap<T>(wrap<Index + 1, typename stage_type::template value_type<T>>(std::forward<Sink>(sink)));
+        }
+    }
+};
+
+template<std::ranges::viewable_range Range>
+auto from(Range &&range)
+{
+    using source_type = std::views::all_t<Range>;
+
+    return pipeline<source_type> { std::views::all(std::forward<Range>(range)), {} };
+}
+
+template<typename T>
+auto from(std::initializer_list<T> &&i)
+{
+    return from(default_container<T>(i));
+}
+
+template<typename Pipeline, Stage NextStage> requires SpecializationOf<std::decay_t<Pipeline>, pipeline>
+auto operator |(Pipeline &&p, NextStage &&nextStage)
+{
+    return std::forward<Pipeline>(p).then(std::forward<NextStage>(nextStage));
+}
+
+template<std::ranges::viewable_range Range, Stage NextStage> requires (!SpecializationOf<std::decay_t<Range>, pipeline>)
+auto operator |(Range &&range, NextStage &&nextStage)
+{
+    return from(std::forward<Range>(range)).then(std::forward<NextStage>(nextStage));
+}
+
+template<typename Pipeline, Terminal Operation> requires SpecializationOf<std::decay_t<Pipeline>, pipeline>
+auto operator |(Pipeline &&p, Operation &&operation)
+{
+    auto local { std::forward<Pipeline>(p) };
+
+    return operation(local);
+}
+
+template<std::ranges::viewable_range Range, Terminal Operation> requires (!SpecializationOf<std::decay_t<Range>, pipeline>)
+auto operator |(Range &&range, Operation &&operation)
+{
+    auto local { from(std::forward<Range>(range)) };
+
+    return operation(local);
+}
+
+template<typename Functor>
+struct terminal_operation : public terminal
+{
+    Functor functor;
+
+    terminal_operation(Functor f) : functor(std::move(f)) { }
+
+    template<typename Pipeline>
+    auto operator()(Pipeline &p) const
+    {
+        return functor(p);
+    }
+};
+
+template<typename Functor>
+terminal_operation(Functor) -> terminal_operation<Functor>;
+
+template<typename FilterFunctor>
+struct where_stage : public stage
+{
+    FilterFunctor filterFunctor;
+
+    template<typename T>
+    using value_type = T;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        return [sink = std::forward<Sink>(sink), filterFunctor = filterFunctor](const T &v) mutable { return !filterFunctor(v) || sink(v); };
+    }
+};
+
+template<typename TransformFunctor>
+struct select_stage : public stage
+{
+    TransformFunctor transformFunctor;
+
+    template<typename T>
+    using value_type = std::decay_t<std::invoke_result_t<const TransformFunctor&, const T&>>;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        return [sink = std::forward<Sink>(sink), transformFunctor = transformFunctor](const T &v) mutable { return sink(transformFunctor(v)); };
+    }
+};
+
+template<typename ContainerSelectorFunctor>
+struct select_many_stage : public stage
+{
+    ContainerSelectorFunctor containerSelectorFunctor;
+
+    template<typename T>
+    using value_type = std::ranges::range_value_t<std::decay_t<std::invoke_result_t<const ContainerSelectorFunctor&, const T&>>>;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        return [sink = std::forward<Sink>(sink), containerSelectorFunctor = containerSelectorFunctor](const T &v) mutable
+        {
+            for (const auto &i : containerSelectorFunctor(v)) if (!sink(i)) return false;
+
+            return true;
+        };
+    }
+};
+
+template<typename LimitFunctor>
+struct take_while_stage : public stage
+{
+    LimitFunctor limitFunctor;
+
+    template<typename T>
+    using value_type = T;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        return [sink = std::forward<Sink>(sink), limitFunctor = limitFunctor](const T &v) mutable { return limitFunctor(v) && sink(v); };
+    }
+};
+
+struct take_stage : public stage
+{
+    std::size_t limit;
+
+    template<typename T>
+    using value_type = T;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        return [sink = std::forward<Sink>(sink), limit = limit](const T &v) mutable { return limit > 0 && sink(v) && --limit > 0; };
+    }
+};
+
+template<typename SkipFunctor>
+struct skip_while_stage : public stage
+{
+    SkipFunctor skipFunctor;
+
+    template<typename T>
+    using value_type = T;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        return [sink = std::forward<Sink>(sink), skipFunctor = skipFunctor, skipping = true](const T &v) mutable { return (skipping && (skipping = skipFunctor(v))) || sink(v); };
+    }
+};
+
+struct skip_stage : public stage
+{
+    std::size_t skip;
+
+    template<typename T>
+    using value_type = T;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        return [sink = std::forward<Sink>(sink), skip = skip](const T &v) mutable { return skip > 0 ? (--skip, true) : sink(v); };
+    }
+};
+
+template<typename KeyFunctor>
+struct distinct_stage : public stage
+{
+    KeyFunctor keyFunctor;
+
+    template<typename T>
+    using value_type = T;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        using key_type = std::decay_t<std::invoke_result_t<const KeyFunctor&, const T&>>;
+
+        return [sink = std::forward<Sink>(sink), keyFunctor = keyFunctor, processed = default_set<key_type>()](const T &v) mutable { return !processed.insert(keyFunctor(v)).second || sink(v); };
+    }
+};
+
+template<typename TeeFunctor>
+struct tee_stage : public stage
+{
+    TeeFunctor teeFunctor;
+
+    template<typename T>
+    using value_type = T;
+
+    template<typename T, typename Sink>
+    auto wrap(Sink &&sink) const
+    {
+        return [sink = std::forward<Sink>(sink), teeFunctor = teeFunctor](const T &v) mutable { teeFunctor(v); return sink(v); };
+    }
+};
+
+template<typename FilterFunctor>
+auto where(FilterFunctor &&filterFunctor) { return where_stage<std::decay_t<FilterFunctor>> { {}, std::forward<FilterFunctor>(filterFunctor) }; }
+
+template<typename TransformFunctor>
+auto select(TransformFunctor &&transformFunctor) { return select_stage<std::decay_t<TransformFunctor>> { {}, std::forward<TransformFunctor>(transformFunctor) }; }
+
+template<typename ContainerSelectorFunctor>
+auto select_many(ContainerSelectorFunctor &&containerSelectorFunctor) { return select_many_stage<std::decay_t<ContainerSelectorFunctor>> { {}, std::forward<ContainerSelectorFunctor>(containerSelectorFunctor) }; }
+
+template<typename LimitFunctor>
+auto take_while(LimitFunctor &&limitFunctor) { return take_while_stage<std::decay_t<LimitFunctor>> { {}, std::forward<LimitFunctor>(limitFunctor) }; }
+
+inline auto take(std::size_t limit) { return take_stage { {}, limit }; }
+
+template<typename SkipFunctor>
+auto skip_while(SkipFunctor &&skipFunctor) { return skip_while_stage<std::decay_t<SkipFunctor>> { {}, std::forward<SkipFunctor>(skipFunctor) }; }
+
+inline auto skip(std::size_t skip) { return skip_stage { {}, skip }; }
+
+template<typename KeyFunctor = std::identity>
+auto distinct(KeyFunctor &&keyFunctor = {}) { return distinct_stage<std::decay_t<KeyFunctor>> { {}, std::forward<KeyFunctor>(keyFunctor) }; }
+
+template<typename TeeFunctor>
+auto tee(TeeFunctor &&teeFunctor) { return tee_stage<std::decay_t<TeeFunctor>> { {}, std::forward<TeeFunctor>(teeFunctor) }; }
+
+template<typename SeedType, typename AggregateFunctor>
+auto aggregate(SeedType seed, AggregateFunctor aggregateFunctor)
+{
+    return terminal_operation { [seed = std::move(seed), aggregateFunctor = std::move(aggregateFunctor)](auto &p)
+    {
+        auto result { seed };
+
+        p.push([&](const auto &v) { result = aggregateFunctor(std::move(result), v); return true; });
+
+        return result;
+    } };
+}
+
+template<typename ConditionFunctor>
+auto all(ConditionFunctor conditionFunctor)
+{
+    return terminal_operation { [conditionFunctor = std::move(conditionFunctor)](auto &p)
+    {
+        bool result { true };
+
+        p.push([&](const auto &v) { return (result = conditionFunctor(v)); });
+
+        return result;
+    } };
+}
+
+template<typename ConditionFunctor>
+auto any(ConditionFunctor conditionFunctor)
+{
+    return terminal_operation { [conditionFunctor = std::move(conditionFunctor)](auto &p)
+    {
+        bool result { false };
+
+        p.push([&](const auto &v) { return !(result = conditionFunctor(v)); });
+
+        return result;
+    } };
+}
+
+inline auto any()
+{
+    return any([](const auto &) { return true; });
+}
+
+template<typename ConditionFunctor>
+auto count(ConditionFunctor conditionFunctor)
+{
+    return terminal_operation { [conditionFunctor = std::move(conditionFunctor)](auto &p)
+    {
+        std::size_t result { 0 };
+
+        p.push([&](const auto &v) { result += conditionFunctor(v) ? 1 : 0; return true; });
+
+        return result;
+    } };
+}
+
+inline auto count()
+{
+    return count([](const auto &) { return true; });
+}
+
+inline auto first()
+{
+    return terminal_operation { [](auto &p)
+    {
+        std::optional<typename std::decay_t<decltype(p)>::value_type> result {};
+
+        p.push([&result](const auto &v) { result.emplace(v); return false; });
+
+        if (!result) throw no_elements("first"s);
+
+        return *result;
+    } };
+}
+
+template<typename ForeachFunctor>
+auto for_each(ForeachFunctor foreachFunctor)
+{
+    return terminal_operation { [foreachFunctor = std::move(foreachFunctor)](auto &p) { p.push([&](const auto &v) { foreachFunctor(v); return true; }); } };
+}
+
+template<typename CompareFunctor>
+auto extremum(CompareFunctor compareFunctor, const char *name)
+{
+    return terminal_operation { [compareFunctor = std::move(compareFunctor), name](auto &p)
+    {
+        std::optional<typename std::decay_t<decltype(p)>::value_type> result {};
+
+        p.push([&](const auto &v) { if (!result || compareFunctor(v, *result)) result.emplace(v); return true; });
+
+        if (!result) throw no_elements(name);
+
+        return *result;
+    } };
+}
+
+inline auto max()
+{
+    return extremum(std::greater<> {}, "max");
+}
+
+inline auto min()
+{
+    return extremum(std::less<> {}, "min");
+}
+
+template<typename SelectFunctor>
+auto sum(SelectFunctor selectFunctor)
+{
+    return terminal_operation { [selectFunctor = std::move(selectFunctor)](auto &p)
+    {
+        std::decay_t<decltype(selectFunctor(typename std::decay_t<decltype(p)>::value_type()))> result {};
+
+        p.push([&](const auto &v) { result = result + selectFunctor(v); return true; });
+
+        return result;
+    } };
+}
+
+inline auto sum()
+{
+    return sum(std::identity {});
+}
+
+inline auto to_string(const std::string &delimiter = std::string())
+{
+    return terminal_operation { [delimiter](auto &p)
+    {
+        std::ostringstream oss;
+        bool first { true };
+
+        p.push([&](const auto &v) { if (!first) oss << delimiter; oss << v; first = false; return true; });
+
+        return oss.str();
+    } };
+}
+
+inline auto to_vector()
+{
+    return terminal_operation { [](auto &p)
+    {
+        std::vector<typename std::decay_t<decltype(p)>::value_type> result;
+
+        p.push([&result](const auto &v) { result.push_back(v); return true; });
+
+        return result;
+    } };
+}
+
+}
+
 }
@@ -0,0 +1,109 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2017 Arlen Keshabyan (arlen.albert@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <functional>
+#include <memory_resource>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace nstd::relinx
+{
+
+namespace detail
+{
+
+inline auto current_memory_resource() noexcept -> std::pmr::memory_resource*&
+{
+    thread_local std::pmr::memory_resource *resource { std::pmr::get_default_resource() };
+
+    return resource;
+}
+
+}
+
+/** \brief Returns the memory resource that the intermediate containers of queries on the current thread allocate from.
+
+    Returns the memory resource that the intermediate containers of queries on the current thread allocate from.
+    It is std::pmr::get_default_resource() unless a \ref memory_resource_scope is active on the thread.
+*/
+inline auto memory_resource() noexcept -> std::pmr::memory_resource*
+{
+    return detail::current_memory_resource();
+}
+
+/** \brief Makes a memory resource current for the queries on this thread for the lifetime of the scope.
+
+    Every container a query materializes (order_by, group_by, reverse, distinct, joins, set operations) picks the current resource up when it is created,
+    so a whole query can run in a std::pmr::monotonic_buffer_resource arena that is released in one shot. The results of to_vector and to_list
+    use the global allocator and outlive the arena; to_map results and relinx_objects that own materialized containers must not outlive it.
+    The coroutines of a co_relinx query create their containers while the query is iterated, so there the scope has to cover the iteration.
+    relinx and co_relinx share this one resource per thread.
+
+    Example of usage: \code std::pmr::monotonic_buffer_resource arena; memory_resource_scope scope { &arena }; auto top = from(rows)->order_by(key)->take(10)->to_vector(); \endcode
+*/
+class memory_resource_scope
+{
+public:
+    explicit memory_resource_scope(std::pmr::memory_resource *resource) noexcept : _previous(std::exchange(detail::current_memory_resource(), resource)) { }
+    memory_resource_scope(const memory_resource_scope &) = delete;
+    memory_resource_scope &operator=(const memory_resource_scope &) = delete;
+    ~memory_resource_scope() noexcept { detail::current_memory_resource() = _previous; }
+
+private:
+    std::pmr::memory_resource *_previous;
+};
+
+/** \brief A polymorphic allocator that defaults to the current \ref memory_resource of the thread.
+
+    A default constructed or copy constructed container takes the resource that is current at that moment, so copies of arena containers made outside of the arena scope do not point into it.
+*/
+template<typename T>
+class query_allocator : public std::pmr::polymorphic_allocator<T>
+{
+public:
+    using base = std::pmr::polymorphic_allocator<T>;
+
+    query_allocator() noexcept : base(memory_resource()) { }
+    query_allocator(std::pmr::memory_resource *resource) noexcept : base(resource) { }
+    query_allocator(const query_allocator &) = default;
+
+    template<typename U>
+    query_allocator(const std::pmr::polymorphic_allocator<U> &other) noexcept : base(other.resource()) { }
+
+    auto select_on_container_copy_construction() const noexcept -> query_allocator
+    {
+        return {};
+    }
+};
+
+template<typename T> using default_container = std::vector<T, query_allocator<T>>;
+template<typename T, typename V> using default_map = std::unordered_map<T, V, std::hash<T>, std::equal_to<T>, query_allocator<std::pair<const T, V>>>;
+template<typename T, typename V> using default_multimap = std::unordered_multimap<T, V, std::hash<T>, std::equal_to<T>, query_allocator<std::pair<const T, V>>>;
+template<typename T> using default_set = std::unordered_set<T, std::hash<T>, std::equal_to<T>, query_allocator<T>>;
+
+}
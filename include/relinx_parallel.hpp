@@ -0,0 +1,368 @@
+#pragma once
+
+/*
+MIT License
+Copyright (c) 2026 Arlen Keshabyan (arlen.albert@gmail.com)
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <atomic>
+#include <optional>
+#include <ranges>
+#include "relinx.hpp"
+#include "parallel_algorithms.hpp"
+
+// from(c)->parallel(pool) splits a random access sequence into chunks that run on the pool: where, select and select_many
+// stages are fused per chunk (see relinx::pipe) and terminal operations merge the partial results of the chunks in their order.
+// Functors may be called concurrently from several threads.
+
+namespace nstd::relinx
+{
+
+template<typename ParentRelinxType, typename Pipeline> class parallel_relinx_object;
+
+template<typename RelinxObject>
+auto make_parallel(std::shared_ptr<RelinxObject> relinx_object_ptr, thread_pool &pool, std::size_t grain_size)
+{
+    using iterator_type = typename RelinxObject::iterator_type;
+
+    if constexpr (parallel::detail::is_random_access_v<iterator_type>)
+    {
+        using pipeline_type = pipe::pipeline<std::ranges::subrange<iterator_type>>;
+
+        pipeline_type pipeline { std::ranges::subrange<iterator_type>(relinx_object_ptr->begin(), relinx_object_ptr->end()), {} };
+
+        return std::make_shared<parallel_relinx_object<RelinxObject, pipeline_type>>(std::move(relinx_object_ptr), std::move(pipeline), pool, grain_size);
+    }
+    else return make_parallel(from(relinx_object_ptr->to_vector()), pool, grain_size);
+}
+
+template<typename ParentRelinxType, typename ValueType, typename Compare>
+class parallel_relinx_object_ordered : public relinx_object<ParentRelinxType, typename default_container<ValueType>::iterator, default_container<ValueType>>
+{
+public:
+    using self_type = parallel_relinx_object_ordered<ParentRelinxType, ValueType, Compare>;
+    using value_type = ValueType;
+    using base = relinx_object<ParentRelinxType, typename default_container<ValueType>::iterator, default_container<ValueType>>;
+
+    parallel_relinx_object_ordered(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, default_container<value_type> &&ordered, Compare &&compare, thread_pool &pool, std::size_t grain_size) noexcept :
+        base(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr), std::forward<default_container<value_type>>(ordered)),
+        _compare(std::forward<Compare>(compare)),
+        _pool(pool),
+        _grain_size(grain_size)
+        {
+        }
+
+    // the values are already ordered by the previous keys, so a stable sort by the next key alone keeps that order within equal keys
+    template<typename SelectFunctor, typename SortFunctor>
+    auto then_by(SelectFunctor &&selectFunctor, SortFunctor &&sortFunctor)
+    {
+        auto compare { [previous = _compare, selectFunctor = std::forward<SelectFunctor>(selectFunctor), sortFunctor = std::forward<SortFunctor>(sortFunctor)](const value_type &a, const value_type &b)
+        {
+            if (previous(a, b)) return true;
+            if (previous(b, a)) return false;
+
+            return static_cast<bool>(sortFunctor(selectFunctor(a), selectFunctor(b)));
+        } };
+
+        parallel::stable_sort(std::begin(this->_container), std::end(this->_container), compare, _grain_size, _pool);
+
+        using next_relinx_type = parallel_relinx_object_ordered<self_type, value_type, decltype(compare)>;
+
+        return std::make_shared<next_relinx_type>(std::static_pointer_cast<self_type>(std::enable_shared_from_this<base>::shared_from_this()), std::move(this->_container), std::move(compare), _pool, _grain_size);
+    }
+
+    template<typename SelectFunctor = std::identity>
+    auto then_by(SelectFunctor &&selectFunctor = {})
+    {
+        return then_by(std::forward<SelectFunctor>(selectFunctor), std::less<> {});
+    }
+
+    template<typename SelectFunctor = std::identity>
+    auto then_by_descending(SelectFunctor &&selectFunctor = {})
+    {
+        return then_by(std::forward<SelectFunctor>(selectFunctor), std::greater<> {});
+    }
+
+protected:
+    Compare _compare;
+    thread_pool &_pool;
+    std::size_t _grain_size { 0 };
+};
+
+template<typename ParentRelinxType, typename Pipeline>
+class parallel_relinx_object : public std::enable_shared_from_this<parallel_relinx_object<ParentRelinxType, Pipeline>>
+{
+public:
+    using self_type = parallel_relinx_object<ParentRelinxType, Pipeline>;
+    using value_type = typename Pipeline::value_type;
+
+    parallel_relinx_object() = delete;
+    parallel_relinx_object(const parallel_relinx_object &) = delete;
+    auto operator =(const parallel_relinx_object &) -> parallel_relinx_object & = delete;
+
+    parallel_relinx_object(std::shared_ptr<ParentRelinxType> &&parent_relinx_object_ptr, Pipeline &&pipeline, thread_pool &pool, std::size_t grain_size) noexcept :
+        _parent_relinx_object_ptr(std::forward<std::shared_ptr<ParentRelinxType>>(parent_relinx_object_ptr)),
+        _pipeline(std::forward<Pipeline>(pipeline)),
+        _pool(pool),
+        _grain_size(grain_size)
+        {
+        }
+
+    template<typename FilterFunctor>
+    auto where(FilterFunctor &&filterFunctor)
+    {
+        return next(pipe::where(std::forward<FilterFunctor>(filterFunctor)));
+    }
+
+    template<typename TransformFunctor>
+    auto select(TransformFunctor &&transformFunctor)
+    {
+        return next(pipe::select(std::forward<TransformFunctor>(transformFunctor)));
+    }
+
+    template<typename ContainerSelectorFunctor>
+    auto select_many(ContainerSelectorFunctor &&containerSelectorFunctor)
+    {
+        return next(pipe::select_many(std::forward<ContainerSelectorFunctor>(containerSelectorFunctor)));
+    }
+
+    /**
+        \brief Applies an accumulator functor to every chunk and merges the chunk results with a combiner.
+
+        \param seed The initial value of every chunk, it must be the identity of combineFunctor (0 for +, 1 for *, an empty container for concatenation and so on).
+        \param aggregateFunctor A functor that takes the aggregated value of a chunk and the current value and returns the next aggregated value.
+        \param combineFunctor An associative functor that merges two aggregated values, chunk results are merged in the sequence order.
+
+        \return An aggregated value or the seed if the sequence is empty.
+    */
+    template<typename SeedType, typename AggregateFunctor, typename CombineFunctor>
+    auto aggregate(SeedType &&seed, AggregateFunctor &&aggregateFunctor, CombineFunctor &&combineFunctor) const
+    {
+        using result_type = std::decay_t<SeedType>;
+
+        auto partials { run_chunks<result_type>([&seed, &aggregateFunctor](auto &partial, const auto &)
+        {
+            partial.emplace(seed);
+
+            return [&partial, &aggregateFunctor](const auto &v) { *partial = aggregateFunctor(std::move(*partial), v); return true; };
+        }) };
+
+        result_type result { std::forward<SeedType>(seed) };
+
+        for (auto &partial : partials) result = combineFunctor(std::move(result), std::move(*partial));
+
+        return result;
+    }
+
+    template<typename ConditionFunctor>
+    auto all(ConditionFunctor &&conditionFunctor) const
+    {
+        return !any([&conditionFunctor](const auto &v) { return !conditionFunctor(v); });
+    }
+
+    // chunks stop as soon as any of them finds a match
+    template<typename ConditionFunctor>
+    auto any(ConditionFunctor &&conditionFunctor) const
+    {
+        std::atomic_bool found { false };
+
+        run_chunks<bool>([&found, &conditionFunctor](auto &, const auto &)
+        {
+            return [&found, &conditionFunctor](const auto &v)
+            {
+                if (found.load(std::memory_order_relaxed)) return false;
+                if (conditionFunctor(v)) { found.store(true, std::memory_order_relaxed); return false; }
+
+                return true;
+            };
+        });
+
+        return found.load();
+    }
+
+    auto any() const
+    {
+        return any([](const auto &) { return true; });
+    }
+
+    template<typename ConditionFunctor>
+    auto count(ConditionFunctor &&conditionFunctor) const
+    {
+        return aggregate(std::size_t { 0 }, [&conditionFunctor](std::size_t count, const auto &v) { return count + (conditionFunctor(v) ? 1 : 0); }, std::plus<> {});
+    }
+
+    auto count() const
+    {
+        return aggregate(std::size_t { 0 }, [](std::size_t count, const auto &) { return count + 1; }, std::plus<> {});
+    }
+
+    auto max() const
+    {
+        return extremum(std::greater<> {}, "max"s);
+    }
+
+    auto min() const
+    {
+        return extremum(std::less<> {}, "min"s);
+    }
+
+    template<typename SelectFunctor, typename SortFunctor>
+    auto order_by(SelectFunctor &&selectFunctor, SortFunctor &&sortFunctor)
+    {
+        auto ordered { collect<default_container<value_type>>() };
+        auto compare { [selectFunctor = std::forward<SelectFunctor>(selectFunctor), sortFunctor = std::forward<SortFunctor>(sortFunctor)](const value_type &a, const value_type &b)
+        {
+            return static_cast<bool>(sortFunctor(selectFunctor(a), selectFunctor(b)));
+        } };
+
+        parallel::stable_sort(std::begin(ordered), std::end(ordered), compare, _grain_size, _pool);
+
+        using next_relinx_type = parallel_relinx_object_ordered<self_type, value_type, decltype(compare)>;
+
+        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), std::move(ordered), std::move(compare), _pool, _grain_size);
+    }
+
+    template<typename SelectFunctor = std::identity>
+    auto order_by(SelectFunctor &&selectFunctor = {})
+    {
+        return order_by(std::forward<SelectFunctor>(selectFunctor), std::less<> {});
+    }
+
+    template<typename SelectFunctor = std::identity>
+    auto order_by_descending(SelectFunctor &&selectFunctor = {})
+    {
+        return order_by(std::forward<SelectFunctor>(selectFunctor), std::greater<> {});
+    }
+
+    template<typename SelectFunctor>
+    auto sum(SelectFunctor &&selectFunctor) const
+    {
+        using result_type = std::decay_t<std::invoke_result_t<SelectFunctor&, const value_type&>>;
+
+        return aggregate(result_type {}, [&selectFunctor](result_type sum, const auto &v) { return sum + selectFunctor(v); }, std::plus<> {});
+    }
+
+    auto sum() const
+    {
+        return sum(std::identity {});
+    }
+
+    // the first value of a key wins, the same as in relinx_object::to_map
+    template<   typename KeySelectorFunctor,
+                typename ValueSelectorFunctor = std::identity,
+                template <typename, typename> class MapType = default_map>
+    auto to_map(KeySelectorFunctor &&keySelectorFunctor, ValueSelectorFunctor &&valueSelectorFunctor = {}) const
+    {
+        using key_type = std::decay_t<std::invoke_result_t<KeySelectorFunctor&, const value_type&>>;
+        using new_value_type = std::decay_t<std::invoke_result_t<ValueSelectorFunctor&, const value_type&>>;
+        using map_type = MapType<key_type, new_value_type>;
+
+        auto partials { run_chunks<map_type>([&keySelectorFunctor, &valueSelectorFunctor](auto &partial, const auto &)
+        {
+            partial.emplace();
+
+            return [&partial, &keySelectorFunctor, &valueSelectorFunctor](const auto &v) { partial->emplace(keySelectorFunctor(v), valueSelectorFunctor(v)); return true; };
+        }) };
+
+        if (std::empty(partials)) return map_type {};
+
+        map_type result { std::move(*partials.front()) };
+
+        for (auto it { std::next(std::begin(partials)) }; it != std::end(partials); ++it)
+            for (auto &&[key, value] : **it) result.emplace(key, std::move(value));
+
+        return result;
+    }
+
+    auto to_vector() const
+    {
+        return collect<std::vector<value_type>>();
+    }
+
+protected:
+    template<typename Container>
+    auto collect() const -> Container
+    {
+        auto partials { run_chunks<default_container<value_type>>([](auto &partial, const auto &)
+        {
+            partial.emplace();
+
+            return [&partial](const auto &v) { partial->push_back(v); return true; };
+        }) };
+
+        std::size_t total { 0 };
+
+        for (auto &partial : partials) total += std::size(*partial);
+
+        Container result;
+
+        result.reserve(total);
+
+        for (auto &partial : partials) std::move(std::begin(*partial), std::end(*partial), std::back_inserter(result));
+
+        return result;
+    }
+
+    std::shared_ptr<ParentRelinxType> _parent_relinx_object_ptr;
+    Pipeline _pipeline;
+    thread_pool &_pool;
+    std::size_t _grain_size { 0 };
+
+    template<typename NextStage>
+    auto next(NextStage &&nextStage)
+    {
+        using next_pipeline_type = decltype(_pipeline.then(std::forward<NextStage>(nextStage)));
+        using next_relinx_type = parallel_relinx_object<self_type, next_pipeline_type>;
+
+        return std::make_shared<next_relinx_type>(std::enable_shared_from_this<self_type>::shared_from_this(), _pipeline.then(std::forward<NextStage>(nextStage)), _pool, _grain_size);
+    }
+
+    // makeSink(partial, chunk) prepares the std::optional partial result of a chunk and returns the sink the chunk is pushed into
+    template<typename Partial, typename MakeSinkFunctor>
+    auto run_chunks(MakeSinkFunctor &&makeSink) const
+    {
+        parallel::detail::chunk_dispatcher dispatcher { _pool, _pipeline.size(), _grain_size };
+        std::vector<std::optional<Partial>> partials(dispatcher.chunks_count());
+
+        dispatcher.run([this, &makeSink, &partials](std::size_t chunk, std::size_t first, std::size_t last)
+        {
+            _pipeline.push(makeSink(partials[chunk], chunk), first, last);
+        });
+
+        return partials;
+    }
+
+    template<typename CompareFunctor>
+    auto extremum(CompareFunctor compareFunctor, const std::string &name) const
+    {
+        auto partials { run_chunks<value_type>([&compareFunctor](auto &partial, const auto &)
+        {
+            return [&partial, &compareFunctor](const auto &v) { if (!partial || compareFunctor(v, *partial)) partial.emplace(v); return true; };
+        }) };
+
+        std::optional<value_type> result {};
+
+        for (auto &partial : partials) if (partial && (!result || compareFunctor(*partial, *result))) result = std::move(partial);
+
+        if (!result) throw no_elements(name);
+
+        return *result;
+    }
+};
+
+}
@@ -37,17 +37,32 @@ class remote_signal_hub
 public:
     void start(const std::string &host = "127.0.0.1"s, std::uint32_t port = 8)
     {
-        _server.start(host, port);
+        _server.start(host, port, [flow_control = _flow_control](const std::shared_ptr<nstd::net::tcp_client> &client)
+        {
+            client->set_flow_control(flow_control);
+
+            return false;
+        });
+    }
+
+    // taken by the next start() and applied to the slots it accepts, e.g. to drop or disconnect the ones that fall behind;
+    // not to be called concurrently with start()
+    void set_flow_control(const nstd::net::tcp_client::flow_control &control)
+    {
+        _flow_control = control;
     }
 
     void emit_remote_signal(const std::u8string &signal_name, const std::vector<uint8_t> &message)
     {
-        std::vector<uint8_t> msg { std::begin(signal_name), std::end(signal_name) };
+        std::vector<uint8_t> header { std::begin(signal_name), std::end(signal_name) };
+
+        header.insert(std::end(header), '\0');
+
+        nstd::net::buffer_chain msg { std::move(header), message };
 
-        msg.insert(std::end(msg), '\0');
-        msg.insert(std::end(msg), std::begin(message), std::end(message));
+        auto clients { _server.get_clients() };
 
-        for (auto &&client : _server.get_clients())
+        for (auto &&client : clients)
         {
             client->async_write({ msg, nullptr });
         }
@@ -55,6 +70,7 @@ public:
 
 private:
     nstd::net::tcp_server<pool_size> _server {};
+    nstd::net::tcp_client::flow_control _flow_control {};
 };
 
 template<typename scope = nstd::signal_slot::queued_signal_default_scope>
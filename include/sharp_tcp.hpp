@@ -20,11 +20,16 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <condition_variable>
 #include <chrono>
 #include <cstring>
 #include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
 #include <deque>
 #include <mutex>
 #include <optional>
@@ -32,8 +37,14 @@ SOFTWARE.
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 #include <unordered_map>
+#include <variant>
+
+#if __cplusplus > 201703L
+#include <span>
+#endif
 
 #include <fcntl.h>
 
@@ -47,10 +58,22 @@ SOFTWARE.
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#if __has_include(<linux/io_uring.h>)
+#define NSTD_SHARP_TCP_IO_URING
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
 namespace nstd::net
 {
 using namespace std::chrono_literals;
@@ -174,7 +197,7 @@ private:
                 {
                     task();
                 }
-                catch (const std::exception&)
+                catch (...)
                 {
                 }
             }
@@ -316,6 +339,212 @@ private:
 #endif
 };
 
+// Read-only bytes kept alive by a shared owner: copies and slices only bump the owner's refcount,
+// so one payload can sit in several write queues without being duplicated.
+class shared_buffer
+{
+public:
+    shared_buffer() = default;
+
+    shared_buffer(std::vector<uint8_t> data) : shared_buffer(std::make_shared<const std::vector<uint8_t>>(std::move(data))) {}
+
+    shared_buffer(std::string data) : shared_buffer(std::make_shared<const std::string>(std::move(data))) {}
+
+    template<typename Container>
+    shared_buffer(const std::shared_ptr<Container>& container) :
+        _owner { container },
+        _data { reinterpret_cast<const uint8_t*>(std::data(*container)) },
+        _size { std::size(*container) * sizeof(*std::data(*container)) }
+    {
+    }
+
+    shared_buffer(std::shared_ptr<const void> owner, const uint8_t* data, std::size_t size) :
+        _owner { std::move(owner) },
+        _data { data },
+        _size { size }
+    {
+    }
+
+    const uint8_t* data() const
+    {
+        return _data;
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    shared_buffer slice(std::size_t offset, std::size_t count = std::numeric_limits<std::size_t>::max()) const
+    {
+        offset = std::min(offset, _size);
+
+        return { _owner, _data + offset, std::min(count, _size - offset) };
+    }
+
+private:
+    std::shared_ptr<const void> _owner {};
+    const uint8_t* _data { nullptr };
+    std::size_t _size { 0 };
+};
+
+// An ordered list of shared_buffers written out as one message, e.g. a header and a body that were never concatenated.
+class buffer_chain
+{
+public:
+    buffer_chain() = default;
+
+    buffer_chain(std::vector<uint8_t> data) : buffer_chain(shared_buffer { std::move(data) }) {}
+
+    buffer_chain(std::string data) : buffer_chain(shared_buffer { std::move(data) }) {}
+
+    buffer_chain(shared_buffer buffer)
+    {
+        append(std::move(buffer));
+    }
+
+    buffer_chain(std::initializer_list<shared_buffer> buffers)
+    {
+        for (const auto& buffer : buffers) append(buffer);
+    }
+
+    buffer_chain& append(shared_buffer buffer)
+    {
+        if (buffer.empty()) return *this;
+
+        _size += buffer.size();
+        _buffers.push_back(std::move(buffer));
+
+        return *this;
+    }
+
+    void clear()
+    {
+        _buffers.clear();
+        _size = 0;
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    std::size_t buffer_count() const
+    {
+        return std::size(_buffers);
+    }
+
+    auto begin() const
+    {
+        return std::begin(_buffers);
+    }
+
+    auto end() const
+    {
+        return std::end(_buffers);
+    }
+
+private:
+    std::vector<shared_buffer> _buffers {};
+    std::size_t _size { 0 };
+};
+
+// Fixed-size receive chunks recycled through a free list. A chunk is only held while a socket is being drained,
+// so the pool of an io_service holds about as many chunks as it runs callbacks at once, whatever its socket count.
+class buffer_pool
+{
+public:
+    explicit buffer_pool(std::size_t chunk_size = 64 * 1024, std::size_t max_cached_chunks = 64) :
+        _chunk_size { chunk_size },
+        _max_cached_chunks { max_cached_chunks }
+    {
+    }
+
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    class chunk
+    {
+    public:
+        chunk(buffer_pool& pool, std::unique_ptr<uint8_t[]> data) : _pool { &pool }, _data { std::move(data) } {}
+
+        chunk(chunk&&) = default;
+        chunk& operator=(chunk&&) = default;
+
+        ~chunk()
+        {
+            if (_data) _pool->release(std::move(_data));
+        }
+
+        uint8_t* data() const
+        {
+            return _data.get();
+        }
+
+        std::size_t size() const
+        {
+            return _pool->chunk_size();
+        }
+
+    private:
+        buffer_pool* _pool;
+        std::unique_ptr<uint8_t[]> _data;
+    };
+
+    chunk acquire()
+    {
+        {
+            std::scoped_lock lock { _chunks_mtx };
+
+            if (!std::empty(_chunks))
+            {
+                auto data { std::move(_chunks.back()) };
+
+                _chunks.pop_back();
+
+                return { *this, std::move(data) };
+            }
+        }
+
+        return { *this, std::unique_ptr<uint8_t[]>(new uint8_t[_chunk_size]) };
+    }
+
+    std::size_t chunk_size() const
+    {
+        return _chunk_size;
+    }
+
+    std::size_t cached_chunks() const
+    {
+        std::scoped_lock lock { _chunks_mtx };
+
+        return std::size(_chunks);
+    }
+
+private:
+    void release(std::unique_ptr<uint8_t[]> data)
+    {
+        std::scoped_lock lock { _chunks_mtx };
+
+        if (std::size(_chunks) < _max_cached_chunks) _chunks.push_back(std::move(data));
+    }
+
+    const std::size_t _chunk_size;
+    const std::size_t _max_cached_chunks;
+    std::vector<std::unique_ptr<uint8_t[]>> _chunks {};
+    mutable std::mutex _chunks_mtx {};
+};
+
 class tcp_socket
 {
 public:
@@ -398,6 +627,41 @@ public:
         return data;
     }
 
+    // Reads what is pending, up to size bytes. On POSIX it never blocks and returns 0 when nothing was pending;
+    // an orderly shutdown by the peer throws like recv() does.
+    std::size_t recv_some(uint8_t* data, std::size_t size)
+    {
+        create_socket_if_necessary();
+        check_or_set_type(type::CLIENT);
+
+#ifdef _WIN32
+        int rd_size = ::recv(_fd, reinterpret_cast<char*>(data), static_cast<int>(size), 0);
+
+        if (rd_size == SOCKET_ERROR)
+        {
+            if (::WSAGetLastError() == WSAEWOULDBLOCK) return 0;
+
+            throw sharp_tcp_error { "recv() failure" };
+        }
+#else
+        ssize_t rd_size;
+
+        do rd_size = ::recv(_fd, data, size, MSG_DONTWAIT);
+        while (rd_size == -1 && errno == EINTR);
+
+        if (rd_size == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+
+            throw sharp_tcp_error { "recv() failure" };
+        }
+#endif
+
+        if (rd_size == 0) throw sharp_tcp_error { "nothing to read, socket has been closed by remote host" };
+
+        return static_cast<std::size_t>(rd_size);
+    }
+
     std::size_t send(const std::vector<uint8_t>& data)
     {
         create_socket_if_necessary();
@@ -412,6 +676,76 @@ public:
         return wr_size;
     }
 
+    static constexpr std::size_t max_gather_buffers { 64 };
+
+    // Gathers up to max_gather_buffers buffers of the chain into a single call and returns how many bytes went out.
+    // On POSIX the call never blocks: 0 means the socket buffer is full and the rest has to wait for writability.
+    std::size_t send(const buffer_chain& chain)
+    {
+        create_socket_if_necessary();
+        check_or_set_type(type::CLIENT);
+
+#ifdef _WIN32
+        WSABUF buffers[max_gather_buffers];
+        DWORD nb_buffers { 0 };
+
+        for (const auto& buffer : chain)
+        {
+            if (nb_buffers == max_gather_buffers) break;
+
+            buffers[nb_buffers].buf = reinterpret_cast<char*>(const_cast<uint8_t*>(buffer.data()));
+            buffers[nb_buffers].len = static_cast<ULONG>(buffer.size());
+            ++nb_buffers;
+        }
+
+        if (nb_buffers == 0) return 0;
+
+        DWORD wr_size { 0 };
+
+        if (::WSASend(_fd, buffers, nb_buffers, &wr_size, 0, nullptr, nullptr) == SOCKET_ERROR) throw sharp_tcp_error { "WSASend() failure" };
+
+        return wr_size;
+#else
+        struct iovec buffers[max_gather_buffers];
+        std::size_t nb_buffers { 0 };
+
+        for (const auto& buffer : chain)
+        {
+            if (nb_buffers == max_gather_buffers) break;
+
+            buffers[nb_buffers].iov_base = const_cast<uint8_t*>(buffer.data());
+            buffers[nb_buffers].iov_len  = buffer.size();
+            ++nb_buffers;
+        }
+
+        if (nb_buffers == 0) return 0;
+
+        struct msghdr message {};
+        message.msg_iov    = buffers;
+        message.msg_iovlen = nb_buffers;
+
+#ifdef MSG_NOSIGNAL
+        constexpr int flags { MSG_DONTWAIT | MSG_NOSIGNAL };
+#else
+        constexpr int flags { MSG_DONTWAIT };
+#endif
+
+        ssize_t wr_size;
+
+        do wr_size = ::sendmsg(_fd, &message, flags);
+        while (wr_size == -1 && errno == EINTR);
+
+        if (wr_size == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+
+            throw sharp_tcp_error { "sendmsg() failure" };
+        }
+
+        return static_cast<std::size_t>(wr_size);
+#endif
+    }
+
     void connect(const std::string& host, std::uint32_t port, std::uint32_t timeout_msecs = 0)
     {
         _host = host;
@@ -612,6 +946,12 @@ public:
         socklen_t addr_len                 = is_unix_socket ? sizeof(server_addr_un) : sizeof(server_addr_in);
         const struct sockaddr* server_addr = is_unix_socket ? (const struct sockaddr*) &server_addr_un : (const struct sockaddr*) &server_addr_in;
 
+#ifdef SO_REUSEPORT
+        int reuse_port = _reuse_port ? 1 : 0;
+
+        if (reuse_port && ::setsockopt(_fd, SOL_SOCKET, SO_REUSEPORT, &reuse_port, sizeof(reuse_port)) == -1) throw sharp_tcp_error { "setsockopt(SO_REUSEPORT) failure" };
+#endif
+
         if (::bind(_fd, server_addr, addr_len) == -1) throw sharp_tcp_error { "bind() failure" };
 #endif
     }
@@ -677,6 +1017,12 @@ public:
         return _fd;
     }
 
+    // applied by the next bind(); lets several listening sockets share one port, the kernel spreads connections among them
+    void set_reuse_port(bool reuse_port)
+    {
+        _reuse_port = reuse_port;
+    }
+
 private:
     void create_socket_if_necessary()
     {
@@ -706,280 +1052,837 @@ private:
     std::string _host {};
     std::uint32_t _port { 0 };
     type _type { type::UNKNOWN };
+    bool _reuse_port { false };
 };
 
-class io_service
+enum class io_backend
 {
-public:
-    io_service(std::size_t nb_threads = 1) : _callback_workers(nb_threads)
-    {
-        _poll_worker = std::thread([&](){ poll(); });
-    }
+    select,
+    epoll,
+    io_uring
+};
 
-    ~io_service()
-    {
-        _should_stop = true;
+#ifdef __linux__
+inline constexpr io_backend default_io_backend { io_backend::epoll };
+#else
+inline constexpr io_backend default_io_backend { io_backend::select };
+#endif
 
-        _notifier.notify();
+namespace detail
+{
 
-        if (_poll_worker.joinable()) _poll_worker.join();
+// Readiness source behind io_service. A reported descriptor stays disarmed until watch() is called for it again,
+// so the same event is never handed out twice while its callback is still running on a worker.
+class io_poller
+{
+public:
+    using event_handler_t = std::function<void(fd_t fd, bool readable, bool writable)>;
 
-        _callback_workers.stop();
-    }
+    virtual ~io_poller() = default;
 
-    io_service(const io_service&) = delete;
-    io_service& operator=(const io_service&) = delete;
+    virtual void watch(fd_t fd, bool rd, bool wr) = 0;
+    virtual void forget(fd_t fd) = 0;
+    virtual void wait(std::optional<int> timeout_usecs, const event_handler_t& handler) = 0;
 
-    void set_nb_workers(std::size_t nb_threads)
+    void wake_up()
     {
-        _callback_workers.set_nb_threads(nb_threads);
+        _notifier.notify();
     }
 
-    void set_use_timeout(std::optional<int> timeout_usecs)
+protected:
+    struct event
     {
-        _use_timeout = timeout_usecs;
-    }
+        fd_t fd;
+        bool rd;
+        bool wr;
+    };
 
-    using event_callback_t = std::function<void(fd_t)>;
+    self_pipe _notifier {};
+    std::vector<event> _events {};
+};
 
-    void track(const tcp_socket& socket, const event_callback_t& rd_callback = nullptr, const event_callback_t& wr_callback = nullptr)
+class select_poller : public io_poller
+{
+public:
+    void watch(fd_t fd, bool rd, bool wr) override
     {
-        std::scoped_lock lock { _tracked_sockets_mtx };
+#ifndef _WIN32
+        if (fd >= FD_SETSIZE) throw sharp_tcp_error { "select() cannot watch descriptors beyond FD_SETSIZE, use the epoll backend" };
+#endif
+        std::scoped_lock lock { _interests_mtx };
 
-        auto& track_info              { _tracked_sockets[socket.get_fd()] };
-        track_info.rd_callback        = rd_callback;
-        track_info.wr_callback        = wr_callback;
-        track_info.marked_for_untrack = false;
+        if (rd || wr) _interests[fd] = { rd, wr };
+        else _interests.erase(fd);
 
-        _notifier.notify();
+        if (_is_waiting) _notifier.notify();
     }
 
-    void set_rd_callback(const tcp_socket& socket, const event_callback_t& event_callback)
+    void forget(fd_t fd) override
     {
-        std::scoped_lock lock { _tracked_sockets_mtx };
-
-        auto& track_info       { _tracked_sockets[socket.get_fd()] };
-        track_info.rd_callback = event_callback;
-
-        _notifier.notify();
+        watch(fd, false, false);
     }
 
-    void set_wr_callback(const tcp_socket& socket, const event_callback_t& event_callback)
+    void wait(std::optional<int> timeout_usecs, const event_handler_t& handler) override
     {
-        std::scoped_lock lock { _tracked_sockets_mtx };
+        fd_set rd_set;
+        fd_set wr_set;
 
-        auto& track_info       { _tracked_sockets[socket.get_fd()] };
-        track_info.wr_callback = event_callback;
+        FD_ZERO(&rd_set);
+        FD_ZERO(&wr_set);
 
-        _notifier.notify();
-    }
+        int ndfs = (int) _notifier.get_read_fd();
 
-    void untrack(const tcp_socket& socket)
-    {
-        std::scoped_lock lock { _tracked_sockets_mtx };
+        {
+            std::scoped_lock lock { _interests_mtx };
 
-        auto it { _tracked_sockets.find(socket.get_fd()) };
+            FD_SET(_notifier.get_read_fd(), &rd_set);
 
-        if (it == std::end(_tracked_sockets)) return;
+            for (const auto& [fd, interest] : _interests)
+            {
+                if (interest.rd) FD_SET(fd, &rd_set);
+                if (interest.wr) FD_SET(fd, &wr_set);
+                if ((int) fd > ndfs) ndfs = (int) fd;
+            }
 
-        if (it->second.is_executing_rd_callback || it->second.is_executing_wr_callback)
-        {
-            it->second.marked_for_untrack = true;
+            _is_waiting = true;
         }
-        else
+
+        struct timeval* timeout_ptr { nullptr };
+        struct timeval timeout;
+
+        if (timeout_usecs.has_value())
         {
-            _tracked_sockets.erase(it);
-            _wait_for_removal_condvar.notify_all();
+            timeout.tv_sec  = timeout_usecs.value() / 1'000'000;
+            timeout.tv_usec = timeout_usecs.value() % 1'000'000;
+            timeout_ptr     = &timeout;
         }
 
-        _notifier.notify();
-    }
+        int ready = ::select(ndfs + 1, &rd_set, &wr_set, nullptr, timeout_ptr);
 
-    void wait_for_removal(const tcp_socket& socket)
-    {
-        std::unique_lock lock { _tracked_sockets_mtx };
+        _events.clear();
 
-        _wait_for_removal_condvar.wait(lock, [this, &socket]()
         {
-            return _tracked_sockets.find(socket.get_fd()) == _tracked_sockets.end();
-        });
-    }
+            std::scoped_lock lock { _interests_mtx };
 
-private:
-    struct tracked_socket
-    {
-        tracked_socket() = default;
+            _is_waiting = false;
 
-        event_callback_t rd_callback { nullptr };
-        std::atomic_bool is_executing_rd_callback { false };
+            if (ready <= 0) return;
 
-        event_callback_t wr_callback { nullptr };
-        std::atomic_bool is_executing_wr_callback { false };
-        std::atomic_bool marked_for_untrack { false };
+            if (FD_ISSET(_notifier.get_read_fd(), &rd_set)) _notifier.clr_buffer();
+
+            for (auto it { std::begin(_interests) }; it != std::end(_interests);)
+            {
+                bool rd = it->second.rd && FD_ISSET(it->first, &rd_set);
+                bool wr = it->second.wr && FD_ISSET(it->first, &wr_set);
+
+                if (!rd && !wr)
+                {
+                    ++it;
+
+                    continue;
+                }
+
+                _events.push_back({ it->first, rd, wr });
+                it = _interests.erase(it);
+            }
+        }
+
+        for (const auto& e : _events) handler(e.fd, e.rd, e.wr);
+    }
+
+private:
+    struct interest
+    {
+        bool rd { false };
+        bool wr { false };
     };
 
-    void poll()
+    std::unordered_map<fd_t, interest> _interests {};
+    std::mutex _interests_mtx {};
+    bool _is_waiting { false };
+};
+
+#ifdef __linux__
+class epoll_poller : public io_poller
+{
+public:
+    epoll_poller()
     {
-        while (!_should_stop)
+        _fd = ::epoll_create1(EPOLL_CLOEXEC);
+
+        if (_fd == INVALID_FD) throw sharp_tcp_error { "epoll_create1() failure" };
+
+        struct epoll_event ev {};
+        ev.events   = EPOLLIN;
+        ev.data.u64 = notifier_tag;
+
+        if (::epoll_ctl(_fd, EPOLL_CTL_ADD, _notifier.get_read_fd(), &ev) == -1)
         {
-            int ndfs = init_poll_fds_info();
+            ::close(_fd);
+
+            throw sharp_tcp_error { "epoll_ctl() failure" };
+        }
+
+        _ready.resize(1024);
+    }
+
+    ~epoll_poller()
+    {
+        ::close(_fd);
+    }
+
+    // One-shot registrations: the kernel disarms a descriptor as soon as it is reported and rechecks readiness on
+    // EPOLL_CTL_MOD, which keeps the level-triggered semantics of select() without rescanning every socket.
+    // An empty interest removes the descriptor altogether, otherwise EPOLLHUP would still be reported for it.
+    // Every registration carries a generation next to the descriptor, so an event already fetched for a closed
+    // descriptor is not handed to the socket that reuses its number.
+    void watch(fd_t fd, bool rd, bool wr) override
+    {
+        if (!rd && !wr) return forget(fd);
+
+        std::scoped_lock lock { _generations_mtx };
+
+        auto [it, added] { _generations.try_emplace(fd, 0) };
 
-            struct timeval* timeout_ptr { nullptr };
-            struct timeval timeout;
+        struct epoll_event ev {};
+        ev.events = EPOLLONESHOT | (rd ? EPOLLIN | EPOLLRDHUP : 0u) | (wr ? EPOLLOUT : 0u);
+
+        if (!added)
+        {
+            ev.data.u64 = tag(fd, it->second);
+
+            if (::epoll_ctl(_fd, EPOLL_CTL_MOD, fd, &ev) == 0 || errno != ENOENT) return;
+        }
+
+        // a descriptor closed without forget() has left the epoll set on its own, its number starts a new registration
+        if (++_generation == 0) ++_generation;
+
+        it->second  = _generation;
+        ev.data.u64 = tag(fd, it->second);
+
+        if (::epoll_ctl(_fd, EPOLL_CTL_ADD, fd, &ev) == -1)
+        {
+            _generations.erase(it);
+
+            throw sharp_tcp_error { "epoll_ctl() failure" };
+        }
+    }
+
+    void forget(fd_t fd) override
+    {
+        std::scoped_lock lock { _generations_mtx };
+
+        if (_generations.erase(fd)) ::epoll_ctl(_fd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    void wait(std::optional<int> timeout_usecs, const event_handler_t& handler) override
+    {
+        int timeout_msecs = timeout_usecs.has_value() ? (timeout_usecs.value() + 999) / 1000 : -1;
+        int ready         = ::epoll_wait(_fd, _ready.data(), (int) _ready.size(), timeout_msecs);
+
+        for (int i = 0; i < ready; ++i)
+        {
+            const auto& ev { _ready[i] };
+
+            if (ev.data.u64 == notifier_tag)
+            {
+                _notifier.clr_buffer();
+
+                continue;
+            }
+
+            // checked right before the handler runs: an earlier handler of this batch may have closed the descriptor
+            fd_t fd { static_cast<fd_t>(ev.data.u64 >> 32) };
 
-            if (_use_timeout.has_value())
             {
-                timeout.tv_usec = _use_timeout.value();
-                timeout_ptr     = &timeout;
+                std::scoped_lock lock { _generations_mtx };
+
+                auto it { _generations.find(fd) };
+
+                if (it == std::end(_generations) || tag(fd, it->second) != ev.data.u64) continue;
             }
 
-            if (::select(ndfs, &_rd_set, &_wr_set, nullptr, timeout_ptr) > 0) process_events();
+            handler(fd, ev.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR), ev.events & (EPOLLOUT | EPOLLHUP | EPOLLERR));
         }
     }
 
-    int init_poll_fds_info()
+private:
+    static constexpr std::uint64_t notifier_tag { ~std::uint64_t {} };
+
+    static std::uint64_t tag(fd_t fd, std::uint32_t generation)
     {
-        std::scoped_lock lock { _tracked_sockets_mtx };
+        return (static_cast<std::uint64_t>(fd) << 32) | generation;
+    }
 
-        _polled_fds.clear();
+    fd_t _fd { INVALID_FD };
+    std::vector<struct epoll_event> _ready {};
+    std::unordered_map<fd_t, std::uint32_t> _generations {};
+    std::uint32_t _generation { 0 };
+    std::mutex _generations_mtx {};
+};
+#endif
 
-        FD_ZERO(&_rd_set);
-        FD_ZERO(&_wr_set);
+#ifdef NSTD_SHARP_TCP_IO_URING
+// io_uring used as a readiness source: every armed descriptor has one outstanding one-shot IORING_OP_POLL_ADD.
+// The io_service callbacks do their own recv()/send(), so completion-based reads would have nowhere to go.
+// Submissions are flushed one by one because the poll thread may be blocked in io_uring_enter() at the time.
+class uring_poller : public io_poller
+{
+public:
+    uring_poller(unsigned entries = 4096)
+    {
+        struct io_uring_params params {};
+        params.flags      = IORING_SETUP_CQSIZE;
+        params.cq_entries = entries * 16;
 
-        int ndfs = (int) _notifier.get_read_fd();
+        _fd = (int) ::syscall(__NR_io_uring_setup, entries, &params);
 
-        FD_SET(_notifier.get_read_fd(), &_rd_set);
-        _polled_fds.push_back(_notifier.get_read_fd());
+        if (_fd < 0) throw sharp_tcp_error { "io_uring_setup() failure" };
 
-        for (const auto& socket : _tracked_sockets)
+        if (!(params.features & IORING_FEAT_EXT_ARG))
         {
-            const auto& fd          { socket.first };
-            const auto& socket_info { socket.second };
+            ::close(_fd);
 
-            bool should_rd = socket_info.rd_callback && !socket_info.is_executing_rd_callback;
+            throw sharp_tcp_error { "io_uring backend requires IORING_FEAT_EXT_ARG (Linux 5.11+)" };
+        }
 
-            if (should_rd) FD_SET(fd, &_rd_set);
+        _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        _sqes_size    = params.sq_entries * sizeof(struct io_uring_sqe);
 
-            bool should_wr = socket_info.wr_callback && !socket_info.is_executing_wr_callback;
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
 
-            if (should_wr) FD_SET(fd, &_wr_set);
+        if (single_mmap) _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
 
-            if (should_rd || should_wr || socket_info.marked_for_untrack) _polled_fds.push_back(fd);
+        _sq_ring = map(_sq_ring_size, IORING_OFF_SQ_RING);
+        _cq_ring = single_mmap ? _sq_ring : map(_cq_ring_size, IORING_OFF_CQ_RING);
+        _sqes    = static_cast<struct io_uring_sqe*>(map(_sqes_size, IORING_OFF_SQES));
 
-            if ((should_rd || should_wr) && (int) fd > ndfs) ndfs = (int) fd;
+        if (_sq_ring == MAP_FAILED || _cq_ring == MAP_FAILED || _sqes == MAP_FAILED)
+        {
+            release();
+
+            throw sharp_tcp_error { "io_uring mmap() failure" };
         }
 
-        return ndfs + 1;
+        auto* sq { static_cast<char*>(_sq_ring) };
+        auto* cq { static_cast<char*>(_cq_ring) };
+
+        _sq_tail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        _sq_mask  = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        _cq_head  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        _cq_tail  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        _cq_mask  = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        _cqes     = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        std::scoped_lock lock { _polls_mtx };
+
+        submit_poll_add(_notifier.get_read_fd(), POLLIN, notifier_tag);
     }
 
-    void process_events()
+    ~uring_poller()
     {
-        std::scoped_lock lock { _tracked_sockets_mtx };
+        release();
+    }
+
+    void watch(fd_t fd, bool rd, bool wr) override
+    {
+        unsigned mask = (rd ? POLLIN | POLLRDHUP : 0) | (wr ? POLLOUT : 0);
+
+        std::scoped_lock lock { _polls_mtx };
+
+        auto& p { _polls[fd] };
+
+        if (p.armed && p.mask == mask) return;
+
+        if (p.armed) submit_poll_remove(tag(fd, p.generation));
+
+        p.armed = mask != 0;
+        p.mask  = mask;
+
+        if (!p.armed) return;
+
+        if (++_generation == 0) ++_generation;
+
+        p.generation = _generation;
+
+        submit_poll_add(fd, mask, tag(fd, p.generation));
+    }
+
+    void forget(fd_t fd) override
+    {
+        std::scoped_lock lock { _polls_mtx };
+
+        auto it { _polls.find(fd) };
+
+        if (it == std::end(_polls)) return;
+
+        if (it->second.armed) submit_poll_remove(tag(fd, it->second.generation));
+
+        _polls.erase(it);
+    }
 
-        for (const auto& fd : _polled_fds)
+    void wait(std::optional<int> timeout_usecs, const event_handler_t& handler) override
+    {
+        if (__atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE) == *_cq_head)
         {
-            if (fd == _notifier.get_read_fd() && FD_ISSET(fd, &_rd_set))
+            if (timeout_usecs.has_value())
             {
-                _notifier.clr_buffer();
+                struct __kernel_timespec ts {};
+                ts.tv_sec  = timeout_usecs.value() / 1'000'000;
+                ts.tv_nsec = (timeout_usecs.value() % 1'000'000) * 1000;
 
-                continue;
-            }
+                struct io_uring_getevents_arg arg {};
+                arg.ts = reinterpret_cast<std::uint64_t>(&ts);
 
-            auto it { _tracked_sockets.find(fd) };
+                ::syscall(__NR_io_uring_enter, _fd, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+            }
+            else
+            {
+                ::syscall(__NR_io_uring_enter, _fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            }
+        }
 
-            if (it == std::end(_tracked_sockets)) continue;
+        _events.clear();
 
-            auto& socket { it->second };
+        {
+            std::scoped_lock lock { _polls_mtx };
 
-            if (FD_ISSET(fd, &_rd_set) && socket.rd_callback && !socket.is_executing_rd_callback) process_rd_event(fd, socket);
-            if (FD_ISSET(fd, &_wr_set) && socket.wr_callback && !socket.is_executing_wr_callback) process_wr_event(fd, socket);
+            unsigned head = *_cq_head;
+            unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
 
-            if (socket.marked_for_untrack && !socket.is_executing_rd_callback && !socket.is_executing_wr_callback)
+            for (; head != tail; ++head)
             {
-                _tracked_sockets.erase(it);
-                _wait_for_removal_condvar.notify_all();
+                const auto& cqe { _cqes[head & _cq_mask] };
+
+                if (cqe.user_data == notifier_tag)
+                {
+                    _notifier.clr_buffer();
+                    submit_poll_add(_notifier.get_read_fd(), POLLIN, notifier_tag);
+
+                    continue;
+                }
+
+                if (cqe.user_data == 0) continue;
+
+                fd_t fd { static_cast<fd_t>(cqe.user_data >> 32) };
+
+                auto it { _polls.find(fd) };
+
+                if (it == std::end(_polls) || !it->second.armed || tag(fd, it->second.generation) != cqe.user_data) continue;
+
+                // the poll request is gone whatever its outcome, so a failed one (EBADF, ENOMEM...) is reported as both
+                // readable and writable: the callbacks then meet the error on the socket itself instead of hanging
+                it->second.armed = false;
+
+                if (cqe.res == -ECANCELED) continue;
+
+                if (cqe.res < 0) _events.push_back({ fd, true, true });
+                else _events.push_back({ fd, (cqe.res & (POLLIN | POLLRDHUP | POLLHUP | POLLERR)) != 0, (cqe.res & (POLLOUT | POLLHUP | POLLERR)) != 0 });
             }
+
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
         }
+
+        for (const auto& e : _events) handler(e.fd, e.rd, e.wr);
+    }
+
+private:
+    static constexpr std::uint64_t notifier_tag { ~std::uint64_t {} };
+
+    static std::uint64_t tag(fd_t fd, std::uint32_t generation)
+    {
+        return (static_cast<std::uint64_t>(fd) << 32) | generation;
     }
 
-    void process_rd_event(const fd_t& fd, tracked_socket& socket)
+    void* map(std::size_t size, std::uint64_t offset)
     {
-        auto rd_callback { socket.rd_callback };
+        return ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, (off_t) offset);
+    }
 
-        socket.is_executing_rd_callback = true;
+    void release()
+    {
+        if (_sqes && _sqes != MAP_FAILED) ::munmap(_sqes, _sqes_size);
+        if (_cq_ring && _cq_ring != MAP_FAILED && _cq_ring != _sq_ring) ::munmap(_cq_ring, _cq_ring_size);
+        if (_sq_ring && _sq_ring != MAP_FAILED) ::munmap(_sq_ring, _sq_ring_size);
+        if (_fd != INVALID_FD) ::close(_fd);
 
-        _callback_workers << [=
-#if __cplusplus > 201703L
-                                 , this
+        _fd = INVALID_FD;
+    }
+
+    void submit_poll_add(fd_t fd, unsigned mask, std::uint64_t user_data)
+    {
+        struct io_uring_sqe sqe {};
+        sqe.opcode        = IORING_OP_POLL_ADD;
+        sqe.fd            = fd;
+        sqe.poll32_events = mask;
+        sqe.user_data     = user_data;
+
+        submit(sqe);
+    }
+
+    void submit_poll_remove(std::uint64_t target)
+    {
+        struct io_uring_sqe sqe {};
+        sqe.opcode    = IORING_OP_POLL_REMOVE;
+        sqe.fd        = -1;
+        sqe.addr      = target;
+        sqe.user_data = 0;
+
+        submit(sqe);
+    }
+
+    void submit(const struct io_uring_sqe& sqe)
+    {
+        unsigned tail  = *_sq_tail;
+        unsigned index = tail & _sq_mask;
+
+        _sqes[index]     = sqe;
+        _sq_array[index] = index;
+
+        __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        while (::syscall(__NR_io_uring_enter, _fd, 1, 0, 0, nullptr, 0) < 0)
+        {
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) throw sharp_tcp_error { "io_uring_enter() failure" };
+
+            std::this_thread::yield();
+        }
+    }
+
+    struct poll_info
+    {
+        std::uint32_t generation { 0 };
+        unsigned mask { 0 };
+        bool armed { false };
+    };
+
+    fd_t _fd { INVALID_FD };
+    void* _sq_ring { nullptr };
+    void* _cq_ring { nullptr };
+    struct io_uring_sqe* _sqes { nullptr };
+    std::size_t _sq_ring_size { 0 };
+    std::size_t _cq_ring_size { 0 };
+    std::size_t _sqes_size { 0 };
+    unsigned* _sq_tail { nullptr };
+    unsigned* _sq_array { nullptr };
+    unsigned _sq_mask { 0 };
+    unsigned* _cq_head { nullptr };
+    unsigned* _cq_tail { nullptr };
+    unsigned _cq_mask { 0 };
+    struct io_uring_cqe* _cqes { nullptr };
+    std::unordered_map<fd_t, poll_info> _polls {};
+    std::uint32_t _generation { 0 };
+    std::mutex _polls_mtx {};
+};
+#endif
+
+inline std::unique_ptr<io_poller> make_io_poller(io_backend backend)
+{
+    switch (backend)
+    {
+    case io_backend::select:
+        return std::make_unique<select_poller>();
+#ifdef __linux__
+    case io_backend::epoll:
+        return std::make_unique<epoll_poller>();
+#endif
+#ifdef NSTD_SHARP_TCP_IO_URING
+    case io_backend::io_uring:
+        return std::make_unique<uring_poller>();
 #endif
-                             ]
+    default:
+        throw sharp_tcp_error { "io backend is not available on this platform" };
+    }
+}
+
+}
+
+class io_service
+{
+public:
+    io_service(std::size_t nb_threads = 1, io_backend backend = default_io_backend) :
+        _backend { backend },
+        _poller { detail::make_io_poller(backend) },
+        _callback_workers(nb_threads)
+    {
+        _poll_worker = std::thread([&](){ poll(); });
+    }
+
+    ~io_service()
+    {
+        stop();
+    }
+
+    io_service(const io_service&) = delete;
+    io_service& operator=(const io_service&) = delete;
+
+    void stop()
+    {
+        _should_stop = true;
+
+        _poller->wake_up();
+
+        if (_poll_worker.joinable()) _poll_worker.join();
+
+        _callback_workers.stop();
+    }
+
+    io_backend get_backend() const
+    {
+        return _backend;
+    }
+
+    void set_nb_workers(std::size_t nb_threads)
+    {
+        _callback_workers.set_nb_threads(nb_threads);
+    }
+
+    void set_use_timeout(std::optional<int> timeout_usecs)
+    {
+        _use_timeout = timeout_usecs;
+    }
+
+    // Runs the callbacks on the poll thread instead of handing them to the workers: no queue, no context switch,
+    // but a slow callback stalls every other socket of this io_service.
+    void set_inline_callbacks(bool inline_callbacks)
+    {
+        _inline_callbacks = inline_callbacks;
+    }
+
+    bool get_inline_callbacks() const
+    {
+        return _inline_callbacks;
+    }
+
+    buffer_pool& get_buffer_pool()
+    {
+        return _buffer_pool;
+    }
+
+    using event_callback_t = std::function<void(fd_t)>;
+
+    void track(const tcp_socket& socket, const event_callback_t& rd_callback = nullptr, const event_callback_t& wr_callback = nullptr)
+    {
+        std::scoped_lock lock { _tracked_sockets_mtx };
+
+        auto& track_info              { _tracked_sockets[socket.get_fd()] };
+        track_info.rd_callback        = rd_callback;
+        track_info.wr_callback        = wr_callback;
+        track_info.marked_for_untrack = false;
+
+        watch(socket.get_fd(), track_info);
+    }
+
+    void set_rd_callback(const tcp_socket& socket, const event_callback_t& event_callback)
+    {
+        std::scoped_lock lock { _tracked_sockets_mtx };
+
+        auto& track_info       { _tracked_sockets[socket.get_fd()] };
+        track_info.rd_callback = event_callback;
+
+        watch(socket.get_fd(), track_info);
+    }
+
+    void set_wr_callback(const tcp_socket& socket, const event_callback_t& event_callback)
+    {
+        std::scoped_lock lock { _tracked_sockets_mtx };
+
+        auto& track_info       { _tracked_sockets[socket.get_fd()] };
+        track_info.wr_callback = event_callback;
+
+        watch(socket.get_fd(), track_info);
+    }
+
+    void untrack(const tcp_socket& socket)
+    {
+        std::scoped_lock lock { _tracked_sockets_mtx };
+
+        auto it { _tracked_sockets.find(socket.get_fd()) };
+
+        if (it == std::end(_tracked_sockets)) return;
+
+        if (it->second.is_executing_rd_callback || it->second.is_executing_wr_callback)
+        {
+            it->second.marked_for_untrack = true;
+
+            _poller->watch(it->first, false, false);
+        }
+        else
+        {
+            erase(it);
+        }
+    }
+
+    void wait_for_removal(const tcp_socket& socket)
+    {
+        std::unique_lock lock { _tracked_sockets_mtx };
+
+        // called from a callback of the socket itself (its owner released there): that callback can only end after
+        // this returns, so it counts as finished and only the callback of the other direction, if any, is waited for
+        if (auto context { _current_dispatch }; context && context->service == this && context->fd == socket.get_fd())
+        {
+            if (auto it { _tracked_sockets.find(context->fd) }; it != std::end(_tracked_sockets))
+            {
+                it->second.*(context->executing) = false;
+
+                if (!it->second.is_executing_rd_callback && !it->second.is_executing_wr_callback) erase(it);
+            }
+
+            context->removed = true;
+        }
+
+        _wait_for_removal_condvar.wait(lock, [this, &socket]()
         {
-            rd_callback(fd);
+            return _tracked_sockets.find(socket.get_fd()) == _tracked_sockets.end();
+        });
+    }
+
+private:
+    struct tracked_socket
+    {
+        tracked_socket() = default;
+
+        event_callback_t rd_callback { nullptr };
+        std::atomic_bool is_executing_rd_callback { false };
+
+        event_callback_t wr_callback { nullptr };
+        std::atomic_bool is_executing_wr_callback { false };
+        std::atomic_bool marked_for_untrack { false };
+    };
+
+    using tracked_sockets_t = std::unordered_map<fd_t, tracked_socket>;
+
+    void poll()
+    {
+        const detail::io_poller::event_handler_t handler { [this](fd_t fd, bool rd, bool wr){ process_event(fd, rd, wr); } };
+
+        while (!_should_stop) _poller->wait(_use_timeout, handler);
+    }
+
+    void watch(const fd_t& fd, const tracked_socket& socket)
+    {
+        if (socket.marked_for_untrack) return;
+
+        bool should_rd = socket.rd_callback && !socket.is_executing_rd_callback;
+        bool should_wr = socket.wr_callback && !socket.is_executing_wr_callback;
+
+        _poller->watch(fd, should_rd, should_wr);
+    }
+
+    void erase(tracked_sockets_t::iterator it)
+    {
+        _poller->forget(it->first);
+        _tracked_sockets.erase(it);
+        _wait_for_removal_condvar.notify_all();
+    }
+
+    void process_event(const fd_t& fd, bool rd, bool wr)
+    {
+        event_callback_t rd_callback { nullptr };
+        event_callback_t wr_callback { nullptr };
 
+        {
             std::scoped_lock lock { _tracked_sockets_mtx };
 
             auto it { _tracked_sockets.find(fd) };
 
             if (it == std::end(_tracked_sockets)) return;
 
-            auto& socket                    { it->second };
-            socket.is_executing_rd_callback = false;
+            auto& socket { it->second };
+
+            if (socket.marked_for_untrack) return;
+
+            if (rd && socket.rd_callback && !socket.is_executing_rd_callback)
+            {
+                rd_callback                     = socket.rd_callback;
+                socket.is_executing_rd_callback = true;
+            }
 
-            if (socket.marked_for_untrack && !socket.is_executing_wr_callback)
+            if (wr && socket.wr_callback && !socket.is_executing_wr_callback)
             {
-                _tracked_sockets.erase(it);
-                _wait_for_removal_condvar.notify_all();
+                wr_callback                     = socket.wr_callback;
+                socket.is_executing_wr_callback = true;
             }
 
-            _notifier.notify();
-        };
+            watch(fd, socket);
+        }
+
+        if (rd_callback) dispatch(fd, rd_callback, &tracked_socket::is_executing_rd_callback, &tracked_socket::is_executing_wr_callback);
+        if (wr_callback) dispatch(fd, wr_callback, &tracked_socket::is_executing_wr_callback, &tracked_socket::is_executing_rd_callback);
     }
 
-    void process_wr_event(const fd_t& fd, tracked_socket& socket)
-    {
-        auto wr_callback { socket.wr_callback };
+    using executing_flag_t = std::atomic_bool tracked_socket::*;
 
-        socket.is_executing_wr_callback = true;
+    // the callback the current thread is running, see wait_for_removal()
+    struct dispatch_context
+    {
+        const io_service *service;
+        fd_t fd;
+        executing_flag_t executing;
+        dispatch_context *previous;
+        bool removed;
+    };
 
-        _callback_workers << [=
+    void dispatch(const fd_t& fd, const event_callback_t& callback, executing_flag_t executing, executing_flag_t other_executing)
+    {
+        auto task = [=
 #if __cplusplus > 201703L
-                                 , this
+                        , this
 #endif
-                             ]
+                    ]
         {
-            wr_callback(fd);
+            dispatch_context context { this, fd, executing, _current_dispatch, false };
+
+            _current_dispatch = &context;
+
+            // anything thrown is swallowed: escaping the poll thread (inline callbacks) or a worker would terminate,
+            // and the socket has to get its executing flag back either way
+            try
+            {
+                callback(fd);
+            }
+            catch (...)
+            {
+            }
+
+            _current_dispatch = context.previous;
+
+            // removed from inside the callback: its entry is gone and the fd may already belong to another socket
+            if (context.removed) return;
 
             std::scoped_lock lock { _tracked_sockets_mtx };
 
-            auto it = _tracked_sockets.find(fd);
+            auto it { _tracked_sockets.find(fd) };
 
             if (it == std::end(_tracked_sockets)) return;
 
-            auto& socket                    { it->second };
-            socket.is_executing_wr_callback = false;
-
-            if (socket.marked_for_untrack && !socket.is_executing_rd_callback)
-            {
-                _tracked_sockets.erase(it);
-                _wait_for_removal_condvar.notify_all();
-            }
+            auto& socket     { it->second };
+            socket.*executing = false;
 
-            _notifier.notify();
+            if (socket.marked_for_untrack && !(socket.*other_executing)) erase(it);
+            else watch(fd, socket);
         };
+
+        if (_inline_callbacks) task();
+        else _callback_workers << task;
     }
 
 private:
     std::optional<int> _use_timeout{};
-    std::unordered_map<fd_t, tracked_socket> _tracked_sockets {};
+    tracked_sockets_t _tracked_sockets {};
     std::atomic_bool _should_stop { false };
+    std::atomic_bool _inline_callbacks { false };
     std::thread _poll_worker {};
+    io_backend _backend;
+    std::unique_ptr<detail::io_poller> _poller;
     thread_pool _callback_workers;
     std::mutex _tracked_sockets_mtx {};
-    std::vector<fd_t> _polled_fds {};
-    fd_set _rd_set {};
-    fd_set _wr_set {};
     std::condition_variable _wait_for_removal_condvar {};
-    self_pipe _notifier {};
+    buffer_pool _buffer_pool {};
+
+    static inline thread_local dispatch_context *_current_dispatch { nullptr };
 };
 
 static inline std::shared_ptr<io_service> io_service_default_instance = nullptr;
@@ -997,18 +1900,81 @@ void set_default_io_service(const std::shared_ptr<io_service>& service)
     io_service_default_instance = service;
 }
 
+// A set of independent io_services, one poll thread each. With inline callbacks (the default) a socket assigned to
+// a reactor is polled and served on that reactor's thread only, so nothing is handed over between threads.
+class io_service_group
+{
+public:
+    explicit io_service_group(std::size_t nb_reactors = std::thread::hardware_concurrency(), io_backend backend = default_io_backend, bool inline_callbacks = true)
+    {
+        nb_reactors = std::max<std::size_t>(nb_reactors, 1);
+
+        for (std::size_t i { 0 }; i < nb_reactors; ++i)
+        {
+            auto& reactor { _reactors.emplace_back(std::make_shared<io_service>(inline_callbacks ? 0 : 1, backend)) };
+
+            reactor->set_inline_callbacks(inline_callbacks);
+        }
+    }
+
+    // the reactors are stopped here rather than by the last owner of each one, which may well be
+    // a client released from inside its own callback, on the very thread that would have to be joined
+    ~io_service_group()
+    {
+        for (auto& reactor : _reactors) reactor->stop();
+    }
+
+    io_service_group(const io_service_group&) = delete;
+    io_service_group& operator=(const io_service_group&) = delete;
+
+    std::size_t size() const
+    {
+        return std::size(_reactors);
+    }
+
+    const std::shared_ptr<io_service>& operator[](std::size_t index) const
+    {
+        return _reactors[index];
+    }
+
+    const std::shared_ptr<io_service>& next()
+    {
+        return _reactors[_next++ % std::size(_reactors)];
+    }
+
+private:
+    std::vector<std::shared_ptr<io_service>> _reactors {};
+    std::atomic_size_t _next { 0 };
+};
+
+enum class slow_peer_policy
+{
+    none,
+    pause_reads,
+    drop,
+    disconnect
+};
+
 class tcp_client
 {
 public:
     tcp_client(uint32_t nu_io_workers = 1) : _io_service { get_default_io_service(nu_io_workers) } {}
 
+    explicit tcp_client(const std::shared_ptr<io_service>& service) : _io_service { service } {}
+
+    // A client may be released from inside one of its own callbacks: the io_service doesn't wait for that callback
+    // then, and the callback stops touching the client as soon as the user callback returns.
     ~tcp_client()
     {
+        for (auto scope { callback_scope::current }; scope; scope = scope->previous) if (scope->client == this) scope->released = true;
+
         disconnect(true);
     }
 
-    explicit tcp_client(tcp_socket&& socket) :
-        _io_service { get_default_io_service() },
+    explicit tcp_client(tcp_socket&& socket) : tcp_client(std::forward<tcp_socket>(socket), get_default_io_service()) {}
+
+    tcp_client(tcp_socket&& socket, const std::shared_ptr<io_service>& service) :
+        _io_service { service },
         _socket { std::forward<tcp_socket>(socket) },
         _is_connected { true }
     {
@@ -1097,7 +2063,35 @@ public:
         std::size_t size { 0 };
     };
 
+    struct read_some_result
+    {
+        bool success { false };
+        std::size_t size { 0 };
+    };
+
+    // A client becomes saturated when its unsent bytes exceed high_water_mark and writable again once they are back
+    // down to low_water_mark. While saturated the policy either pauses reads, drops new writes (their callback gets
+    // a failed write_result) or disconnects right away; under disconnect the write that would cross the mark is
+    // rejected like a dropped one. A low_water_mark above high_water_mark is clamped to it.
+    struct flow_control
+    {
+        std::size_t high_water_mark { std::numeric_limits<std::size_t>::max() };
+        std::size_t low_water_mark { 0 };
+        slow_peer_policy policy { slow_peer_policy::none };
+    };
+
+    struct write_queue_metrics
+    {
+        std::size_t queued_requests { 0 };
+        std::size_t queued_bytes { 0 };
+        std::size_t peak_queued_bytes { 0 };
+        std::size_t dropped_requests { 0 };
+        std::size_t saturation_events { 0 };
+        bool saturated { false };
+    };
+
     using async_read_callback_t = std::function<void(read_result&)>;
+    using async_read_some_callback_t = std::function<void(read_some_result&)>;
     using async_write_callback_t = std::function<void(write_result&)>;
 
     struct read_request
@@ -1106,9 +2100,17 @@ public:
         async_read_callback_t async_read_callback {};
     };
 
+    // Reads straight into caller memory, which has to stay valid until the callback runs or the client disconnects.
+    struct read_some_request
+    {
+        uint8_t* data { nullptr };
+        std::size_t size { 0 };
+        async_read_some_callback_t async_read_some_callback {};
+    };
+
     struct write_request
     {
-        std::vector<uint8_t> buffer {};
+        buffer_chain buffer {};
         async_write_callback_t async_write_callback {};
     };
 
@@ -1118,24 +2120,88 @@ public:
 
         if (is_connected())
         {
-            _io_service->set_rd_callback(_socket, [this](auto &&fd){ on_read_available(fd); });
+            if (!_reads_paused) _io_service->set_rd_callback(_socket, [this](auto &&fd){ on_read_available(fd); });
             _read_requests.push(request);
         }
         else {}
     }
 
-    void async_write(const write_request& request)
+    void async_read_some(const read_some_request& request)
     {
-        std::scoped_lock lock { _write_requests_mtx };
+        std::scoped_lock lock { _read_requests_mtx };
 
         if (is_connected())
         {
-            _io_service->set_wr_callback(_socket, [this](auto fd) { on_write_available(fd); });
-            _write_requests.push(request);
+            if (!_reads_paused) _io_service->set_rd_callback(_socket, [this](auto &&fd){ on_read_available(fd); });
+            _read_requests.push(request);
         }
         else {}
     }
 
+#if __cplusplus > 201703L
+    void async_read_some(std::span<uint8_t> buffer, const async_read_some_callback_t& callback)
+    {
+        async_read_some({ std::data(buffer), std::size(buffer), callback });
+    }
+#endif
+
+    // returns false when the request was not queued: not connected, or dropped by the slow peer policy
+    bool async_write(write_request request)
+    {
+        bool became_saturated { false };
+        bool dropped { false };
+        slow_peer_policy policy { slow_peer_policy::none };
+
+        {
+            std::scoped_lock lock { _write_requests_mtx };
+
+            if (!is_connected()) return false;
+
+            policy = _flow_control.policy;
+
+            if (policy == slow_peer_policy::disconnect && !_metrics.saturated && _metrics.queued_bytes + request.buffer.size() > _flow_control.high_water_mark)
+            {
+                _metrics.saturated = became_saturated = true;
+                ++_metrics.saturation_events;
+                ++_metrics.dropped_requests;
+                dropped = true;
+            }
+            else if (!_metrics.saturated || policy != slow_peer_policy::drop)
+            {
+                _metrics.queued_bytes     += request.buffer.size();
+                _metrics.peak_queued_bytes = std::max(_metrics.peak_queued_bytes, _metrics.queued_bytes);
+
+                _io_service->set_wr_callback(_socket, [this](auto fd) { on_write_available(fd); });
+                _write_requests.push_back(std::move(request));
+
+                if (!_metrics.saturated && _metrics.queued_bytes > _flow_control.high_water_mark)
+                {
+                    _metrics.saturated = became_saturated = true;
+                    ++_metrics.saturation_events;
+                }
+            }
+            else
+            {
+                ++_metrics.dropped_requests;
+                dropped = true;
+            }
+        }
+
+        if (dropped)
+        {
+            write_result result;
+
+            if (request.async_write_callback) request.async_write_callback(result);
+            if (became_saturated) on_saturated(policy);
+
+            return false;
+        }
+
+        if (became_saturated) on_saturated(policy);
+
+        return is_connected();
+    }
+
     tcp_socket& get_socket()
     {
         return _socket;
@@ -1158,32 +2224,145 @@ public:
         _disconnection_handler = disconnection_handler;
     }
 
+    using flow_control_handler_t = std::function<void()>;
+
+    void set_on_saturated_handler(const flow_control_handler_t& saturated_handler)
+    {
+        _saturated_handler = saturated_handler;
+    }
+
+    void set_on_writable_handler(const flow_control_handler_t& writable_handler)
+    {
+        _writable_handler = writable_handler;
+    }
+
+    void set_flow_control(const flow_control& control)
+    {
+        std::scoped_lock lock { _write_requests_mtx };
+
+        _flow_control                = control;
+        _flow_control.low_water_mark = std::min(control.low_water_mark, control.high_water_mark);
+    }
+
+    write_queue_metrics get_write_queue_metrics() const
+    {
+        std::scoped_lock lock { _write_requests_mtx };
+
+        auto metrics            { _metrics };
+        metrics.queued_requests = std::size(_write_requests);
+
+        return metrics;
+    }
+
+    bool are_reads_paused() const
+    {
+        return _reads_paused;
+    }
+
 private:
+    using read_callback_t = std::variant<std::monostate, async_read_callback_t, async_read_some_callback_t>;
+
+    // marks the socket callbacks this thread is running, the destructor flags the ones of its client as released
+    struct callback_scope
+    {
+        explicit callback_scope(const tcp_client *owner) : client { owner }, previous { std::exchange(current, this) } {}
+        ~callback_scope() { current = previous; }
+
+        callback_scope(const callback_scope&) = delete;
+        callback_scope& operator=(const callback_scope&) = delete;
+
+        const tcp_client *client;
+        callback_scope *previous;
+        bool released { false };
+
+        static inline thread_local callback_scope *current { nullptr };
+    };
+
     void on_read_available(fd_t)
     {
-        read_result result;
-        auto callback { process_read(result) };
+        callback_scope scope { this };
+        read_result result { true };
+        read_some_result some_result { true };
+        auto callback { process_read(result, some_result) };
+
+        bool success { result.success && some_result.success };
+
+        if (!success) disconnect();
+
+        if (auto read_callback { std::get_if<async_read_callback_t>(&callback) }; read_callback && *read_callback) (*read_callback)(result);
+        if (auto read_some_callback { std::get_if<async_read_some_callback_t>(&callback) }; read_some_callback && *read_some_callback) (*read_some_callback)(some_result);
 
-        if (!result.success) disconnect();
-        if (callback) callback(result);
-        if (!result.success) call_disconnection_handler();
+        if (!success && !scope.released) call_disconnection_handler();
     }
 
     void on_write_available(fd_t)
     {
-        write_result result;
-        auto callback { process_write(result) };
+        callback_scope scope { this };
+        bool became_writable { false };
+        bool success { process_write(became_writable) };
+
+        if (!success) disconnect();
+
+        // the completed writes are taken out while their callbacks run, the vector goes back to keep its capacity
+        decltype(_completed_writes) completed_writes {};
+
+        completed_writes.swap(_completed_writes);
+
+        for (auto& [callback, result] : completed_writes)
+        {
+            if (callback) callback(result);
+            if (scope.released) return;
+        }
+
+        completed_writes.clear();
+        completed_writes.swap(_completed_writes);
+
+        if (became_writable) on_writable();
+        if (!success && !scope.released) call_disconnection_handler();
+    }
+
+    // the policy is the one async_write saw under the lock, set_flow_control() may be changing it concurrently
+    void on_saturated(slow_peer_policy policy)
+    {
+        switch (policy)
+        {
+        case slow_peer_policy::pause_reads:
+            set_reads_paused(true);
+            break;
+        case slow_peer_policy::disconnect:
+            disconnect();
+            break;
+        default:
+            break;
+        }
+
+        if (_saturated_handler) _saturated_handler();
+        if (policy == slow_peer_policy::disconnect) call_disconnection_handler();
+    }
+
+    void on_writable()
+    {
+        if (_reads_paused) set_reads_paused(false);
+        if (_writable_handler) _writable_handler();
+    }
+
+    void set_reads_paused(bool paused)
+    {
+        std::scoped_lock lock { _read_requests_mtx };
+
+        _reads_paused = paused;
+
+        if (!is_connected()) return;
 
-        if (!result.success) disconnect();
-        if (callback) callback(result);
-        if (!result.success) call_disconnection_handler();
+        if (paused) _io_service->set_rd_callback(_socket, nullptr);
+        else if (!std::empty(_read_requests)) _io_service->set_rd_callback(_socket, [this](auto &&fd){ on_read_available(fd); });
     }
 
     void clear_read_requests()
     {
         std::scoped_lock lock { _read_requests_mtx };
 
-        std::queue<read_request> empty;
+        std::queue<std::variant<read_request, read_some_request>> empty;
         std::swap(_read_requests, empty);
     }
 
@@ -1191,29 +2370,46 @@ private:
     {
         std::scoped_lock lock { _write_requests_mtx };
 
-        std::queue<write_request> empty;
-        std::swap(_write_requests, empty);
+        _write_requests.clear();
+        _front_written        = 0;
+        _metrics.queued_bytes = 0;
+        _metrics.saturated    = false;
     }
 
-    async_read_callback_t process_read(read_result& result)
+    // A wake-up that finds nothing to read leaves the request queued for the next one.
+    read_callback_t process_read(read_result& result, read_some_result& some_result)
     {
         std::scoped_lock lock { _read_requests_mtx };
 
-        if (std::empty(_read_requests)) return nullptr;
+        if (std::empty(_read_requests)) return {};
 
-        const auto& request = _read_requests.front();
-        auto callback       = request.async_read_callback;
+        read_callback_t callback {};
+        bool completed { true };
 
         try
         {
-            result.buffer  = _socket.recv(request.size);
-            result.success = true;
+            if (auto request { std::get_if<read_request>(&_read_requests.front()) })
+            {
+                callback  = request->async_read_callback;
+                completed = recv_pooled(request->size, result.buffer);
+            }
+            else
+            {
+                auto& some_request { std::get<read_some_request>(_read_requests.front()) };
+
+                callback         = some_request.async_read_some_callback;
+                some_result.size = _socket.recv_some(some_request.data, some_request.size);
+                completed        = some_result.size > 0;
+            }
         }
-        catch (const sharp_tcp_error&e)
+        catch (const sharp_tcp_error&)
         {
-            result.success = false;
+            result.success      = false;
+            some_result.success = false;
         }
 
+        if (!completed) return {};
+
         _read_requests.pop();
 
         if (std::empty(_read_requests)) _io_service->set_rd_callback(_socket, nullptr);
@@ -1221,42 +2417,138 @@ private:
         return callback;
     }
 
-    async_write_callback_t process_write(write_result& result)
+    // Drains the socket through a pooled chunk, reading at most size_to_read bytes per call like tcp_socket::recv(),
+    // so the result is allocated at the size actually received instead of the size requested.
+    bool recv_pooled(std::size_t size_to_read, std::vector<uint8_t>& data)
+    {
+        auto chunk { _io_service->get_buffer_pool().acquire() };
+        auto chunk_read_size { size_to_read == 0 ? chunk.size() : std::min(size_to_read, chunk.size()) };
+
+        while (true)
+        {
+            std::size_t rd_size { 0 };
+
+            try
+            {
+                rd_size = _socket.recv_some(chunk.data(), chunk_read_size);
+            }
+            catch (const sharp_tcp_error&)
+            {
+                if (std::empty(data)) throw;
+
+                break;
+            }
+
+            data.insert(std::end(data), chunk.data(), chunk.data() + rd_size);
+
+            if (rd_size < chunk_read_size) break;
+        }
+
+        return !std::empty(data);
+    }
+
+    // Sends as much of the queue as one gathered call takes. A request completes once its last byte is out,
+    // a partially sent one stays at the front and resumes from _front_written on the next writable event.
+    bool process_write(bool& became_writable)
     {
         std::scoped_lock lock { _write_requests_mtx };
 
-        if (std::empty(_write_requests)) return nullptr;
+        if (std::empty(_write_requests)) return true;
+
+        _gather.clear();
+
+        std::size_t skip { _front_written };
+
+        for (const auto& request : _write_requests)
+        {
+            for (const auto& buffer : request.buffer)
+            {
+                if (skip >= buffer.size())
+                {
+                    skip -= buffer.size();
+
+                    continue;
+                }
+
+                _gather.append(buffer.slice(skip));
+                skip = 0;
+
+                if (_gather.buffer_count() == tcp_socket::max_gather_buffers) break;
+            }
+
+            if (_gather.buffer_count() == tcp_socket::max_gather_buffers) break;
+        }
 
-        const auto& request = _write_requests.front();
-        auto callback       = request.async_write_callback;
+        std::size_t written { 0 };
 
         try
         {
-            result.size    = _socket.send(request.buffer);
-            result.success = true;
+            written = _socket.send(_gather);
+        }
+        catch (const sharp_tcp_error&)
+        {
+            _metrics.queued_bytes -= _write_requests.front().buffer.size() - _front_written;
+
+            _completed_writes.push_back({ _write_requests.front().async_write_callback, { false, 0 } });
+            _write_requests.pop_front();
+            _front_written = 0;
+
+            return false;
+        }
+
+        _gather.clear();
+
+        _metrics.queued_bytes -= written;
+
+        if (_metrics.saturated && _metrics.queued_bytes <= _flow_control.low_water_mark)
+        {
+            _metrics.saturated = false;
+            became_writable    = true;
         }
-        catch (const sharp_tcp_error&e)
+
+        written += _front_written;
+
+        while (!std::empty(_write_requests) && written >= _write_requests.front().buffer.size())
         {
-            result.success = false;
+            auto& request { _write_requests.front() };
+
+            written -= request.buffer.size();
+
+            _completed_writes.push_back({ std::move(request.async_write_callback), { true, request.buffer.size() } });
+            _write_requests.pop_front();
         }
 
-        _write_requests.pop();
+        _front_written = written;
 
         if (std::empty(_write_requests)) _io_service->set_wr_callback(_socket, nullptr);
 
-        return callback;
+        return true;
     }
 
     std::shared_ptr<io_service> _io_service {};
     tcp_socket _socket {};
     std::atomic_bool _is_connected { false };
-    std::queue<read_request> _read_requests {};
-    std::queue<write_request> _write_requests {};
+    std::queue<std::variant<read_request, read_some_request>> _read_requests {};
+    std::deque<write_request> _write_requests {};
+    std::size_t _front_written { 0 };
+    buffer_chain _gather {};
+    std::vector<std::pair<async_write_callback_t, write_result>> _completed_writes {};
     std::mutex _read_requests_mtx {};
-    std::mutex _write_requests_mtx {};
+    mutable std::mutex _write_requests_mtx {};
+    flow_control _flow_control {};
+    write_queue_metrics _metrics {};
+    std::atomic_bool _reads_paused { false };
+    flow_control_handler_t _saturated_handler { nullptr };
+    flow_control_handler_t _writable_handler { nullptr };
     disconnection_handler_t _disconnection_handler { nullptr };
 };
 
+enum class accept_distribution
+{
+    round_robin,
+    reuse_port
+};
+
 template<auto ConnectionQueueSize = 1024>
 class tcp_server
 {
@@ -1265,6 +2557,21 @@ public:
     {
     }
 
+    // Spreads the connections over the reactors of the group. reuse_port gives every reactor its own listening socket,
+    // so accepting is sharded too; round_robin accepts on the first reactor and hands the clients out in turn.
+    // Platforms without SO_REUSEPORT always use round_robin.
+    explicit tcp_server(const std::shared_ptr<io_service_group>& reactors, accept_distribution distribution = accept_distribution::reuse_port) :
+        _io_service { (*reactors)[0] },
+        _reactors { reactors },
+#ifdef SO_REUSEPORT
+        _distribution { distribution }
+#else
+        _distribution { accept_distribution::round_robin }
+#endif
+    {
+        static_cast<void>(distribution);
+    }
+
     ~tcp_server()
     {
         stop();
@@ -1289,13 +2596,30 @@ public:
     {
         if (is_running()) throw sharp_tcp_error { "tcp_server is already running" };
 
-        _socket.bind(host, port);
-        _socket.listen(ConnectionQueueSize);
-
-        _io_service->track(_socket);
-        _io_service->set_rd_callback(_socket, [this](auto &&fd) { on_read_available(fd); });
         _on_new_connection_callback = callback;
 
+        try
+        {
+            for (std::size_t i { 0 }; i < nb_listeners(); ++i)
+            {
+                auto& socket { i == 0 ? _socket : _shard_sockets.emplace_back() };
+
+                socket.set_reuse_port(nb_listeners() > 1);
+                socket.bind(host, port);
+                socket.listen(ConnectionQueueSize);
+
+                listener_io_service(i)->track(socket);
+                listener_io_service(i)->set_rd_callback(socket, [this, i, &socket](auto &&) { on_read_available(socket, i); });
+            }
+        }
+        catch (...)
+        {
+            // a later listener failed to bind: stop() would skip the ones already accepting, as the server never ran
+            close_listeners(true);
+
+            throw;
+        }
+
         _is_running = true;
     }
 
@@ -1305,11 +2629,7 @@ public:
 
         _is_running = false;
 
-        _io_service->untrack(_socket);
-
-        if (wait_for_removal) _io_service->wait_for_removal(_socket);
-
-        _socket.close();
+        close_listeners(wait_for_removal);
 
         std::scoped_lock lock { _clients_mtx };
         for (auto& client : _clients)
@@ -1346,16 +2666,47 @@ public:
     }
 
 private:
-    void on_read_available(fd_t)
+    std::size_t nb_listeners() const
+    {
+        return _reactors && _distribution == accept_distribution::reuse_port ? _reactors->size() : 1;
+    }
+
+    const std::shared_ptr<io_service>& listener_io_service(std::size_t index) const
+    {
+        return index == 0 ? _io_service : (*_reactors)[index];
+    }
+
+    // only the listeners set up so far, a failed start() may have stopped halfway
+    void close_listeners(bool wait_for_removal)
+    {
+        for (std::size_t i { 0 }; i <= std::size(_shard_sockets); ++i)
+        {
+            auto& socket { i == 0 ? _socket : _shard_sockets[i - 1] };
+
+            listener_io_service(i)->untrack(socket);
+
+            if (wait_for_removal) listener_io_service(i)->wait_for_removal(socket);
+
+            socket.close();
+        }
+
+        _shard_sockets.clear();
+    }
+
+    void on_read_available(tcp_socket& listener, std::size_t index)
     {
         try
         {
-            auto client { std::make_shared<tcp_client>(_socket.accept()) };
+            const auto& owner { _reactors && _distribution == accept_distribution::round_robin ? _reactors->next() : listener_io_service(index) };
+
+            auto client { std::make_shared<tcp_client>(listener.accept(), owner) };
 
             if (!_on_new_connection_callback || !_on_new_connection_callback(client))
             {
                 client->set_on_disconnection_handler([this, client]() { on_client_disconnected(client); });
 
+                std::scoped_lock lock { _clients_mtx };
+
                 _clients.emplace_back(std::move(client));
             }
             else {}
@@ -1376,7 +2727,10 @@ private:
     }
 
     std::shared_ptr<io_service> _io_service {};
+    std::shared_ptr<io_service_group> _reactors {};
+    accept_distribution _distribution { accept_distribution::round_robin };
     tcp_socket _socket {};
+    std::deque<tcp_socket> _shard_sockets {};
     std::atomic_bool _is_running { false };
     std::deque<std::shared_ptr<tcp_client>> _clients {};
     std::mutex _clients_mtx {};
@@ -20,14 +20,22 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
 #include <any>
+#include <array>
 #include <atomic>
+#include <cassert>
 #include <chrono>
 #include <concepts>
 #include <condition_variable>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <deque>
+#include <exception>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -36,6 +44,7 @@ SOFTWARE.
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include "thread_pool.hpp"
 
 namespace nstd::signal_slot
 {
@@ -83,10 +92,10 @@ public:
 
 	paired_ptr(connected_paired_ptr_type *ptr) : _connected_paired_ptr{ ptr }
 	{
-		if (_connected_paired_ptr) _connected_paired_ptr->_connected_paired_ptr = this;
+		if (ptr) ptr->_connected_paired_ptr = this;
 	}
 
-	paired_ptr(paired_ptr &&other) : paired_ptr{ other._connected_paired_ptr }
+	paired_ptr(paired_ptr &&other) : paired_ptr{ other._connected_paired_ptr.load() }
 	{
 		base_type::operator=(static_cast<base_type&&>(std::forward<paired_ptr>(other)));
 		other._connected_paired_ptr = nullptr;
@@ -97,17 +106,13 @@ public:
 
 	paired_ptr & operator=(paired_ptr &&other)
 	{
-		if (_connected_paired_ptr)
-		{
-			if (other._connected_paired_ptr)
-				std::swap(_connected_paired_ptr->_connected_paired_ptr, other._connected_paired_ptr->_connected_paired_ptr);
-			else
-				_connected_paired_ptr->_connected_paired_ptr = &other;
-		}
-		else if (other._connected_paired_ptr)
-			other._connected_paired_ptr->_connected_paired_ptr = this;
-
-		std::swap(_connected_paired_ptr, other._connected_paired_ptr);
+		auto connected { _connected_paired_ptr.load() }, other_connected { other._connected_paired_ptr.load() };
+
+		if (connected) connected->_connected_paired_ptr = &other;
+		if (other_connected) other_connected->_connected_paired_ptr = this;
+
+		_connected_paired_ptr = other_connected;
+		other._connected_paired_ptr = connected;
 
 		base_type::operator=(static_cast<base_type&&>(std::forward<paired_ptr>(other)));
 
@@ -126,11 +131,8 @@ public:
 
 	void disconnect()
 	{
-		if (_connected_paired_ptr)
-		{
-			_connected_paired_ptr->_connected_paired_ptr = nullptr;
-			_connected_paired_ptr = nullptr;
-		}
+		if (auto connected { _connected_paired_ptr.exchange(nullptr) })
+			connected->_connected_paired_ptr = nullptr;
 	}
 
 	const connected_paired_ptr_type * connected_ptr() const
@@ -149,7 +151,8 @@ public:
 	}
 
 protected:
-	connected_paired_ptr_type *_connected_paired_ptr = nullptr;
+	// atomic so that a connection may be dropped while another thread is emitting through it
+	std::atomic<connected_paired_ptr_type*> _connected_paired_ptr { nullptr };
 
 };
 
@@ -190,7 +193,10 @@ protected:
     template<typename... Args> friend class signal;
 
     paired_ptr<> _connection {};
-    bool _enabled { true };
+    std::atomic_bool _enabled { true };
+    // set for slots connected with connect_batch(); the tag names the batch type the functor expects
+    std::function<void(const void*)> _batch_functor {};
+    const void *_batch_tag { nullptr };
 
 public:
     void enabled(bool is_enabled) { _enabled = is_enabled; }
@@ -295,6 +301,22 @@ protected:
     const signal_base *_signal { nullptr };
 };
 
+namespace detail
+{
+
+template<typename Batch>
+inline constexpr char batch_tag {};
+
+inline size_t reader_stripe(size_t stripes)
+{
+    static std::atomic<size_t> next_stripe { 0 };
+    static thread_local const size_t stripe { next_stripe.fetch_add(1, std::memory_order_relaxed) };
+
+    return stripe % stripes;
+}
+
+}
+
 template<typename... Args>
 class signal : public signal_base
 {
@@ -303,40 +325,35 @@ public:
     signal(const std::u8string &name) : _name{ name } {}
     signal(signal &&other) = default;
     signal &operator=(signal &&other) = default;
-    virtual ~signal() override = default;
 
-    void emit(const Args &... args)
+    virtual ~signal() override
     {
-        if (!_enabled) return;
+        delete _snapshot.load(std::memory_order_relaxed);
 
-        std::scoped_lock<std::mutex> lock { _emit_lock };
+        for (auto list : _retired) delete list;
+        for (auto list : _grace_retired) delete list;
+    }
 
+    void emit(const Args &... args)
+    {
         if (!_enabled) return;
 
+        bool has_disconnected { false };
+
         {
-            std::scoped_lock<std::mutex> lock { _connect_lock };
+            reader_guard guard { *this };
 
-            if (!std::empty(_pending_connections))
+            if (!guard.list) return;
+
+            for (auto &callable : guard.list->slots)
             {
-                std::move(std::begin(_pending_connections), std::end(_pending_connections), std::back_inserter(_slots));
+                if (callable->is_disconnected()) { has_disconnected = true; continue; }
 
-                _pending_connections.clear();
+                if (callable->enabled()) (*callable)(args...);
             }
         }
 
-        auto end = _slots.end();
-
-        if (!std::empty(_slots))
-        {
-            _slots.erase(std::remove_if(std::begin(_slots), end, [&args...](auto &callable)
-            {
-                if (callable.is_disconnected()) return true;
-
-                if (callable.enabled()) callable(args...);
-
-                return callable.is_disconnected();
-            }), end);
-        }
+        if (has_disconnected) prune();
     }
 
     void operator() (const Args &... args)
@@ -344,15 +361,37 @@ public:
         emit(args...);
     }
 
+    using batch_type = std::span<const std::tuple<Args...>>;
+
+    // delivers a burst through a single snapshot: batch slots receive the whole span in one call,
+    // the other slots are called once per element
+    void emit_batch(batch_type batch)
+    {
+        if (std::empty(batch)) return;
+
+        emit_batch_to_slots(batch, std::size(batch), [batch](slot_type &callable, size_t idx)
+        {
+            std::apply(callable, batch[idx]);
+        });
+    }
+
     virtual connection connect(std::function<void(Args...)> &&callable)
     {
-        std::scoped_lock<std::mutex> lock { _connect_lock };
-        auto end { std::end(_pending_connections) };
+        return connect_slot(std::make_shared<slot_type>(std::forward<std::function<void(Args...)>>(callable)));
+    }
+
+    // a plain emit() reaches a batch slot as a span of one element
+    virtual connection connect_batch(std::function<void(batch_type)> &&callable)
+    {
+        auto shared_callable { std::make_shared<std::function<void(batch_type)>>(std::forward<std::function<void(batch_type)>>(callable)) };
 
-        _pending_connections.erase(std::remove_if(std::begin(_pending_connections), end, std::mem_fn(&slot<Args...>::is_disconnected)), end);
-        _pending_connections.emplace_back(std::forward<std::function<void(Args...)>>(callable));
+        return connect_slot(std::make_shared<slot_type>([shared_callable](const Args &... args)
+        {
+            std::tuple<Args...> element { args... };
 
-        return { this, _pending_connections.back() };
+            (*shared_callable)(batch_type { &element, 1 });
+        }),
+        [shared_callable](const void *batch) { (*shared_callable)(*static_cast<const batch_type*>(batch)); }, &detail::batch_tag<batch_type>);
     }
 
     virtual connection operator += (std::function<void(Args...)> &&callable)
@@ -368,17 +407,18 @@ public:
 
     virtual void clear()
     {
-        std::scoped_lock<std::mutex, std::mutex> lock { _connect_lock, _emit_lock };
+        std::scoped_lock<std::mutex> lock { _connect_lock };
 
-        _pending_connections.clear();
-        _slots.clear();
+        publish(nullptr);
     }
 
     virtual size_t size() const override
     {
-        std::scoped_lock<std::mutex> lock { _emit_lock };
+        reader_guard guard { *this };
+
+        if (!guard.list) return 0;
 
-        return std::size(_slots);
+        return std::count_if(std::begin(guard.list->slots), std::end(guard.list->slots), [](auto &s) { return !s->is_disconnected(); });
     }
 
     void name(const std::u8string &name)
@@ -417,10 +457,9 @@ public:
 
     virtual void enable_slot(const paired_ptr<> &slot, bool enabled) override
     {
-        auto send { std::end(_slots) };
-        auto sit { std::find(std::begin(_slots), send, slot) };
+        reader_guard guard { *this };
 
-        if (sit != send) sit->enabled(enabled);
+        if (auto s { find_slot(guard.list, slot) }) s->enabled(enabled);
     }
 
     virtual bool is_slot_enabled(const slot_base &slot) const override
@@ -430,18 +469,188 @@ public:
 
     virtual bool is_slot_enabled(const paired_ptr<> &slot) const override
     {
-        auto send { std::cend(_slots) };
-        auto sit { std::find(std::cbegin(_slots), send, slot) };
+        reader_guard guard { *this };
 
-        if (sit != send) return sit->enabled();
+        if (auto s { find_slot(guard.list, slot) }) return s->enabled();
 
         return false;
     }
 
 protected:
+    using slot_type = slot<Args...>;
+
+    connection connect_slot(std::shared_ptr<slot_type> &&new_slot, std::function<void(const void*)> &&batch_functor = {}, const void *batch_tag = nullptr)
+    {
+        new_slot->_batch_functor = std::move(batch_functor);
+        new_slot->_batch_tag = batch_tag;
+
+        connection result { this, *new_slot };
+
+        std::scoped_lock<std::mutex> lock { _connect_lock };
+        auto list { new slot_list {} };
+        auto current { _snapshot.load(std::memory_order_relaxed) };
+
+        if (current)
+        {
+            list->slots.reserve(std::size(current->slots) + 1);
+
+            std::copy_if(std::begin(current->slots), std::end(current->slots), std::back_inserter(list->slots), [](auto &s) { return !s->is_disconnected(); });
+        }
+
+        list->slots.push_back(std::move(new_slot));
+
+        publish(list);
+
+        return result;
+    }
+
+    // element by element like a run of emit() calls, so a slot that disconnects or disables itself
+    // misses the rest of the burst; batch slots get the whole span in the first round
+    template<typename Batch, typename ElementInvoker>
+    void emit_batch_to_slots(const Batch &batch, size_t count, ElementInvoker &&invoke_element)
+    {
+        if (!_enabled) return;
+
+        bool has_disconnected { false };
+
+        {
+            reader_guard guard { *this };
+
+            if (!guard.list) return;
+
+            for (size_t idx { 0 }; idx < count; ++idx)
+                for (auto &callable : guard.list->slots)
+                {
+                    if (callable->is_disconnected()) { has_disconnected = true; continue; }
+
+                    if (!callable->enabled()) continue;
+
+                    if (callable->_batch_tag != &detail::batch_tag<Batch>) invoke_element(*callable, idx);
+                    else if (idx == 0) callable->_batch_functor(&batch);
+                }
+        }
+
+        if (has_disconnected) prune();
+    }
+
+    struct slot_list
+    {
+        std::vector<std::shared_ptr<slot_type>> slots {};
+    };
+
+    struct alignas(64) reader_counter
+    {
+        std::array<std::atomic<size_t>, 2> value {};
+    };
+
+    static constexpr size_t reader_stripes { 8 };
+
+    // a reader announces itself on its stripe under the current phase before loading the snapshot;
+    // a writer that flips the phase after unlinking a snapshot only has to wait for the readers of the previous phase
+    struct reader_guard
+    {
+        reader_guard(const signal &owner)
+        {
+            auto &stripe { owner._readers[detail::reader_stripe(reader_stripes)] };
+
+            for (;;)
+            {
+                auto phase { owner._phase.load(std::memory_order_seq_cst) };
+
+                counter = &stripe.value[phase];
+                counter->fetch_add(1, std::memory_order_seq_cst);
+
+                // a flip in between may not have seen this reader, so it registers again under the new phase
+                if (owner._phase.load(std::memory_order_seq_cst) == phase) break;
+
+                counter->fetch_sub(1, std::memory_order_release);
+            }
+
+            list = owner._snapshot.load(std::memory_order_seq_cst);
+        }
+
+        ~reader_guard()
+        {
+            counter->fetch_sub(1, std::memory_order_release);
+        }
+
+        std::atomic<size_t> *counter { nullptr };
+        const slot_list *list { nullptr };
+    };
+
+    static slot_type *find_slot(const slot_list *list, const paired_ptr<> &slot)
+    {
+        if (!list) return nullptr;
+
+        auto send { std::end(list->slots) };
+        auto sit { std::find_if(std::begin(list->slots), send, [&slot](auto &s) { return *s == slot; }) };
+
+        return sit != send ? sit->get() : nullptr;
+    }
+
+    // called by the writers with _connect_lock held
+    void publish(slot_list *list)
+    {
+        if (auto old { _snapshot.exchange(list, std::memory_order_seq_cst) }) _retired.push_back(old);
+
+        reclaim();
+    }
+
+    // snapshots unlinked before the last phase flip are freed as soon as the previous phase has drained on every stripe;
+    // the ones retired since then are moved behind a new flip, so a steady stream of new readers cannot hold them back
+    void reclaim()
+    {
+        for (;;)
+        {
+            if (!std::empty(_grace_retired))
+            {
+                auto previous_phase { _phase.load(std::memory_order_relaxed) ^ 1 };
+
+                for (auto &reader : _readers)
+                    if (reader.value[previous_phase].load(std::memory_order_seq_cst)) return;
+
+                for (auto list : _grace_retired) delete list;
+
+                _grace_retired.clear();
+            }
+
+            if (std::empty(_retired)) return;
+
+            _grace_retired.swap(_retired);
+            _phase.store(_phase.load(std::memory_order_relaxed) ^ 1, std::memory_order_seq_cst);
+        }
+    }
+
+    // emitters never wait for a writer: if the lock is busy the next writer drops the dead slots
+    void prune()
+    {
+        std::unique_lock<std::mutex> lock { _connect_lock, std::try_to_lock };
+
+        if (!lock) return;
+
+        auto current { _snapshot.load(std::memory_order_relaxed) };
+
+        if (!current) return;
+
+        auto list { new slot_list {} };
+
+        std::copy_if(std::begin(current->slots), std::end(current->slots), std::back_inserter(list->slots), [](auto &s) { return !s->is_disconnected(); });
+
+        if (std::empty(list->slots))
+        {
+            delete list;
+            list = nullptr;
+        }
+
+        publish(list);
+    }
+
     std::u8string _name {};
-    std::vector<slot<Args...>> _slots {}, _pending_connections {};
-    mutable std::mutex _connect_lock {}, _emit_lock {}, _name_lock {};
+    std::atomic<slot_list*> _snapshot { nullptr };
+    std::vector<slot_list*> _retired {}, _grace_retired {};
+    std::atomic<size_t> _phase { 0 };
+    mutable std::array<reader_counter, reader_stripes> _readers {};
+    mutable std::mutex _connect_lock {}, _name_lock {};
     mutable std::atomic_bool _enabled { true };
     std::any _payload;
 };
@@ -467,6 +676,43 @@ public:
     {
         emit(args...);
     }
+
+    using batch_type = std::span<const std::tuple<Args...>>;
+
+    void emit_batch(batch_type batch)
+    {
+        if (std::empty(batch)) return;
+
+        base_class::emit_batch_to_slots(batch_context { this, batch }, std::size(batch), [this, batch](auto &callable, size_t idx)
+        {
+            std::apply([this, &callable](const Args&... a) { callable(this, a...); }, batch[idx]);
+        });
+    }
+
+    connection connect_batch(std::function<void(signal_base*, batch_type)> &&callable)
+    {
+        auto shared_callable { std::make_shared<std::function<void(signal_base*, batch_type)>>(std::forward<std::function<void(signal_base*, batch_type)>>(callable)) };
+
+        return base_class::connect_slot(std::make_shared<typename base_class::slot_type>([shared_callable](signal_base *sender, const Args &... args)
+        {
+            std::tuple<Args...> element { args... };
+
+            (*shared_callable)(sender, batch_type { &element, 1 });
+        }),
+        [shared_callable](const void *batch)
+        {
+            auto &context { *static_cast<const batch_context*>(batch) };
+
+            (*shared_callable)(context.sender, context.batch);
+        }, &detail::batch_tag<batch_context>);
+    }
+
+protected:
+    struct batch_context
+    {
+        signal_base *sender;
+        batch_type batch;
+    };
 };
 
 template<template <typename...> typename signal_type, typename... Args>
@@ -487,6 +733,8 @@ public:
     bridged_signal_base &operator=(bridged_signal_base &&other) = default;
     virtual ~bridged_signal_base() override = default;
 
+    using batch_type = std::span<const std::tuple<Args...>>;
+
     void emit(const Args&... args)
     {
         if (!base_class::_enabled) return;
@@ -514,45 +762,94 @@ public:
         base_class::emit(args...);
     }
 
+    // queues a whole burst under one lock; without an emit functor taking it over the burst is delivered right away
+    void emit_batch(batch_type batch)
+    {
+        if (!base_class::_enabled || std::empty(batch)) return;
+
+        if (_bridge_enabled)
+        {
+            {
+                std::scoped_lock<std::mutex> lock { _queue_lock };
+
+                _signal_queue.insert(std::end(_signal_queue), std::begin(batch), std::end(batch));
+            }
+
+            if (!_emit_functor || !_emit_functor(this)) invoke_all();
+        }
+        else base_class::emit_batch(batch);
+    }
+
     virtual bool invoke_next()
     {
-        if (std::empty(_signal_queue)) return false;
+        std::scoped_lock<std::mutex> invoke_lock { _invoke_lock };
+        std::optional<std::tuple<Args...>> args {};
+        bool has_more { false };
 
-        std::scoped_lock<std::mutex> lock { _queue_lock };
+        {
+            std::scoped_lock<std::mutex> lock { _queue_lock };
 
-        if (std::empty(_signal_queue)) return false;
+            if (_queue_head == std::size(_signal_queue)) return false;
 
-        std::apply([this](const Args&... a){ base_class::emit(a...); }, _signal_queue.front());
+            args.emplace(std::move(_signal_queue[_queue_head++]));
 
-        _signal_queue.pop_front();
+            if (_queue_head == std::size(_signal_queue)) clear_queue_unlocked();
+            else if (_queue_head >= 64 && _queue_head * 2 >= std::size(_signal_queue))
+            {
+                _signal_queue.erase(std::begin(_signal_queue), std::begin(_signal_queue) + _queue_head);
+                _queue_head = 0;
+            }
 
-        return !std::empty(_signal_queue);
+            has_more = _queue_head != std::size(_signal_queue);
+        }
+
+        std::apply([this](const Args&... a){ base_class::emit(a...); }, *args);
+
+        return has_more;
     }
 
+    // the queue is swapped out so that emitters are not blocked while the slots run
     virtual void invoke_all()
     {
-        if (std::empty(_signal_queue)) return;
+        std::scoped_lock<std::mutex> invoke_lock { _invoke_lock };
+        size_t head { 0 };
 
-        std::scoped_lock<std::mutex> lock { _queue_lock };
+        {
+            std::scoped_lock<std::mutex> lock { _queue_lock };
 
-        if (std::empty(_signal_queue)) return;
+            if (_queue_head == std::size(_signal_queue)) return;
 
-        for (auto &&args : _signal_queue) std::apply([this](const Args&... a){ base_class::emit(a...); }, args);
+            _invoke_buffer.swap(_signal_queue);
 
-        _signal_queue.clear();
+            head = std::exchange(_queue_head, 0);
+        }
+
+        base_class::emit_batch(batch_type { _invoke_buffer }.subspan(head));
+
+        _invoke_buffer.clear();
+
+        std::scoped_lock<std::mutex> lock { _queue_lock };
+
+        // hand the larger buffer back to the queue so that bursts do not reallocate every time
+        if (std::empty(_signal_queue) && _signal_queue.capacity() < _invoke_buffer.capacity()) _signal_queue.swap(_invoke_buffer);
     }
 
     virtual void invoke_last_and_clear()
     {
-        if (std::empty(_signal_queue)) return;
+        std::scoped_lock<std::mutex> invoke_lock { _invoke_lock };
+        std::optional<std::tuple<Args...>> args {};
 
-        std::scoped_lock<std::mutex> lock { _queue_lock };
+        {
+            std::scoped_lock<std::mutex> lock { _queue_lock };
 
-        if (std::empty(_signal_queue)) return;
+            if (_queue_head == std::size(_signal_queue)) return;
 
-        std::apply([this](const Args&... a){ base_class::emit(a...); }, _signal_queue.back());
+            args.emplace(std::move(_signal_queue.back()));
 
-        _signal_queue.clear();
+            clear_queue_unlocked();
+        }
+
+        std::apply([this](const Args&... a){ base_class::emit(a...); }, *args);
     }
 
     void set_emit_functor(const std::function<bool(bridged_signal_base*)>& emit_functor)
@@ -569,7 +866,7 @@ public:
     {
         std::scoped_lock<std::mutex> lock { _queue_lock };
 
-        return std::size(_signal_queue);
+        return std::size(_signal_queue) - _queue_head;
     }
 
     void set_bridge_enabled(bool enabled)
@@ -584,25 +881,321 @@ public:
 
     void clear_queue()
     {
-        if (std::empty(_signal_queue)) return;
-
         std::scoped_lock<std::mutex> lock { _queue_lock };
 
-        if (std::empty(_signal_queue)) return;
-
-        _signal_queue.clear();
+        clear_queue_unlocked();
     }
 
 protected:
     std::atomic_bool _bridge_enabled { true };
-    std::mutex _queue_lock {};
-    std::deque<std::tuple<Args...>> _signal_queue {};
+    mutable std::mutex _queue_lock {};
+    std::mutex _invoke_lock {};
+    // a vector consumed from _queue_head keeps the queued arguments contiguous, so they can be handed out as a span
+    std::vector<std::tuple<Args...>> _signal_queue {}, _invoke_buffer {};
+    size_t _queue_head { 0 };
     std::function<bool(bridged_signal_base*)> _emit_functor { nullptr };
+
+    void clear_queue_unlocked()
+    {
+        _signal_queue.clear();
+        _queue_head = 0;
+    }
 };
 
 template<typename... Args> using bridged_signal = bridged_signal_base<signal, Args...>;
 template<typename... Args> using bridged_signal_ex = bridged_signal_base<signal_ex, Args...>;
 
+// one timer thread plus a small pooled executor shared by every deferred signal type, so the thread count
+// does not depend on how many throttled/queued/timer signals are alive
+class signal_dispatcher
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static signal_dispatcher &instance()
+    {
+        static signal_dispatcher dispatcher {};
+
+        return dispatcher;
+    }
+
+    signal_dispatcher(const signal_dispatcher &other) = delete;
+    signal_dispatcher &operator=(const signal_dispatcher &other) = delete;
+
+    ~signal_dispatcher()
+    {
+        {
+            std::scoped_lock<std::mutex> lock { _timer_lock };
+
+            _stopped = true;
+        }
+
+        _timer_condition.notify_one();
+
+        if (_timer_thread.joinable()) _timer_thread.join();
+    }
+
+    template<typename Functor>
+    void post(Functor &&functor)
+    {
+        _executor.post(std::forward<Functor>(functor));
+    }
+
+    // the functor is handed over to the executor once the deadline has passed;
+    // deadlines that fall into the same tick are fired by a single wakeup
+    void schedule(clock_type::time_point deadline, std::function<void()> &&functor)
+    {
+        {
+            std::scoped_lock<std::mutex> lock { _timer_lock };
+
+            auto tick { std::max(to_tick(deadline), _current_tick + 1) };
+            auto &bucket { _wheel[tick % wheel_size] };
+
+            bucket.entries.push_back({ tick, std::move(functor) });
+            bucket.min_tick = std::min(bucket.min_tick, tick);
+
+            if (tick >= _next_tick) return;
+
+            _next_tick = tick;
+        }
+
+        _timer_condition.notify_one();
+    }
+
+    size_t thread_count() const
+    {
+        return _executor.size() + 1;
+    }
+
+    // a slot throwing on a deferred dispatch does not stall its signal, the first such exception is kept until it is rethrown here
+    void rethrow_slot_exception()
+    {
+        _executor.rethrow_job_exception();
+    }
+
+private:
+    static constexpr size_t wheel_size { 512 };
+    static constexpr std::chrono::milliseconds tick_duration { 1 };
+    static constexpr uint64_t no_tick { std::numeric_limits<uint64_t>::max() };
+
+    struct timer_entry
+    {
+        uint64_t tick;
+        std::function<void()> functor;
+    };
+
+    struct bucket
+    {
+        std::vector<timer_entry> entries {};
+        uint64_t min_tick { no_tick };
+    };
+
+    const clock_type::time_point _origin { clock_type::now() };
+    std::array<bucket, wheel_size> _wheel {};
+    uint64_t _current_tick { 0 }, _next_tick { no_tick };
+    bool _stopped { false };
+    std::mutex _timer_lock {};
+    std::condition_variable _timer_condition {};
+    std::thread _timer_thread {};
+    // declared last so that it is torn down first, while the wheel its tasks may schedule into is still alive
+    nstd::thread_pool _executor { static_cast<long>(std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u)) };
+
+    signal_dispatcher()
+    {
+        _timer_thread = std::thread { [this] { timer_procedure(); } };
+    }
+
+    // rounds up, so a timer never fires before its deadline
+    uint64_t to_tick(clock_type::time_point time_point) const
+    {
+        auto elapsed { time_point - _origin };
+
+        if (elapsed <= clock_type::duration::zero()) return 0;
+
+        return static_cast<uint64_t>((elapsed + tick_duration - clock_type::duration { 1 }) / tick_duration);
+    }
+
+    uint64_t elapsed_ticks() const
+    {
+        return static_cast<uint64_t>((clock_type::now() - _origin) / tick_duration);
+    }
+
+    void expire_bucket(bucket &b, uint64_t now_tick, std::vector<std::function<void()>> &expired)
+    {
+        if (b.min_tick > now_tick) return;
+
+        b.min_tick = no_tick;
+
+        for (size_t idx { 0 }; idx < std::size(b.entries);)
+        {
+            auto &entry { b.entries[idx] };
+
+            if (entry.tick <= now_tick)
+            {
+                expired.push_back(std::move(entry.functor));
+
+                entry = std::move(b.entries.back());
+                b.entries.pop_back();
+            }
+            else
+            {
+                b.min_tick = std::min(b.min_tick, entry.tick);
+                ++idx;
+            }
+        }
+    }
+
+    void timer_procedure()
+    {
+        std::unique_lock<std::mutex> lock { _timer_lock };
+        std::vector<std::function<void()>> expired {};
+
+        while (!_stopped)
+        {
+            if (_next_tick == no_tick)
+            {
+                _timer_condition.wait(lock);
+
+                continue;
+            }
+
+            auto now_tick { elapsed_ticks() };
+
+            if (_next_tick > now_tick)
+            {
+                _timer_condition.wait_until(lock, _origin + _next_tick * tick_duration);
+
+                continue;
+            }
+
+            if (now_tick - _current_tick >= wheel_size)
+                for (auto &b : _wheel) expire_bucket(b, now_tick, expired);
+            else
+                for (auto tick { _current_tick + 1 }; tick <= now_tick; ++tick) expire_bucket(_wheel[tick % wheel_size], now_tick, expired);
+
+            _current_tick = now_tick;
+            _next_tick = no_tick;
+
+            for (auto &b : _wheel) _next_tick = std::min(_next_tick, b.min_tick);
+
+            lock.unlock();
+
+            for (auto &functor : expired) _executor.post(std::move(functor));
+
+            expired.clear();
+
+            lock.lock();
+        }
+    }
+};
+
+// binds deferred work to the lifetime of its owner: close() drops everything still pending
+// and waits for a functor that is running right now (unless it is the caller itself)
+class dispatch_channel
+{
+public:
+    dispatch_channel() = default;
+    dispatch_channel(const dispatch_channel &other) = delete;
+    dispatch_channel &operator=(const dispatch_channel &other) = delete;
+
+    ~dispatch_channel()
+    {
+        close();
+    }
+
+    template<typename Functor>
+    void post(Functor &&functor)
+    {
+        signal_dispatcher::instance().post(wrap(std::forward<Functor>(functor)));
+    }
+
+    template<typename Duration, typename Functor>
+    void post_after(const Duration &delay, Functor &&functor)
+    {
+        signal_dispatcher::instance().schedule(signal_dispatcher::clock_type::now() + delay, wrap(std::forward<Functor>(functor)));
+    }
+
+    void close()
+    {
+        std::unique_lock<std::mutex> lock { _state->lock };
+
+        _state->closed = true;
+        ++_state->epoch;
+
+        _state->idle.wait(lock, [this] { return _state->running == 0 || _state->runner == std::this_thread::get_id(); });
+    }
+
+    void reopen()
+    {
+        std::scoped_lock<std::mutex> lock { _state->lock };
+
+        _state->closed = false;
+    }
+
+    bool runs_on_this_thread() const
+    {
+        std::scoped_lock<std::mutex> lock { _state->lock };
+
+        return _state->runner == std::this_thread::get_id();
+    }
+
+private:
+    struct channel_state
+    {
+        std::mutex lock {};
+        std::condition_variable idle {};
+        uint64_t epoch { 0 };
+        size_t running { 0 };
+        std::thread::id runner {};
+        bool closed { false };
+    };
+
+    std::shared_ptr<channel_state> _state { std::make_shared<channel_state>() };
+
+    template<typename Functor>
+    std::function<void()> wrap(Functor &&functor)
+    {
+        uint64_t epoch { 0 };
+
+        {
+            std::scoped_lock<std::mutex> lock { _state->lock };
+
+            epoch = _state->epoch;
+        }
+
+        return [state = _state, epoch, functor = std::forward<Functor>(functor)]() mutable
+        {
+            {
+                std::scoped_lock<std::mutex> lock { state->lock };
+
+                if (state->closed || state->epoch != epoch) return;
+
+                ++state->running;
+                state->runner = std::this_thread::get_id();
+            }
+
+            struct run_guard
+            {
+                channel_state &state;
+
+                ~run_guard()
+                {
+                    {
+                        std::scoped_lock<std::mutex> lock { state.lock };
+
+                        --state.running;
+                        state.runner = {};
+                    }
+
+                    state.idle.notify_all();
+                }
+            } guard { *state };
+
+            functor();
+        };
+    }
+};
+
 template<template <typename...> typename signal_type, typename... Args>
 requires std::derived_from<signal_type<Args...>, signal_base>
 class throttled_signal_base : public signal_type<Args...>
@@ -617,21 +1210,28 @@ public:
     throttled_signal_base(throttled_signal_base &&other) = default;
     throttled_signal_base &operator=(throttled_signal_base &&other) = default;
 
+    // must not be destroyed from one of its own slots: the dispatch running that slot still uses the signal once it returns
     virtual ~throttled_signal_base() override
     {
-        _cancelled = true;
+        assert(!_channel.runs_on_this_thread() && "throttled_signal destroyed from its own slot");
 
-        if (_dispatcher_thread.joinable()) _dispatcher_thread.join();
+        _channel.close();
 
         if (_dispatch_all_on_destroy)
         {
-            std::scoped_lock<std::mutex> lock { _emit_lock };
+            std::unique_lock<std::mutex> lock { _emit_lock };
 
             while (!std::empty(_signal_queue))
             {
-                std::apply([this](const Args&... a){ base_class::emit(a...); }, _signal_queue.front());
+                auto args { std::move(_signal_queue.front()) };
 
                 _signal_queue.pop_front();
+
+                lock.unlock();
+
+                std::apply([this](const Args&... a){ base_class::emit(a...); }, args);
+
+                lock.lock();
             }
         }
     }
@@ -642,11 +1242,11 @@ public:
 
         _signal_queue.push_back(std::make_tuple(args...));
 
-        if (!_thread_running.exchange(true))
+        if (!_dispatch_pending)
         {
-            if (_dispatcher_thread.joinable()) _dispatcher_thread.join();
+            _dispatch_pending = true;
 
-            _dispatcher_thread = std::thread([this](){ queue_dispatcher(); });
+            _channel.post([this] { dispatch_next(); });
         }
     }
 
@@ -681,29 +1281,57 @@ protected:
     std::deque<std::tuple<Args...>> _signal_queue {};
     std::mutex _emit_lock {};
     std::atomic<std::chrono::milliseconds> _throttle_ms { _default_throttle_ms };
-    std::thread _dispatcher_thread {};
-    std::atomic_bool _cancelled { false }, _thread_running { false }, _dispatch_all_on_destroy { true };
+    std::atomic_bool _dispatch_all_on_destroy { true };
+    bool _dispatch_pending { false };
+    dispatch_channel _channel {};
 
-    void queue_dispatcher()
+    void dispatch_next()
     {
-        while (!_cancelled)
+        std::optional<std::tuple<Args...>> args {};
+
         {
+            std::scoped_lock<std::mutex> lock { _emit_lock };
+
+            if (std::empty(_signal_queue))
             {
-                std::scoped_lock<std::mutex> lock { _emit_lock };
+                _dispatch_pending = false;
 
-                if (_cancelled || std::empty(_signal_queue)) break;
+                return;
+            }
 
-                std::apply([this](const Args&... a){ base_class::emit(a...); }, _signal_queue.front());
+            args.emplace(std::move(_signal_queue.front()));
 
-                _signal_queue.pop_front();
+            _signal_queue.pop_front();
+        }
 
-                if (std::empty(_signal_queue)) break;
-            }
+        // schedules the rest of the queue even when a slot throws, the exception goes on to signal_dispatcher::rethrow_slot_exception()
+        struct dispatch_guard
+        {
+            throttled_signal_base &owner;
 
-            std::this_thread::sleep_for(_throttle_ms.load());
-        }
+            ~dispatch_guard()
+            {
+                std::scoped_lock<std::mutex> lock { owner._emit_lock };
+
+                if (std::empty(owner._signal_queue))
+                {
+                    owner._dispatch_pending = false;
+
+                    return;
+                }
+
+                try
+                {
+                    owner._channel.post_after(owner._throttle_ms.load(), [&owner = owner] { owner.dispatch_next(); });
+                }
+                catch (...)
+                {
+                    owner._dispatch_pending = false;
+                }
+            }
+        } guard { *this };
 
-        _thread_running = false;
+        std::apply([this](const Args&... a){ base_class::emit(a...); }, *args);
     }
 };
 
@@ -730,35 +1358,28 @@ public:
 
     virtual ~queued_signal_base() override
     {
-        std::scoped_lock<std::mutex> lock_ { _destruct_lock };
+        std::unique_lock<std::mutex> lock { _emit_lock };
 
-        _cancelled = true;
+        _dispatch_idle.wait(lock, [this] { return _dispatching != this || _dispatching_thread == std::this_thread::get_id(); });
 
-        if (_dispatcher_thread.joinable()) _dispatcher_thread.join();
+        std::deque<std::tuple<Args...>> own_queue {};
+        auto end { std::end(_signal_queue) };
 
-        if (_dispatch_all_on_destroy)
+        _signal_queue.erase(std::remove_if(std::begin(_signal_queue), end, [this, &own_queue](auto &value)
         {
-            std::scoped_lock<std::mutex> lock { _emit_lock };
+            auto &[this_, args] = value;
 
-            auto end { std::end(_signal_queue) };
+            if (this_ != this) return false;
 
-            if (!std::empty(_signal_queue))
-            {
-                _signal_queue.erase(std::remove_if(std::begin(_signal_queue), end, [this](auto &value)
-                {
-                    auto &[this_, args] = value;
+            own_queue.push_back(std::move(args));
 
-                    if (this_ == this)
-                    {
-                        std::apply([this](const Args&... a){ base_class::emit(a...); }, args);
+            return true;
+        }), end);
 
-                        return true;
-                    }
+        lock.unlock();
 
-                    return false;
-                }), end);
-            }
-        }
+        if (_dispatch_all_on_destroy)
+            for (auto &args : own_queue) std::apply([this](const Args&... a){ base_class::emit(a...); }, args);
     }
 
     void emit(const Args &... args)
@@ -767,12 +1388,7 @@ public:
 
         _signal_queue.push_back({ this, std::make_tuple(args...) });
 
-        if (!_thread_running.exchange(true))
-        {
-            if (_dispatcher_thread.joinable()) _dispatcher_thread.join();
-
-            _dispatcher_thread = std::thread(&queue_dispatcher);
-        }
+        schedule_dispatch();
     }
 
     void operator() (const Args &... args)
@@ -780,6 +1396,17 @@ public:
         emit(args...);
     }
 
+    void emit_batch(std::span<const std::tuple<Args...>> batch)
+    {
+        if (std::empty(batch)) return;
+
+        std::scoped_lock<std::mutex> lock { _emit_lock };
+
+        for (auto &args : batch) _signal_queue.push_back({ this, args });
+
+        schedule_dispatch();
+    }
+
     template<typename Duration>
     static void delay_ms(const Duration &duration)
     {
@@ -812,34 +1439,113 @@ public:
     }
 
 protected:
+    // how many queued emissions one executor task handles before it yields to the other scopes
+    static constexpr size_t _dispatch_batch_size { 64 };
+
     static inline std::deque<std::tuple<queued_signal_base*, std::tuple<Args...>>> _signal_queue {};
-    static inline std::mutex _emit_lock {}, _destruct_lock {};
+    static inline std::mutex _emit_lock {};
+    static inline std::condition_variable _dispatch_idle {};
+    static inline queued_signal_base *_dispatching { nullptr };
+    static inline std::thread::id _dispatching_thread {};
+    static inline bool _dispatch_pending { false };
     static inline std::atomic<std::chrono::milliseconds> _delay_ms { 0ms };
-    static inline std::thread _dispatcher_thread {};
-    static inline std::atomic_bool _use_delay { false }, _cancelled { false }, _thread_running { false }, _dispatch_all_on_destroy { true };
+    static inline std::atomic_bool _use_delay { false }, _dispatch_all_on_destroy { true };
 
+    static void schedule_dispatch()
+    {
+        if (_dispatch_pending) return;
+
+        _dispatch_pending = true;
+
+        signal_dispatcher::instance().post(&queue_dispatcher);
+    }
+
+    // relocks after a batch and releases the destructors waiting for it; when a slot throws, the rest of the queue
+    // is handed to a new task and the exception goes on to signal_dispatcher::rethrow_slot_exception()
+    struct dispatch_guard
+    {
+        std::unique_lock<std::mutex> &lock;
+        int exceptions { std::uncaught_exceptions() };
+
+        ~dispatch_guard()
+        {
+            lock.lock();
+
+            _dispatching = nullptr;
+            _dispatching_thread = {};
+
+            _dispatch_idle.notify_all();
+
+            if (std::uncaught_exceptions() == exceptions) return;
+
+            if (std::empty(_signal_queue))
+            {
+                _dispatch_pending = false;
+
+                return;
+            }
+
+            try
+            {
+                signal_dispatcher::instance().post(&queue_dispatcher);
+            }
+            catch (...)
+            {
+                _dispatch_pending = false;
+            }
+        }
+    };
+
+    // the queue of a scope is drained by one executor task at a time, which keeps the emission order;
+    // consecutive emissions of the same signal are delivered to it as one batch
     static void queue_dispatcher()
     {
-        while (!_cancelled)
+        std::unique_lock<std::mutex> lock { _emit_lock };
+        std::vector<std::tuple<Args...>> batch {};
+
+        for (size_t dispatched { 0 }; !std::empty(_signal_queue);)
         {
+            if (dispatched >= _dispatch_batch_size)
             {
-                std::scoped_lock<std::mutex> lock { _emit_lock };
+                signal_dispatcher::instance().post(&queue_dispatcher);
 
-                if (_cancelled || std::empty(_signal_queue)) break;
+                return;
+            }
 
-                auto &[this_, args] = _signal_queue.front();
+            auto this_ { std::get<0>(_signal_queue.front()) };
+            auto batch_limit { _use_delay ? 1 : _dispatch_batch_size - dispatched };
 
-                std::apply([&this_](const Args&... a){ this_->base_class::emit(a...); }, args);
+            while (!std::empty(_signal_queue) && std::size(batch) < batch_limit && std::get<0>(_signal_queue.front()) == this_)
+            {
+                batch.push_back(std::move(std::get<1>(_signal_queue.front())));
 
                 _signal_queue.pop_front();
+            }
+
+            dispatched += std::size(batch);
+
+            _dispatching = this_;
+            _dispatching_thread = std::this_thread::get_id();
+
+            lock.unlock();
 
-                if (std::empty(_signal_queue)) break;
+            {
+                dispatch_guard guard { lock };
+
+                this_->base_class::emit_batch(batch);
             }
 
-            if (_use_delay) std::this_thread::sleep_for(_delay_ms.load());
+            batch.clear();
+
+            if (_use_delay && !std::empty(_signal_queue))
+            {
+                signal_dispatcher::instance().schedule(signal_dispatcher::clock_type::now() + _delay_ms.load(), &queue_dispatcher);
+
+                return;
+            }
         }
 
-        _thread_running = false;
+        _dispatch_pending = false;
     }
 };
 
@@ -860,8 +1566,11 @@ public:
     timer_signal(timer_signal &&other) = default;
     timer_signal &operator=(timer_signal &&other) = default;
 
+    // stop_timer() may be called from a slot, but the signal must not be destroyed there
     virtual ~timer_signal() override
     {
+        assert(!_channel.runs_on_this_thread() && "timer_signal destroyed from its own slot");
+
         stop_timer();
     }
 
@@ -869,26 +1578,28 @@ public:
     {
         if (!_timer_enabled.exchange(true))
         {
-            _args = std::make_tuple(this, args...);
+            {
+                std::scoped_lock<std::mutex> lock { _emit_lock };
 
-            if (_timer_thread.joinable()) _timer_thread.join();
+                _args = std::make_tuple(this, args...);
+            }
 
-            _sleep.reset();
+            _channel.reopen();
 
-            _timer_thread = std::thread([this](){ timer_procedure(); });
+            schedule_tick(++_generation);
         }
     }
 
     void stop_timer()
     {
-        _sleep.cancel_wait();
+        _timer_enabled = false;
 
-        if (_timer_thread.joinable()) _timer_thread.join();
+        _channel.close();
     }
 
     void disable_timer_from_slot()
     {
-        _sleep.cancel_wait();
+        _timer_enabled = false;
     }
 
     template<typename Duration>
@@ -905,53 +1616,46 @@ public:
 private:
 
     std::atomic_bool _timer_enabled { false };
-    std::thread _timer_thread {};
+    std::atomic<uint64_t> _generation { 0 };
     std::atomic<std::chrono::milliseconds> _timer_ms { 1s };
     mutable std::mutex _emit_lock {};
     std::tuple<timer_signal*, Args...> _args {};
-    class
-    {
-    public:
+    dispatch_channel _channel {};
 
-        bool wait_for(const std::chrono::milliseconds &duration)
-        {
-            std::unique_lock<std::mutex> lock { _m };
-            
-            return !_cv.wait_for(lock, duration, [this]{ return _cancelled.load(); });
-        }
+    void schedule_tick(uint64_t generation)
+    {
+        _channel.post_after(_timer_ms.load(), [this, generation] { tick(generation); });
+    }
 
-        void cancel_wait()
-        {
-            _cancelled = true;
-            
-            _cv.notify_all();
-        }
+    // a tick of a previous start_timer() may still be queued; the generation tells it apart
+    void tick(uint64_t generation)
+    {
+        if (!_timer_enabled || generation != _generation) return;
 
-        void reset()
+        // the next tick is scheduled even when a slot throws, the exception goes on to signal_dispatcher::rethrow_slot_exception()
+        struct tick_guard
         {
-            _cancelled = false;
-        }
+            timer_signal &owner;
+            uint64_t generation;
 
-    private:
-
-        std::condition_variable _cv {};
-        std::mutex _m {};
-        std::atomic_bool _cancelled { false };
-    } _sleep;
-
-
-    void timer_procedure()
-    {
-        while (_sleep.wait_for(_timer_ms.load()))
-        {
+            ~tick_guard()
             {
-                std::scoped_lock<std::mutex> lock { _emit_lock };
+                if (!owner._timer_enabled || generation != owner._generation) return;
 
-                std::apply([this](timer_signal *s, const Args&... a){ base_class::emit(s, a...); }, _args);
+                try
+                {
+                    owner.schedule_tick(generation);
+                }
+                catch (...)
+                {
+                    owner._timer_enabled = false;
+                }
             }
-        }
+        } guard { *this, generation };
 
-        _timer_enabled = false;
+        std::scoped_lock<std::mutex> lock { _emit_lock };
+
+        std::apply([this](timer_signal *s, const Args&... a){ base_class::emit(s, a...); }, _args);
     }
 };
 
@@ -20,15 +20,29 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <future>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <new>
+#include <optional>
 #include <queue>
 #include <stdexcept>
 #include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace nstd
 {
@@ -168,15 +182,18 @@ public:
         return _queue.empty();
     }
 
+    // the elements are destroyed outside the lock, so their destructors may push again
     void clear()
     {
-        std::scoped_lock lock { _mutex };
-
         decltype(_queue) empty;
-        
-        std::swap(_queue, empty);
 
-        _condition.notify_all();
+        {
+            std::scoped_lock lock { _mutex };
+
+            std::swap(_queue, empty);
+
+            _condition.notify_all();
+        }
     }
 
     void invalidate()
@@ -202,75 +219,796 @@ private:
     std::condition_variable _condition {};
 };
 
+// Chase-Lev work-stealing deque (see "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al.).
+// push()/pop() may only be called by the owning thread, steal() by any thread. T must be a trivially copyable type
+// (typically a pointer) whose value-initialized state means "empty".
+template <typename T>
+class work_stealing_deque
+{
+private:
+    class ring_buffer
+    {
+    public:
+        explicit ring_buffer(std::int64_t capacity) : _capacity { capacity }, _mask { capacity - 1 }, _items { std::make_unique<std::atomic<T>[]>(capacity) } {}
+
+        std::int64_t capacity() const { return _capacity; }
+        T get(std::int64_t index) const { return _items[index & _mask].load(std::memory_order_relaxed); }
+        void put(std::int64_t index, T item) { _items[index & _mask].store(item, std::memory_order_relaxed); }
+
+        std::unique_ptr<ring_buffer> grow(std::int64_t bottom, std::int64_t top) const
+        {
+            auto new_buffer { std::make_unique<ring_buffer>(_capacity * 2) };
+
+            for (auto idx { top }; idx != bottom; ++idx) new_buffer->put(idx, get(idx));
+
+            return new_buffer;
+        }
+
+    private:
+        std::int64_t _capacity;
+        std::int64_t _mask;
+        std::unique_ptr<std::atomic<T>[]> _items;
+    };
+
+public:
+    explicit work_stealing_deque(std::int64_t capacity = 1024)
+    {
+        std::int64_t power_of_two { 2 };
+
+        while (power_of_two < capacity) power_of_two <<= 1;
+
+        _buffers.emplace_back(std::make_unique<ring_buffer>(power_of_two));
+        _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    void push(T item)
+    {
+        auto bottom { _bottom.load(std::memory_order_relaxed) };
+        auto top { _top.load(std::memory_order_acquire) };
+        auto buffer { _buffer.load(std::memory_order_relaxed) };
+
+        if (bottom - top > buffer->capacity() - 1)
+        {
+            // the old buffers are kept alive since concurrent thieves may still be reading from them
+            _buffers.emplace_back(buffer->grow(bottom, top));
+            buffer = _buffers.back().get();
+            _buffer.store(buffer, std::memory_order_release);
+        }
+
+        buffer->put(bottom, item);
+
+        std::atomic_thread_fence(std::memory_order_release);
+
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    T pop()
+    {
+        auto bottom { _bottom.load(std::memory_order_relaxed) - 1 };
+        auto buffer { _buffer.load(std::memory_order_relaxed) };
+
+        _bottom.store(bottom, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        auto top { _top.load(std::memory_order_relaxed) };
+        T item {};
+
+        if (top <= bottom)
+        {
+            item = buffer->get(bottom);
+
+            if (top == bottom)
+            {
+                if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) item = T {};
+
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+        }
+        else _bottom.store(bottom + 1, std::memory_order_relaxed);
+
+        return item;
+    }
+
+    T steal()
+    {
+        auto top { _top.load(std::memory_order_acquire) };
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        auto bottom { _bottom.load(std::memory_order_acquire) };
+
+        if (top >= bottom) return T {};
+
+        auto item { _buffer.load(std::memory_order_acquire)->get(top) };
+
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return T {};
+
+        return item;
+    }
+
+    bool empty() const
+    {
+        return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+    }
+
+private:
+    alignas(64) std::atomic<std::int64_t> _top { 0 };
+    alignas(64) std::atomic<std::int64_t> _bottom { 0 };
+    alignas(64) std::atomic<ring_buffer*> _buffer { nullptr };
+    std::vector<std::unique_ptr<ring_buffer>> _buffers {};
+};
+
+// Dmitry Vyukov's bounded multi-producer/multi-consumer queue
+template <typename T>
+class mpmc_bounded_queue
+{
+private:
+    struct cell
+    {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+public:
+    explicit mpmc_bounded_queue(std::size_t capacity = 4096)
+    {
+        std::size_t power_of_two { 2 };
+
+        while (power_of_two < capacity) power_of_two <<= 1;
+
+        _mask = power_of_two - 1;
+        _cells = std::make_unique<cell[]>(power_of_two);
+
+        for (std::size_t idx { 0 }; idx < power_of_two; ++idx) _cells[idx].sequence.store(idx, std::memory_order_relaxed);
+    }
+
+    mpmc_bounded_queue(const mpmc_bounded_queue&) = delete;
+    mpmc_bounded_queue& operator=(const mpmc_bounded_queue&) = delete;
+
+    bool try_push(T value)
+    {
+        auto position { _enqueue_position.load(std::memory_order_relaxed) };
+
+        while (true)
+        {
+            auto &current_cell { _cells[position & _mask] };
+            auto sequence { current_cell.sequence.load(std::memory_order_acquire) };
+            auto diff { static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position) };
+
+            if (diff == 0)
+            {
+                if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    current_cell.data = std::move(value);
+                    current_cell.sequence.store(position + 1, std::memory_order_release);
+
+                    return true;
+                }
+            }
+            else if (diff < 0) return false;
+            else position = _enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool try_pop(T& out)
+    {
+        auto position { _dequeue_position.load(std::memory_order_relaxed) };
+
+        while (true)
+        {
+            auto &current_cell { _cells[position & _mask] };
+            auto sequence { current_cell.sequence.load(std::memory_order_acquire) };
+            auto diff { static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1) };
+
+            if (diff == 0)
+            {
+                if (_dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    out = std::move(current_cell.data);
+                    current_cell.sequence.store(position + _mask + 1, std::memory_order_release);
+
+                    return true;
+                }
+            }
+            else if (diff < 0) return false;
+            else position = _dequeue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::size_t _mask { 0 };
+    std::unique_ptr<cell[]> _cells {};
+    alignas(64) std::atomic<std::size_t> _enqueue_position { 0 };
+    alignas(64) std::atomic<std::size_t> _dequeue_position { 0 };
+};
+
+// Lock-free fixed-size block allocator used to recycle task objects. Blocks are carved out of chunks that are never
+// returned to the memory resource until the slab itself dies; the slab is reference counted by its owner and by every
+// block currently in use, so task states may safely outlive the thread_pool that created them.
+class task_slab
+{
+private:
+    static constexpr std::uint32_t empty_index { std::numeric_limits<std::uint32_t>::max() };
+    static constexpr std::size_t blocks_per_chunk { 1024 };
+    static constexpr std::size_t max_chunks { 4096 };
+
+    struct block
+    {
+        alignas(std::max_align_t) std::byte storage[192];
+        std::atomic<std::uint32_t> next { empty_index };
+        std::uint32_t index { 0 };
+    };
+
+public:
+    static constexpr std::size_t block_size { sizeof(block::storage) };
+
+    static task_slab *create(std::pmr::memory_resource *resource) { return new task_slab { resource }; }
+
+    task_slab(const task_slab&) = delete;
+    task_slab& operator=(const task_slab&) = delete;
+
+    void add_reference() { _references.fetch_add(1, std::memory_order_relaxed); }
+
+    void release()
+    {
+        if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+
+    // returns nullptr when the slab is exhausted, the caller is expected to fall back to the heap then
+    void *allocate()
+    {
+        auto head { _free_head.load(std::memory_order_acquire) };
+
+        while (index_of(head) != empty_index)
+        {
+            auto &free_block { block_at(index_of(head)) };
+            auto next { free_block.next.load(std::memory_order_relaxed) };
+
+            if (_free_head.compare_exchange_weak(head, pack(next, tag_of(head) + 1), std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                add_reference();
+
+                return free_block.storage;
+            }
+        }
+
+        if (auto new_block { grow() })
+        {
+            add_reference();
+
+            return new_block->storage;
+        }
+
+        return nullptr;
+    }
+
+    void deallocate(void *memory)
+    {
+        push(*reinterpret_cast<block*>(memory));
+        release();
+    }
+
+    // tasks that do not fit into a block, or find the slab exhausted, are taken straight from the memory resource
+    void *allocate_large(std::size_t size, std::size_t alignment)
+    {
+        auto memory { _resource->allocate(size, alignment) };
+
+        add_reference();
+
+        return memory;
+    }
+
+    void deallocate_large(void *memory, std::size_t size, std::size_t alignment)
+    {
+        _resource->deallocate(memory, size, alignment);
+        release();
+    }
+
+private:
+    explicit task_slab(std::pmr::memory_resource *resource) : _resource { resource } {}
+
+    ~task_slab()
+    {
+        for (std::size_t idx { 0 }; idx < _chunks_count; ++idx)
+        {
+            std::destroy_n(_chunks[idx], blocks_per_chunk);
+
+            _resource->deallocate(_chunks[idx], sizeof(block) * blocks_per_chunk, alignof(block));
+        }
+    }
+
+    static std::uint64_t pack(std::uint32_t index, std::uint32_t tag) { return (static_cast<std::uint64_t>(tag) << 32) | index; }
+    static std::uint32_t index_of(std::uint64_t head) { return static_cast<std::uint32_t>(head); }
+    static std::uint32_t tag_of(std::uint64_t head) { return static_cast<std::uint32_t>(head >> 32); }
+
+    block &block_at(std::uint32_t index) { return _chunks[index / blocks_per_chunk][index % blocks_per_chunk]; }
+
+    void push(block &free_block)
+    {
+        auto head { _free_head.load(std::memory_order_relaxed) };
+
+        do free_block.next.store(index_of(head), std::memory_order_relaxed);
+        while (!_free_head.compare_exchange_weak(head, pack(free_block.index, tag_of(head) + 1), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    block *grow()
+    {
+        std::scoped_lock lock { _grow_mutex };
+
+        if (_chunks_count == max_chunks) return nullptr;
+
+        auto chunk_index { _chunks_count };
+        auto chunk { _chunks[chunk_index] = static_cast<block*>(_resource->allocate(sizeof(block) * blocks_per_chunk, alignof(block))) };
+
+        std::uninitialized_default_construct_n(chunk, blocks_per_chunk);
+
+        for (std::size_t idx { 0 }; idx < blocks_per_chunk; ++idx) chunk[idx].index = static_cast<std::uint32_t>(chunk_index * blocks_per_chunk + idx);
+
+        ++_chunks_count;
+
+        for (std::size_t idx { 1 }; idx < blocks_per_chunk; ++idx) push(chunk[idx]);
+
+        return &chunk[0];
+    }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> _free_head { pack(empty_index, 0) };
+    alignas(64) std::atomic<std::uint32_t> _references { 1 };
+    std::pmr::memory_resource *_resource;
+    std::mutex _grow_mutex {};
+    std::size_t _chunks_count { 0 };
+    block *_chunks[max_chunks] {};
+};
+
+class thread_task_base
+{
+public:
+    thread_task_base() = default;
+    virtual ~thread_task_base() = default;
+    thread_task_base(const thread_task_base& rhs) = delete;
+    thread_task_base& operator=(const thread_task_base& rhs) = delete;
+
+    // both calls hand the task's ownership back, so the task must not be touched afterwards
+    virtual void execute() = 0;
+    virtual void discard() = 0;
+};
+
+struct thread_task_deleter
+{
+    void operator()(thread_task_base *task) const { task->discard(); }
+};
+
+using thread_task_ptr = std::unique_ptr<thread_task_base, thread_task_deleter>;
+
+// Timed waits on a task park on one of a few shared condition variables picked by the task's address, which keeps
+// the task state small enough for a slab block.
+struct task_parking_lot
+{
+    struct alignas(64) bucket
+    {
+        std::mutex mutex {};
+        std::condition_variable condition {};
+    };
+
+    static bucket &for_address(const void *address)
+    {
+        static std::array<bucket, 32> buckets {};
+
+        return buckets[(reinterpret_cast<std::uintptr_t>(address) / 64) % std::size(buckets)];
+    }
+};
+
+template <typename Result>
+class thread_task_state : public thread_task_base
+{
+public:
+    bool is_ready() const { return _ready.load(std::memory_order_acquire); }
+
+    void wait() const
+    {
+        while (!is_ready()) _ready.wait(false, std::memory_order_acquire);
+    }
+
+    template <typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period> &timeout) const
+    {
+        return wait_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename Clock, typename Duration>
+    std::future_status wait_until(const std::chrono::time_point<Clock, Duration> &deadline) const
+    {
+        if (is_ready()) return std::future_status::ready;
+
+        auto &bucket { task_parking_lot::for_address(this) };
+
+        // either make_ready() sees the waiter registered or the waiter sees the task ready under the bucket's lock
+        _timed_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+        {
+            std::unique_lock lock { bucket.mutex };
+
+            bucket.condition.wait_until(lock, deadline, [this] { return _ready.load(std::memory_order_seq_cst); });
+        }
+
+        _timed_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+        return is_ready() ? std::future_status::ready : std::future_status::timeout;
+    }
+
+    Result get()
+    {
+        wait();
+
+        if (_exception) std::rethrow_exception(_exception);
+
+        if constexpr (std::is_reference_v<Result>) return static_cast<Result>(*_result);
+        else if constexpr (!std::is_void_v<Result>) return std::move(*_result);
+    }
+
+    void release_reference()
+    {
+        if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1) dispose();
+    }
+
+protected:
+    template <typename Functor>
+    void run(Functor &functor)
+    {
+        try
+        {
+            if constexpr (std::is_void_v<Result>) functor();
+            else if constexpr (std::is_reference_v<Result>) _result = std::addressof(functor());
+            else _result.emplace(functor());
+        }
+        catch (...)
+        {
+            _exception = std::current_exception();
+        }
+
+        make_ready();
+    }
+
+    void abandon()
+    {
+        _exception = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+
+        make_ready();
+    }
+
+    virtual void dispose() = 0;
+
+private:
+    void make_ready()
+    {
+        _ready.store(true, std::memory_order_seq_cst);
+        _ready.notify_all();
+
+        if (_timed_waiters.load(std::memory_order_seq_cst) == 0) return;
+
+        auto &bucket { task_parking_lot::for_address(this) };
+
+        {
+            std::scoped_lock lock { bucket.mutex };
+        }
+
+        bucket.condition.notify_all();
+    }
+
+private:
+    using storage_type = std::conditional_t<std::is_void_v<Result>, std::monostate,
+                         std::conditional_t<std::is_reference_v<Result>, std::add_pointer_t<std::remove_reference_t<Result>>,
+                                            std::optional<Result>>>;
+
+    std::atomic<std::uint32_t> _references { 2 };
+    mutable std::atomic<std::uint32_t> _timed_waiters { 0 };
+    std::atomic_bool _ready { false };
+    std::exception_ptr _exception {};
+    storage_type _result {};
+};
+
+// Move-only counterpart of std::future for the tasks enqueued on thread_pool. Its state lives in the pool's task slab,
+// next to the task itself, so no additional allocation is needed to get the result back.
+template <typename Result>
+class task_future
+{
+public:
+    task_future() = default;
+    explicit task_future(thread_task_state<Result> *state) : _state { state } {}
+    task_future(const task_future&) = delete;
+    task_future& operator=(const task_future&) = delete;
+    task_future(task_future &&other) noexcept : _state { std::exchange(other._state, nullptr) } {}
+
+    task_future& operator=(task_future &&other) noexcept
+    {
+        if (this != &other) reset(std::exchange(other._state, nullptr));
+
+        return *this;
+    }
+
+    ~task_future() { reset(); }
+
+    bool valid() const { return _state != nullptr; }
+    bool is_ready() const { return valid() && _state->is_ready(); }
+
+    void wait() const { state().wait(); }
+
+    template <typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period> &timeout) const { return state().wait_for(timeout); }
+
+    template <typename Clock, typename Duration>
+    std::future_status wait_until(const std::chrono::time_point<Clock, Duration> &deadline) const { return state().wait_until(deadline); }
+
+    Result get()
+    {
+        struct releaser { void operator()(thread_task_state<Result> *state) const { state->release_reference(); } };
+
+        std::unique_ptr<thread_task_state<Result>, releaser> state_guard { &state() };
+
+        _state = nullptr;
+
+        return state_guard->get();
+    }
+
+private:
+    thread_task_state<Result> &state() const
+    {
+        if (!_state) throw std::future_error(std::future_errc::no_state);
+
+        return *_state;
+    }
+
+    void reset(thread_task_state<Result> *state = nullptr)
+    {
+        if (_state) _state->release_reference();
+
+        _state = state;
+    }
+
+private:
+    thread_task_state<Result> *_state { nullptr };
+};
+
+enum class scheduling_policy
+{
+    shared_queue,
+    work_stealing
+};
+
 class thread_pool
 {
 private:
-    class thread_task_base
+    template <typename Functor, typename Result>
+    class pooled_task final : public thread_task_state<Result>
     {
     public:
-        thread_task_base() = default;
-        virtual ~thread_task_base() = default;
-        thread_task_base(const thread_task_base& rhs) = delete;
-        thread_task_base& operator=(const thread_task_base& rhs) = delete;
-        thread_task_base(thread_task_base&& other) = default;
-        thread_task_base& operator=(thread_task_base&& other) = default;
-        virtual void execute() = 0;
+        pooled_task(Functor &&functor, task_slab *slab, bool in_block) : _functor { std::move(functor) }, _slab { slab }, _in_block { in_block } {}
+
+        void execute() override
+        {
+            this->run(*_functor);
+
+            _functor.reset();
+
+            this->release_reference();
+        }
+
+        void discard() override
+        {
+            _functor.reset();
+
+            this->abandon();
+            this->release_reference();
+        }
+
+    private:
+        void dispose() override { dispose_task(this, _slab, _in_block); }
+
+    private:
+        std::optional<Functor> _functor;
+        task_slab *_slab;
+        bool _in_block;
     };
 
+    // an exception thrown by the functor leaves execute() after the job is disposed, the pool keeps it for rethrow_job_exception()
     template <typename Functor>
-    class thread_task: public thread_task_base
+    class pooled_job final : public thread_task_base
     {
     public:
-        thread_task(Functor&& functor) :_functor { std::move(functor) } { }
-        ~thread_task() override = default;
-        thread_task(const thread_task& rhs) = delete;
-        thread_task& operator=(const thread_task& rhs) = delete;
-        thread_task(thread_task&& other) = default;
-        thread_task& operator=(thread_task&& other) = default;
-        void execute() override { _functor(); }
+        pooled_job(Functor &&functor, task_slab *slab, bool in_block) : _functor { std::move(functor) }, _slab { slab }, _in_block { in_block } {}
+
+        void execute() override
+        {
+            struct disposer
+            {
+                pooled_job *job;
+
+                ~disposer() { dispose_task(job, job->_slab, job->_in_block); }
+            } guard { this };
+
+            _functor();
+        }
+
+        void discard() override { dispose_task(this, _slab, _in_block); }
 
     private:
         Functor _functor;
+        task_slab *_slab;
+        bool _in_block;
     };
 
+    template <typename Task>
+    static void dispose_task(Task *task, task_slab *slab, bool in_block)
+    {
+        void *memory { task };
+
+        task->~Task();
+
+        if (in_block) slab->deallocate(memory);
+        else slab->deallocate_large(memory, sizeof(Task), alignof(Task));
+    }
+
+    template <typename Functor, typename... Args>
+    static auto bind_arguments(Functor&& functor, Args&&... args)
+    {
+        if constexpr (sizeof...(Args) == 0) return std::decay_t<Functor> { std::forward<Functor>(functor) };
+        else return [functor = std::forward<Functor>(functor), arguments = std::make_tuple(std::forward<Args>(args)...)]() mutable -> decltype(auto)
+        {
+            return std::apply(functor, arguments);
+        };
+    }
+
+    template <typename Task, typename Functor>
+    Task *make_task(Functor &&functor)
+    {
+        void *memory { nullptr };
+
+        if constexpr (sizeof(Task) <= task_slab::block_size && alignof(Task) <= alignof(std::max_align_t)) memory = _slab->allocate();
+
+        bool in_block { memory != nullptr };
+
+        if (!in_block) memory = _slab->allocate_large(sizeof(Task), alignof(Task));
+
+        try
+        {
+            return ::new (memory) Task { std::move(functor), _slab, in_block };
+        }
+        catch (...)
+        {
+            if (in_block) _slab->deallocate(memory);
+            else _slab->deallocate_large(memory, sizeof(Task), alignof(Task));
+
+            throw;
+        }
+    }
+
 public:
-    explicit thread_pool(long num_threads = std::max(std::thread::hardware_concurrency(), 2u) - 1u)
+    // the memory resource backs the task slab and the tasks too large for it; it has to outlive the pool
+    // and every task_future the pool returned
+    explicit thread_pool(long num_threads = std::max(std::thread::hardware_concurrency(), 2u) - 1u, scheduling_policy policy = scheduling_policy::shared_queue,
+                         std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : _policy { policy }, _slab { task_slab::create(resource) }
     {
         if (num_threads < 1) num_threads = 1;
 
         try
         {
-            while (--num_threads >= 0) _worker_threads.emplace_back(&thread_pool::worker, this);
+            if (_policy == scheduling_policy::work_stealing)
+            {
+                for (long idx { 0 }; idx < num_threads; ++idx) _worker_queues.emplace_back(std::make_unique<work_stealing_deque<thread_task_base*>>());
+                for (long idx { 0 }; idx < num_threads; ++idx) _worker_threads.emplace_back(&thread_pool::stealing_worker, this, static_cast<std::size_t>(idx));
+            }
+            else while (--num_threads >= 0) _worker_threads.emplace_back(&thread_pool::worker, this);
         }
         catch(...)
         {
             destroy();
+
+            _slab->release();
+
             throw;
         }
     }
 
     thread_pool(const thread_pool& rhs) = delete;
     thread_pool& operator=(const thread_pool& rhs) = delete;
-    ~thread_pool() { destroy(); }
+    ~thread_pool()
+    {
+        destroy();
+
+        _slab->release();
+    }
 
+    // returns a std::future; its shared state is allocated per call, submit() avoids that
     template <typename Functor, typename... Args>
     auto enqueue(Functor&& functor, Args&&... args)
     {
-        auto bound_task = std::bind(std::forward<Functor>(functor), std::forward<Args>(args)...);
-        using result_type = std::result_of_t<decltype(bound_task)()>;
-        using packaged_task = std::packaged_task<result_type()>;
-        using task_type = thread_task<packaged_task>;
-        
-        packaged_task task{ std::move(bound_task) };
-        std::future<result_type> result { task.get_future() };
+        auto bound_task { bind_arguments(std::forward<Functor>(functor), std::forward<Args>(args)...) };
+        using result_type = std::invoke_result_t<decltype(bound_task)&>;
 
-        _task_queue.push(std::make_unique<task_type>(std::move(task)));
+        std::packaged_task<result_type()> task { std::move(bound_task) };
+        auto result { task.get_future() };
+
+        post(std::move(task));
 
         return result;
     }
 
+    // allocation-free counterpart of enqueue: the task and its result share one block of the task slab
+    template <typename Functor, typename... Args>
+    auto submit(Functor&& functor, Args&&... args)
+    {
+        auto bound_task { bind_arguments(std::forward<Functor>(functor), std::forward<Args>(args)...) };
+        using result_type = std::invoke_result_t<decltype(bound_task)&>;
+        using task_type = pooled_task<decltype(bound_task), result_type>;
+
+        auto task { make_task<task_type>(std::move(bound_task)) };
+        task_future<result_type> result { task };
+
+        schedule(thread_task_ptr { task });
+
+        return result;
+    }
+
+    // fire-and-forget version of submit: no future is created, see rethrow_job_exception() for the failures
+    template <typename Functor, typename... Args>
+    void post(Functor&& functor, Args&&... args)
+    {
+        auto bound_task { bind_arguments(std::forward<Functor>(functor), std::forward<Args>(args)...) };
+        using task_type = pooled_job<decltype(bound_task)>;
+
+        schedule(thread_task_ptr { make_task<task_type>(std::move(bound_task)) });
+    }
+
+    // a posted job has no future to carry its failure, so the pool keeps the first exception thrown by one
+    // and rethrows it here, clearing it
+    void rethrow_job_exception()
+    {
+        std::exception_ptr exception {};
+
+        {
+            std::scoped_lock lock { _job_exception_mutex };
+
+            exception = std::exchange(_job_exception, nullptr);
+        }
+
+        if (exception) std::rethrow_exception(exception);
+    }
+
+    // executes one queued task on the calling thread if there is any, so a thread waiting for its subtasks
+    // (a worker of this pool included) can help instead of blocking; a cancelled pool discards its queued tasks
+    // instead and returns false
+    bool run_pending_task()
+    {
+        if (_cancelled) { discard_pending_tasks(); return false; }
+
+        if (_policy == scheduling_policy::shared_queue)
+        {
+            thread_task_ptr task { nullptr };
+
+            if (!_task_queue.try_pop(task)) return false;
+
+            execute(task.release());
+
+            return true;
+        }
+
+        auto task { find_task(_current_pool == this ? _current_index : std::numeric_limits<std::size_t>::max()) };
+
+        if (!task) return false;
+
+        execute(task);
+
+        return true;
+    }
+
     auto size() const { return std::size(_worker_threads); }
 
+    scheduling_policy policy() const { return _policy; }
+
     operator bool ()
     {
         return !_cancelled;
@@ -281,9 +1019,129 @@ private:
     {
         while(!_cancelled)
         {
-            std::unique_ptr<thread_task_base> task { nullptr };
+            thread_task_ptr task { nullptr };
+
+            if(_task_queue.wait_pop(task)) execute(task.release());
+        }
+    }
+
+    void stealing_worker(std::size_t index)
+    {
+        _current_pool = this;
+        _current_index = index;
+
+        while (!_cancelled)
+        {
+            auto epoch { _epoch.load() };
+
+            if (auto task { find_task(index) })
+            {
+                execute(task);
+
+                continue;
+            }
+
+            std::unique_lock lock { _park_mutex };
+
+            ++_sleepers;
+
+            _park_condition.wait(lock, [this, epoch]{ return _cancelled || _epoch.load() != epoch; });
+
+            --_sleepers;
+        }
+
+        _current_pool = nullptr;
+    }
+
+    void execute(thread_task_base *task)
+    {
+        try
+        {
+            task->execute();
+        }
+        catch (...)
+        {
+            std::scoped_lock lock { _job_exception_mutex };
+
+            if (!_job_exception) _job_exception = std::current_exception();
+        }
+    }
+
+    void schedule(thread_task_ptr task)
+    {
+        if (_policy == scheduling_policy::shared_queue) { _task_queue.push(std::move(task)); return; }
+
+        if (_current_pool == this) _worker_queues[_current_index]->push(task.release());
+        else if (!_injection_queue.try_push(task.get()))
+        {
+            std::scoped_lock lock { _overflow_mutex };
+
+            _overflow_queue.push(std::move(task));
+            _has_overflow = true;
+        }
+        else task.release();
+
+        ++_epoch;
+
+        if (_sleepers.load() > 0)
+        {
+            { std::scoped_lock lock { _park_mutex }; }
+
+            _park_condition.notify_one();
+        }
+    }
+
+    thread_task_base *find_task(std::size_t index)
+    {
+        const auto queues_count { std::size(_worker_queues) };
+        thread_task_base *task { nullptr };
+
+        if (index < queues_count && (task = _worker_queues[index]->pop())) return task;
+
+        if (_injection_queue.try_pop(task)) return task;
+
+        if (_has_overflow.load(std::memory_order_relaxed))
+        {
+            std::scoped_lock lock { _overflow_mutex };
 
-            if(_task_queue.wait_pop(task)) task->execute();
+            if (!std::empty(_overflow_queue))
+            {
+                task = _overflow_queue.front().release();
+
+                _overflow_queue.pop();
+                _has_overflow = !std::empty(_overflow_queue);
+
+                return task;
+            }
+        }
+
+        for (std::size_t offset { 1 }; offset <= queues_count; ++offset)
+        {
+            auto victim { (index + offset) % queues_count };
+
+            if (victim != index && (task = _worker_queues[victim]->steal())) return task;
+        }
+
+        return nullptr;
+    }
+
+    // the queued tasks are dropped unrun; discarding a task destroys it, which lets whoever waits for it move on
+    void discard_pending_tasks()
+    {
+        if (_policy == scheduling_policy::shared_queue) { _task_queue.clear(); return; }
+
+        thread_task_base *task { nullptr };
+
+        for (auto &queue : _worker_queues) while ((task = queue->steal())) task->discard();
+        while (_injection_queue.try_pop(task)) task->discard();
+
+        decltype(_overflow_queue) overflow {};
+
+        {
+            std::scoped_lock lock { _overflow_mutex };
+
+            std::swap(_overflow_queue, overflow);
+            _has_overflow = false;
         }
     }
 
@@ -293,20 +1151,148 @@ private:
 
         _task_queue.invalidate();
 
+        // before joining: a worker may be waiting for queued tasks (a nested parallel call) and would never return
+        discard_pending_tasks();
+
+        {
+            std::scoped_lock lock { _park_mutex };
+        }
+
+        _park_condition.notify_all();
+
         for(auto& thread : _worker_threads) if(thread.joinable()) thread.join();
+
+        discard_pending_tasks();
     }
 
 private:
+    scheduling_policy _policy { scheduling_policy::shared_queue };
     std::atomic_bool _cancelled { false };
-    thread_safe_queue<std::unique_ptr<thread_task_base>> _task_queue {};
+    task_slab *_slab;
+    thread_safe_queue<thread_task_ptr> _task_queue {};
     std::deque<std::thread> _worker_threads {};
+
+    std::vector<std::unique_ptr<work_stealing_deque<thread_task_base*>>> _worker_queues {};
+    mpmc_bounded_queue<thread_task_base*> _injection_queue { _policy == scheduling_policy::work_stealing ? 65536u : 2u };
+    std::mutex _overflow_mutex {};
+    std::queue<thread_task_ptr> _overflow_queue {};
+    std::atomic_bool _has_overflow { false };
+    std::atomic<std::uint64_t> _epoch { 0 };
+    std::atomic<std::size_t> _sleepers { 0 };
+    std::mutex _park_mutex {};
+    std::condition_variable _park_condition {};
+    std::mutex _job_exception_mutex {};
+    std::exception_ptr _job_exception {};
+
+    inline static thread_local thread_pool *_current_pool { nullptr };
+    inline static thread_local std::size_t _current_index { 0 };
+};
+
+// Posts tasks to a pool and waits until all of them are done. A task is done once it has run or once the pool
+// has dropped it unrun (a cancelled or destroyed pool), so wait() returns either way. The waiting thread runs
+// pending tasks of the pool meanwhile, which keeps nested waits on a worker from starving the pool, and blocks
+// when there are none until a task finishes or a new one is posted.
+class task_group
+{
+public:
+    explicit task_group(thread_pool &pool) : _pool { pool } {}
+    task_group(const task_group &) = delete;
+    task_group &operator=(const task_group &) = delete;
+
+    // a task the pool refuses is done already when the exception leaves post()
+    template <typename Functor>
+    void post(Functor &&functor)
+    {
+        {
+            std::scoped_lock lock { _mutex };
+
+            ++_pending;
+        }
+
+        _pool.post([ticket = completion_ticket { this }, functor = std::forward<Functor>(functor)]() mutable { functor(); });
+
+        {
+            std::scoped_lock lock { _mutex };
+
+            ++_posted;
+        }
+
+        _changed.notify_all();
+    }
+
+    void wait()
+    {
+        for (;;)
+        {
+            std::uint64_t posted { 0 };
+
+            {
+                std::scoped_lock lock { _mutex };
+
+                if (_pending == 0) return;
+
+                posted = _posted;
+            }
+
+            if (_pool.run_pending_task()) continue;
+
+            std::unique_lock lock { _mutex };
+
+            _changed.wait(lock, [this, posted] { return _pending == 0 || _posted != posted; });
+        }
+    }
+
+private:
+    // travels with the task and marks it done when it is destroyed, after running or unrun
+    class completion_ticket
+    {
+    public:
+        explicit completion_ticket(task_group *group) : _group { group } {}
+        completion_ticket(completion_ticket &&other) noexcept : _group { std::exchange(other._group, nullptr) } {}
+        completion_ticket &operator=(completion_ticket &&other) = delete;
+
+        ~completion_ticket()
+        {
+            if (_group) _group->finish();
+        }
+
+    private:
+        task_group *_group;
+    };
+
+    // notified under the lock: the waiter may destroy the group as soon as it sees nothing pending
+    void finish()
+    {
+        std::scoped_lock lock { _mutex };
+
+        if (--_pending == 0) _changed.notify_all();
+    }
+
+    thread_pool &_pool;
+    std::mutex _mutex {};
+    std::condition_variable _changed {};
+    std::size_t _pending { 0 };
+    std::uint64_t _posted { 0 };
 };
 
 namespace global_thread_pool
 {
+    inline std::atomic<scheduling_policy> _scheduling_policy { scheduling_policy::shared_queue };
+    inline std::atomic_bool _created { false };
+
+    // must be called before the first get_thread_pool() call, returns false if the global pool already exists
+    inline bool set_scheduling_policy(scheduling_policy policy)
+    {
+        if (_created) return false;
+
+        _scheduling_policy = policy;
+
+        return true;
+    }
+
     inline thread_pool& get_thread_pool()
     {
-        static thread_pool static_thread_pool;
+        static thread_pool static_thread_pool(std::max(std::thread::hardware_concurrency(), 2u) - 1u, (_created = true, _scheduling_policy.load()));
 
         return static_thread_pool;
     }
@@ -316,6 +1302,18 @@ namespace global_thread_pool
     {
         return get_thread_pool().enqueue(std::forward<Functor>(functor), std::forward<Args>(args)...);
     }
+
+    template <typename Functor, typename... Args>
+    inline auto submit(Functor&& functor, Args&&... args)
+    {
+        return get_thread_pool().submit(std::forward<Functor>(functor), std::forward<Args>(args)...);
+    }
+
+    template <typename Functor, typename... Args>
+    inline void post(Functor&& functor, Args&&... args)
+    {
+        get_thread_pool().post(std::forward<Functor>(functor), std::forward<Args>(args)...);
+    }
 }
 
 }
@@ -20,9 +20,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include "thread_pool.hpp"
 
 namespace nstd
 {
@@ -79,7 +87,7 @@ public:
         (add(object, dependencies), ...);
     }
 
-    auto sort()
+    auto sort() const
     {
         std::vector<value_type> sorted, cycled;
         auto map { _map };
@@ -95,10 +103,547 @@ public:
         return std::pair(std::move(sorted), std::move(cycled));
     }
 
+    struct execution_statistics
+    {
+        std::vector<value_type> executed {};
+        std::vector<value_type> failed {};
+        std::vector<value_type> skipped {}; // not executed due to the cancellation
+        std::vector<value_type> cycled {};
+        std::vector<value_type> critical_path {};
+        std::chrono::nanoseconds critical_path_duration { 0 };
+        std::chrono::nanoseconds total_work_duration { 0 };
+        std::chrono::nanoseconds wall_duration { 0 };
+        std::exception_ptr error {};
+
+        double parallelism() const { return wall_duration.count() ? double(total_work_duration.count()) / wall_duration.count() : 0.; }
+
+        void rethrow_if_failed() const { if (error) std::rethrow_exception(error); }
+    };
+
+    // Runs 'functor(object)' for every object on the thread pool as soon as all its dependencies are done, so that
+    // independent branches are executed concurrently. The first exception thrown cancels all the objects that are not
+    // started yet, it is reported back through the 'error' field of the returned statistics.
+    template <typename Functor>
+    execution_statistics execute(Functor &&functor, thread_pool &pool = global_thread_pool::get_thread_pool()) const
+    {
+        struct node_state
+        {
+            const relations *node_relations { nullptr };
+            std::atomic<std::size_t> dependencies { 0 };
+            std::chrono::nanoseconds duration { 0 };
+            bool executed { false };
+            bool failed { false };
+        };
+
+        execution_statistics statistics {};
+        std::unordered_map<value_type, node_state> states {};
+        task_group in_flight { pool };
+        std::atomic_bool cancelled { false };
+        std::mutex error_mutex {};
+
+        states.reserve(std::size(_map));
+
+        for (const auto &[object, relations] : _map)
+        {
+            auto &state { states[object] };
+
+            state.node_relations = &relations;
+            state.dependencies = relations.dependencies;
+        }
+
+        // a node the pool refuses to take fails the run like a throwing functor; one a cancelled pool drops is not started
+        auto post_node { [&](const value_type &object, auto &runner)
+        {
+            try
+            {
+                in_flight.post([&object, &runner] { runner(object, runner); });
+            }
+            catch (...)
+            {
+                {
+                    std::scoped_lock lock { error_mutex };
+
+                    if (!statistics.error) statistics.error = std::current_exception();
+                }
+
+                cancelled = true;
+            }
+        } };
+
+        auto run_node { [&](const value_type &object, auto &self) -> void
+        {
+            auto &state { states.find(object)->second };
+
+            if (!cancelled)
+            {
+                auto start { std::chrono::steady_clock::now() };
+
+                try
+                {
+                    functor(object);
+
+                    state.executed = true;
+                }
+                catch (...)
+                {
+                    std::scoped_lock lock { error_mutex };
+
+                    if (!statistics.error) statistics.error = std::current_exception();
+
+                    state.failed = cancelled = true;
+                }
+
+                state.duration = std::chrono::steady_clock::now() - start;
+            }
+
+            if (state.executed)
+            {
+                for (const auto &dependent : state.node_relations->dependents)
+                {
+                    if (states.find(dependent)->second.dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) post_node(dependent, self);
+                }
+            }
+        } };
+
+        auto start { std::chrono::steady_clock::now() };
+
+        for (const auto &[object, state] : states)
+        {
+            if (!state.dependencies) post_node(object, run_node);
+        }
+
+        in_flight.wait();
+
+        statistics.wall_duration = std::chrono::steady_clock::now() - start;
+
+        auto [sorted, cycled] { sort() };
+        std::unordered_map<value_type, std::pair<std::chrono::nanoseconds, const value_type*>> longest_paths {};
+        const value_type *critical_end { nullptr };
+
+        statistics.cycled = std::move(cycled);
+
+        // the critical path is the longest (by the measured duration) dependency chain among the executed objects
+        for (const auto &object : sorted)
+        {
+            const auto &state { states.find(object)->second };
+
+            if (!state.executed) { (state.failed ? statistics.failed : statistics.skipped).emplace_back(object); continue; }
+
+            statistics.executed.emplace_back(object);
+            statistics.total_work_duration += state.duration;
+
+            auto &[length, predecessor] { longest_paths[object] };
+
+            length += state.duration;
+
+            if (!critical_end || length > statistics.critical_path_duration) critical_end = &object, statistics.critical_path_duration = length;
+
+            for (const auto &dependent : state.node_relations->dependents)
+                if (auto &[dependent_length, dependent_predecessor] { longest_paths[dependent] }; !dependent_predecessor || length > dependent_length)
+                    dependent_length = length, dependent_predecessor = &object;
+        }
+
+        for (auto object { critical_end }; object; object = longest_paths[*object].second) statistics.critical_path.emplace_back(*object);
+
+        std::reverse(std::begin(statistics.critical_path), std::end(statistics.critical_path));
+
+        return statistics;
+    }
+
     void clear()
     {
         _map.clear();
     }
 };
 
+// A drop-in alternative to topological_sorter for large graphs: objects are interned into dense integer ids, so
+// sorting is done over flat arrays (the dependents are packed into CSR offsets/targets arrays before each full sort)
+// with no hashing involved. Once the graph was sorted without cycles, the order is maintained incrementally
+// (Pearce-Kelly dynamic topological ordering), so subsequent add()/remove() calls don't trigger a full re-sort.
+template <typename ValueType>
+class indexed_topological_sorter
+{
+public:
+    using value_type = ValueType;
+    using id_type = std::uint32_t;
+
+    static constexpr id_type invalid_id { std::numeric_limits<id_type>::max() };
+
+    void reserve(std::size_t size)
+    {
+        _ids.reserve(size);
+        _values.reserve(size);
+        _dependents.reserve(size);
+        _dependencies.reserve(size);
+    }
+
+    void add(const value_type &object)
+    {
+        intern(object);
+    }
+
+    void add(const value_type &object, const value_type &dependency)
+    {
+        if (dependency == object) return;
+
+        auto dependency_id { intern(dependency) };
+        auto object_id { intern(object) };
+        auto &dependents { _dependents[dependency_id] };
+        auto &dependencies { _dependencies[object_id] };
+
+        if (std::size(dependents) < std::size(dependencies) ? std::find(std::begin(dependents), std::end(dependents), object_id) != std::end(dependents)
+                                                            : std::find(std::begin(dependencies), std::end(dependencies), dependency_id) != std::end(dependencies)) return;
+
+        dependents.emplace_back(object_id);
+        dependencies.emplace_back(dependency_id);
+
+        if (_order_valid && _positions[dependency_id] > _positions[object_id]) reorder(dependency_id, object_id);
+    }
+
+    template <typename Container>
+    void add(const value_type &object, const Container &dependencies)
+    {
+        for (auto const &dependency : dependencies) add(object, dependency);
+    }
+
+    void add(const value_type &object, const std::initializer_list<value_type> &dependencies)
+    {
+        add<std::initializer_list<value_type>>(object, dependencies);
+    }
+
+    template<typename... Args>
+    void add(const value_type &object, const Args&... dependencies)
+    {
+        (add(object, dependencies), ...);
+    }
+
+    // removing a relation never invalidates the current order
+    bool remove(const value_type &object, const value_type &dependency)
+    {
+        auto object_it { _ids.find(object) }, dependency_it { _ids.find(dependency) };
+
+        if (object_it == std::end(_ids) || dependency_it == std::end(_ids)) return false;
+
+        return erase(_dependents[dependency_it->second], object_it->second) && erase(_dependencies[object_it->second], dependency_it->second);
+    }
+
+    bool remove(const value_type &object)
+    {
+        auto it { _ids.find(object) };
+
+        if (it == std::end(_ids)) return false;
+
+        auto id { it->second };
+
+        for (auto dependent : _dependents[id]) erase(_dependencies[dependent], id);
+        for (auto dependency : _dependencies[id]) erase(_dependents[dependency], id);
+
+        _dependents[id].clear();
+        _dependencies[id].clear();
+        _ids.erase(it);
+
+        if (_order_valid)
+        {
+            _order[_positions[id]] = invalid_id;
+
+            ++_holes;
+        }
+
+        // the last id takes the place of the removed one to keep the ids dense
+        if (auto last { static_cast<id_type>(std::size(_values) - 1) }; id != last)
+        {
+            for (auto dependent : _dependents[last]) std::replace(std::begin(_dependencies[dependent]), std::end(_dependencies[dependent]), last, id);
+            for (auto dependency : _dependencies[last]) std::replace(std::begin(_dependents[dependency]), std::end(_dependents[dependency]), last, id);
+
+            _values[id] = std::move(_values[last]);
+            _dependents[id] = std::move(_dependents[last]);
+            _dependencies[id] = std::move(_dependencies[last]);
+            _ids[_values[id]] = id;
+
+            if (_order_valid)
+            {
+                _positions[id] = _positions[last];
+                _order[_positions[id]] = id;
+            }
+        }
+
+        _values.pop_back();
+        _dependents.pop_back();
+        _dependencies.pop_back();
+
+        if (_order_valid) _positions.pop_back();
+
+        if (_holes > std::size(_order) / 2) compact_order();
+
+        return true;
+    }
+
+    auto sort()
+    {
+        std::vector<value_type> sorted, cycled;
+
+        if (!_order_valid) full_sort();
+
+        if (_order_valid)
+        {
+            sorted.reserve(std::size(_values));
+
+            for (auto id : _order) if (id != invalid_id) sorted.emplace_back(_values[id]);
+        }
+        else
+        {
+            sorted.reserve(std::size(_order));
+
+            for (auto id : _order) sorted.emplace_back(_values[id]);
+            for (id_type id { 0 }; id < std::size(_values); ++id) if (_in_degrees[id]) cycled.emplace_back(_values[id]);
+        }
+
+        return std::pair(std::move(sorted), std::move(cycled));
+    }
+
+    // returns node-disjoint dependency cycles, every cycle is listed in the dependency order (each object depends on
+    // the previous one, the first one depends on the last one)
+    std::vector<std::vector<value_type>> find_cycles()
+    {
+        std::vector<std::vector<value_type>> cycles;
+
+        if (!_order_valid) full_sort();
+        if (_order_valid) return cycles;
+
+        // the nodes left by the full sort are either on cycles or depend on them; the latter ones are peeled off
+        // backwards, so every remaining node has at least one remaining dependent
+        std::vector<std::uint8_t> states(std::size(_values), 0);
+        std::vector<std::size_t> out_degrees(std::size(_values), 0);
+        std::vector<id_type> queue;
+
+        for (id_type id { 0 }; id < std::size(_values); ++id)
+        {
+            if (!_in_degrees[id]) continue;
+
+            for (auto dependent : _dependents[id]) out_degrees[id] += _in_degrees[dependent] != 0;
+
+            if (!out_degrees[id]) queue.emplace_back(id);
+
+            states[id] = 1;
+        }
+
+        while (!std::empty(queue))
+        {
+            auto id { queue.back() };
+
+            queue.pop_back();
+            states[id] = 0;
+
+            for (auto dependency : _dependencies[id]) if (states[dependency] == 1 && !--out_degrees[dependency]) queue.emplace_back(dependency);
+        }
+
+        // walking from any remaining node ends up either on a new cycle (state 2 - on the current walk) or on a walk done before (state 3)
+        std::vector<id_type> walk;
+
+        for (id_type start { 0 }; start < std::size(_values); ++start)
+        {
+            if (states[start] != 1) continue;
+
+            walk.clear();
+
+            auto id { start };
+
+            while (states[id] == 1)
+            {
+                states[id] = 2;
+                walk.emplace_back(id);
+                id = *std::find_if(std::begin(_dependents[id]), std::end(_dependents[id]), [&states](auto dependent){ return states[dependent] != 0; });
+            }
+
+            if (states[id] == 2)
+            {
+                auto &cycle { cycles.emplace_back() };
+
+                for (auto it { std::find(std::begin(walk), std::end(walk), id) }; it != std::end(walk); ++it) cycle.emplace_back(_values[*it]);
+            }
+
+            for (auto walked : walk) states[walked] = 3;
+        }
+
+        return cycles;
+    }
+
+    std::size_t size() const { return std::size(_values); }
+
+    void clear()
+    {
+        _ids.clear();
+        _values.clear();
+        _dependents.clear();
+        _dependencies.clear();
+        _order.clear();
+        _positions.clear();
+        _in_degrees.clear();
+        _order_valid = false;
+        _holes = 0;
+    }
+
+private:
+    id_type intern(const value_type &object)
+    {
+        auto [it, inserted] { _ids.try_emplace(object, static_cast<id_type>(std::size(_values))) };
+
+        if (inserted)
+        {
+            _values.emplace_back(object);
+            _dependents.emplace_back();
+            _dependencies.emplace_back();
+
+            if (_order_valid)
+            {
+                _positions.emplace_back(static_cast<id_type>(std::size(_order)));
+                _order.emplace_back(it->second);
+            }
+        }
+
+        return it->second;
+    }
+
+    static bool erase(std::vector<id_type> &ids, id_type id)
+    {
+        auto it { std::find(std::begin(ids), std::end(ids), id) };
+
+        if (it == std::end(ids)) return false;
+
+        *it = ids.back();
+        ids.pop_back();
+
+        return true;
+    }
+
+    // Kahn's algorithm over the CSR representation of the graph
+    void full_sort()
+    {
+        const auto count { std::size(_values) };
+        std::vector<std::size_t> offsets(count + 1, 0);
+
+        for (id_type id { 0 }; id < count; ++id) offsets[id + 1] = offsets[id] + std::size(_dependents[id]);
+
+        std::vector<id_type> targets(offsets[count]);
+
+        _in_degrees.assign(count, 0);
+
+        for (id_type id { 0 }; id < count; ++id)
+        {
+            std::copy(std::begin(_dependents[id]), std::end(_dependents[id]), std::begin(targets) + offsets[id]);
+
+            _in_degrees[id] = static_cast<id_type>(std::size(_dependencies[id]));
+        }
+
+        _order.clear();
+        _order.reserve(count);
+
+        for (id_type id { 0 }; id < count; ++id) if (!_in_degrees[id]) _order.emplace_back(id);
+
+        for (std::size_t idx { 0 }; idx < std::size(_order); ++idx)
+        {
+            auto id { _order[idx] };
+
+            for (auto target { offsets[id] }; target < offsets[id + 1]; ++target)
+                if (!--_in_degrees[targets[target]]) _order.emplace_back(targets[target]);
+        }
+
+        _order_valid = std::size(_order) == count;
+        _holes = 0;
+
+        if (_order_valid)
+        {
+            _positions.resize(count);
+
+            for (id_type position { 0 }; position < count; ++position) _positions[_order[position]] = position;
+        }
+    }
+
+    // Pearce-Kelly: the new relation 'dependency -> object' violates the order, so only the nodes between the two
+    // positions, reachable forward from 'object' or backward from 'dependency', are shuffled
+    void reorder(id_type dependency, id_type object)
+    {
+        const auto lower_bound { _positions[object] }, upper_bound { _positions[dependency] };
+        std::vector<id_type> forward, backward, stack;
+
+        _visited.resize(std::size(_values), 0);
+
+        for (stack.emplace_back(object), _visited[object] = 1; !std::empty(stack);)
+        {
+            auto id { stack.back() };
+
+            stack.pop_back();
+            forward.emplace_back(id);
+
+            for (auto dependent : _dependents[id])
+            {
+                if (dependent == dependency)
+                {
+                    // a cycle is introduced: the order can't be maintained any longer
+                    for (auto visited : forward) _visited[visited] = 0;
+                    for (auto visited : stack) _visited[visited] = 0;
+
+                    _order_valid = false;
+
+                    return;
+                }
+
+                if (!_visited[dependent] && _positions[dependent] < upper_bound) _visited[dependent] = 1, stack.emplace_back(dependent);
+            }
+        }
+
+        for (stack.emplace_back(dependency), _visited[dependency] = 1; !std::empty(stack);)
+        {
+            auto id { stack.back() };
+
+            stack.pop_back();
+            backward.emplace_back(id);
+
+            for (auto dependency_id : _dependencies[id])
+                if (!_visited[dependency_id] && _positions[dependency_id] > lower_bound) _visited[dependency_id] = 1, stack.emplace_back(dependency_id);
+        }
+
+        auto by_position { [this](auto left, auto right){ return _positions[left] < _positions[right]; } };
+
+        std::sort(std::begin(forward), std::end(forward), by_position);
+        std::sort(std::begin(backward), std::end(backward), by_position);
+
+        std::vector<id_type> slots;
+
+        slots.reserve(std::size(forward) + std::size(backward));
+
+        for (auto id : backward) slots.emplace_back(_positions[id]), _visited[id] = 0;
+        for (auto id : forward) slots.emplace_back(_positions[id]), _visited[id] = 0;
+
+        std::sort(std::begin(slots), std::end(slots));
+
+        auto slot { std::begin(slots) };
+
+        for (auto id : backward) _positions[id] = *slot, _order[*slot++] = id;
+        for (auto id : forward) _positions[id] = *slot, _order[*slot++] = id;
+    }
+
+    void compact_order()
+    {
+        _order.erase(std::remove(std::begin(_order), std::end(_order), invalid_id), std::end(_order));
+
+        for (id_type position { 0 }; position < std::size(_order); ++position) _positions[_order[position]] = position;
+
+        _holes = 0;
+    }
+
+private:
+    std::unordered_map<value_type, id_type> _ids {};
+    std::vector<value_type> _values {};
+    std::vector<std::vector<id_type>> _dependents {};
+    std::vector<std::vector<id_type>> _dependencies {};
+
+    std::vector<id_type> _order {};
+    std::vector<id_type> _positions {};
+    std::vector<id_type> _in_degrees {};
+    std::vector<std::uint8_t> _visited {};
+    std::size_t _holes { 0 };
+    bool _order_valid { false };
+};
+
 }
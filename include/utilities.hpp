@@ -34,6 +34,7 @@ SOFTWARE.
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include "parallel_algorithms.hpp"
 
 namespace nstd::utilities
 {
@@ -148,52 +149,21 @@ auto read_file_content(const std::filesystem::path &filepath)
     return contents;
 };
 
+// a stable merge sort now; min_sortable_length is only the lower bound of the chunk size, which grows with the input
+// so that every thread of the pool gets a few chunks
 template<class Iterator, class Compare = std::less<>>
 void parallel_sort(Iterator begin, Iterator end, size_t min_sortable_length, const Compare &cp = Compare())
 {
-    auto size { std::distance(begin, end) };
+    auto &pool { nstd::global_thread_pool::get_thread_pool() };
+    auto size { static_cast<size_t>(std::distance(begin, end)) };
 
-    if (size <= min_sortable_length) std::sort(begin, end, cp);
-    else
-    {
-        Iterator mid { begin };
-
-        std::advance(mid, size / 2);
-
-        auto future { std::async(parallel_sort<Iterator, Compare>, begin, mid, min_sortable_length, cp) };
-
-        parallel_sort(mid, end, min_sortable_length, cp);
-
-        future.wait();
-
-        std::inplace_merge(begin, mid, end, cp);
-    }
+    nstd::parallel::sort(begin, end, cp, std::max(min_sortable_length, size / ((pool.size() + 1) * 4)), pool);
 }
 
 template<typename Iterator, typename Functor>
 static void parallel_for_each(Iterator begin, Iterator end, Functor func)
 {
-    const static unsigned nb_threads_hint { std::thread::hardware_concurrency() };
-    const static unsigned nb_threads { (nb_threads_hint == 0u ? 8u : nb_threads_hint) };
-
-    if (begin == end) return;
-
-    auto size { std::distance(begin, end) };
-    auto slice { static_cast<decltype(size)>(double(size) / nb_threads + .5) };
-
-    if (slice < 2) { std::for_each(begin, end, func); return; }
-
-    std::vector<std::thread> thread_pool; thread_pool.reserve(nb_threads);
-    auto it1 { begin }, it2 { begin };
-
-    while (it1 != end)
-    {
-        if (std::distance(it2, end) > slice) std::advance(it2, slice); else it2 = end;
-
-        thread_pool.emplace_back(std::for_each<Iterator, Functor>, it1, it2, func), it1 = it2;
-    }
-
-    for (std::thread &t : thread_pool) if (t.joinable()) t.join();
+    nstd::parallel::for_each(begin, end, func);
 }
 
 template<class Iterator>